@@ -125,15 +125,27 @@ endif()
 # TODO(Superjomn) not work fine with the option
 if (LITE_WITH_X86)
     add_definitions("-DLITE_WITH_X86")
+    # LTO of the light weight framework is set in cross_compiling/preproject,
+    # the static libs with LTO objects are archived by the compiler's ar.
+    if (LITE_WITH_LTO AND NOT LITE_WITH_LIGHT_WEIGHT_FRAMEWORK)
+        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -flto")
+        if (CMAKE_CXX_COMPILER_AR)
+            set(CMAKE_AR ${CMAKE_CXX_COMPILER_AR})
+        endif()
+    endif()
 endif()
 
 if (LITE_WITH_ARM)
     add_definitions("-DLITE_WITH_ARM")
 endif()
 
+if (LITE_WITH_HOST_MEMORY_POOL)
+    add_definitions("-DLITE_WITH_HOST_MEMORY_POOL")
+endif()
+
 if (LITE_WITH_CV)
-    if(NOT LITE_WITH_ARM)
-        message(FATAL_ERROR "CV functions uses the ARM instructions, so LITE_WITH_ARM must be turned on")
+    if(NOT LITE_WITH_ARM AND NOT LITE_WITH_X86)
+        message(FATAL_ERROR "CV functions are implemented for ARM and X86, so LITE_WITH_ARM or LITE_WITH_X86 must be turned on")
     endif()
     add_definitions("-DLITE_WITH_CV")
 endif()
@@ -43,11 +43,12 @@ function (lite_deps TARGET)
     foreach(var ${lite_deps_ARM_DEPS})
       set(deps ${deps} ${var})
     endforeach(var)
-    if(LITE_WITH_CV)
-      foreach(var ${lite_deps_CV_DEPS})
-        set(deps ${deps} ${var})
-      endforeach(var)
-    endif()
+  endif()
+
+  if(LITE_WITH_CV)
+    foreach(var ${lite_deps_CV_DEPS})
+      set(deps ${deps} ${var})
+    endforeach(var)
   endif()
 
   if(LITE_WITH_PROFILE)
@@ -360,6 +361,16 @@ file(WRITE ${fake_kernels_src_list} "") # clean
 if(LITE_BUILD_TAILOR)
   set(tailored_kernels_list_path "${LITE_OPTMODEL_DIR}/.tailored_kernels_source_list")
   file(STRINGS ${tailored_kernels_list_path} tailored_kernels_list)
+  # The specialized paths of the kernels used by the models, e.g. CONV_1X1,
+  # the other paths are compiled out, see lite/kernels/x86/conv_compute.h.
+  set(tailored_kernels_attrs_path "${LITE_OPTMODEL_DIR}/.tailored_kernels_attrs_list")
+  if(EXISTS ${tailored_kernels_attrs_path})
+    file(STRINGS ${tailored_kernels_attrs_path} tailored_kernels_attrs)
+    add_definitions(-DLITE_WITH_TAILORED_ATTRS)
+    foreach(attr ${tailored_kernels_attrs})
+      add_definitions(-DLITE_TAILORED_${attr})
+    endforeach()
+  endif()
 endif()
 # add a kernel for some specific device
 # device: one of (Host, ARM, X86, NPU, MLU, HUAWEI_ASCEND_NPU, APU, FPGA, OPENCL, CUDA, BM, RKNPU IMAGINATION_NNA)
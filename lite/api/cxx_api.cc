@@ -15,18 +15,166 @@
 #include "lite/api/cxx_api.h"
 
 #include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "lite/api/paddle_use_passes.h"
+#include "lite/core/mir/sparse_weight_convert_pass.h"
+#include "lite/core/version.h"
+#include "lite/operators/op_params.h"
 #include "lite/utils/io.h"
+#include "lite/utils/md5.h"
 
 namespace paddle {
 namespace lite {
 
+namespace {
+// Hash the bytes of the file by 64-bit FNV-1a, it's much cheaper than the
+// optimization of the model.
+bool HashFile(const std::string &path, uint64_t *hash) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) return false;
+  std::vector<unsigned char> chunk(1 << 20);
+  size_t size = 0;
+  while ((size = fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+    for (size_t i = 0; i < size; i++) {
+      *hash = (*hash ^ chunk[i]) * 0x100000001b3ULL;
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+// The build options which change the kernels picked or run by the optimized
+// model, besides the registered kernels.
+std::string BuildFlags() {
+  std::ostringstream os;
+#ifdef LITE_WITH_AVX
+  os << "avx;";
+#endif
+#ifdef PADDLE_WITH_MKLML
+  os << "mklml;";
+#endif
+#ifdef LITE_WITH_TAILORED_ATTRS
+  os << "tailored_attrs:";
+#ifdef LITE_TAILORED_CONV_DW3X3S1
+  os << "CONV_DW3X3S1,";
+#endif
+#ifdef LITE_TAILORED_CONV_DW3X3S2
+  os << "CONV_DW3X3S2,";
+#endif
+#ifdef LITE_TAILORED_CONV_DW
+  os << "CONV_DW,";
+#endif
+#ifdef LITE_TAILORED_CONV_1X1
+  os << "CONV_1X1,";
+#endif
+#ifdef LITE_TAILORED_CONV_IM2COL
+  os << "CONV_IM2COL,";
+#endif
+  os << ";";
+#endif
+  auto* sparse_pass =
+      mir::PassManager::Global().LookUp<mir::SparseWeightConvertPass>(
+          "sparse_weight_convert_pass");
+  if (sparse_pass) {
+    os << "sparse_threshold:" << sparse_pass->sparse_threshold() << ";";
+  }
+  return os.str();
+}
+
+// Generate the path of the cached optimized model, without the ".nb" suffix,
+// by using md5 hashes based on:
+// a) the library version, the build flags and the registered kernels;
+// b) the valid places, the passes and the quantization options;
+// c) the model type and the bytes of the model files.
+// An empty string is returned if the model files can not be read.
+std::string OptimizedModelCachePath(const lite_api::CxxConfig &config,
+                                    const std::vector<Place> &valid_places,
+                                    const std::vector<std::string> &passes,
+                                    lite_api::LiteModelType model_type) {
+  std::vector<std::string> files;
+  if (!config.model_file().empty() && !config.param_file().empty()) {
+    files = {config.model_file(), config.param_file()};
+  } else if (IsDir(config.model_dir())) {
+    for (auto &name : ListDir(config.model_dir())) {
+      files.push_back(config.model_dir() + "/" + name);
+    }
+    std::sort(files.begin(), files.end());
+  } else {
+    files = {config.model_dir()};
+  }
+  std::ostringstream os;
+  os << version() << ";" << BuildFlags()
+     << KernelRegistry::Global().KernelsSignature()
+     << static_cast<int>(model_type) << ";";
+  for (auto &place : valid_places) {
+    os << place.DebugString() << ";";
+  }
+  for (auto &pass : passes) {
+    os << pass << ";";
+  }
+  if (config.quant_model()) {
+    os << "quant_type:" << static_cast<int>(config.quant_type()) << ";";
+  }
+  for (auto &file : files) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    if (IsDir(file)) continue;
+    if (!HashFile(file, &hash)) {
+      LOG(WARNING) << "Failed to read " << file
+                   << ", the optimized model is not cached.";
+      return "";
+    }
+    os << file.substr(file.find_last_of("/\\") + 1) << ":" << hash << ";";
+  }
+  return config.optimized_model_cache_dir() + "/" + MD5(os.str());
+}
+
+// Record the path of the x86 conv kernel taken by the instruction, the
+// tailored library only keeps the paths used by the models, see
+// lite/kernels/x86/conv_compute.h. The paths are chosen as the AVX build does.
+void RecordX86ConvPath(const Instruction &inst, std::set<std::string> *paths) {
+  auto *kernel = inst.kernel();
+  if (kernel->target() != TARGET(kX86) ||
+      (kernel->op_type() != "conv2d" &&
+       kernel->op_type() != "depthwise_conv2d")) {
+    return;
+  }
+  auto &param = kernel->Param<operators::ConvParam>();
+  auto &filter_dims = param.filter->dims();
+  const int kh = filter_dims[2], kw = filter_dims[3];
+  const int sh = param.strides[0], sw = param.strides[1];
+  const int dh = (*param.dilations)[0], dw = (*param.dilations)[1];
+  // The weight quantized by post_quant_dynamic_pass is run by the gemm path.
+  bool weight_only = !param.weight_quant_scale.empty() &&
+                     param.filter->precision() != PRECISION(kFloat);
+  bool depthwise = filter_dims[1] == 1 && filter_dims[0] == param.groups &&
+                   (param.groups & 3) == 0;
+  if (!weight_only && depthwise && kh == 3 && kw == 3 &&
+      ((sh == 1 && sw == 1) || (sh == 2 && sw == 2))) {
+    if ((param.groups & 7) == 0 && dh == 1 && dw == 1) {
+      paths->insert(sh == 1 ? "CONV_DW3X3S1" : "CONV_DW3X3S2");
+    } else {
+      paths->insert("CONV_DW");
+    }
+    return;
+  }
+  auto &paddings = *param.paddings;
+  if (kh == 1 && kw == 1 && sh == 1 && sw == 1 && dh == 1 && dw == 1 &&
+      paddings[0] == 0 && paddings[1] == 0) {
+    paths->insert("CONV_1X1");
+  } else {
+    paths->insert("CONV_IM2COL");
+  }
+}
+}  // namespace
+
 std::vector<std::string> GetAllOps() {
   return OpLiteFactory::Global().GetAllOps();
 }
@@ -94,6 +242,7 @@ void Predictor::SaveModel(const std::string &dir,
 void Predictor::SaveOpKernelInfo(const std::string &model_dir) {
   std::set<std::string> ops_info;
   std::set<std::string> kernels_info;
+  std::set<std::string> kernels_attrs;
   auto block_size = program_->block_size();
   for (size_t block_idx = 0; block_idx < block_size; ++block_idx) {
     const auto &insts = program_->instructions(block_idx);
@@ -108,6 +257,7 @@ void Predictor::SaveOpKernelInfo(const std::string &model_dir) {
           DataLayoutRepr(inst.kernel()->layout()) + "," +
           inst.kernel()->alias();
       kernels_info.insert(kernel_type_str);
+      RecordX86ConvPath(inst, &kernels_attrs);
     }
   }
 
@@ -170,6 +320,18 @@ void Predictor::SaveOpKernelInfo(const std::string &model_dir) {
   std::fclose(kpf);
   OPT_LOG << "kernels information of tailored model is stored into: "
           << kpf_path;
+
+  // write the specialized paths of kernels into file
+  std::string kaf_path = model_dir + "/" + TAILORD_KERNELS_ATTRS_LIST_NAME;
+  std::FILE *kaf = std::fopen(kaf_path.c_str(), "w");
+  if (nullptr == kaf) {
+    LOG(FATAL) << "failed to create info file into: " << model_dir;
+  }
+  for (auto &kernel_attr : kernels_attrs) {
+    fputs(kernel_attr.c_str(), kaf);
+    fputc('\n', kaf);
+  }
+  std::fclose(kaf);
 }
 
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
@@ -296,6 +458,17 @@ void Predictor::Build(const lite_api::CxxConfig &config,
                       const std::vector<Place> &valid_places,
                       const std::vector<std::string> &passes,
                       lite_api::LiteModelType model_type) {
+  std::string cache_path;
+  if (!config.optimized_model_cache_dir().empty() &&
+      !config.is_model_from_memory()) {
+    cache_path =
+        OptimizedModelCachePath(config, valid_places, passes, model_type);
+    if (!cache_path.empty() && IsFileExists(cache_path + ".nb")) {
+      LOG(INFO) << "Load the optimized model from " << cache_path << ".nb";
+      BuildFromOptimizedModel(cache_path + ".nb", valid_places);
+      return;
+    }
+  }
   if (config.is_model_from_memory()) {
     LOG(INFO) << "Load model from memory.";
     Build(config.model_dir(),
@@ -314,7 +487,41 @@ void Predictor::Build(const lite_api::CxxConfig &config,
           passes,
           model_type);
   }
+  if (!cache_path.empty()) {
+    SaveOptimizedModelCache(cache_path);
+  }
 }
+
+void Predictor::BuildFromOptimizedModel(
+    const std::string &path, const std::vector<Place> &valid_places) {
+  LoadModelNaiveFromFile(path, scope_.get(), program_desc_.get());
+  // The kernels are picked already, so the runtime program is created directly
+  // as a cloned predictor does.
+  Program program(program_desc_, scope_, valid_places);
+  exec_scope_ = program.exec_scope();
+  valid_places_ = valid_places;
+  program_.reset(new RuntimeProgram(program_desc_, exec_scope_, kRootBlockIdx));
+  program_->set_inter_op_threads(inter_op_threads_);
+  program_generated_ = true;
+  PrepareFeedFetch();
+}
+
+void Predictor::SaveOptimizedModelCache(const std::string &cache_path) {
+  MkDirRecur(cache_path.substr(0, cache_path.find_last_of("/\\")));
+  // Save into a temporary file and rename it, so that the other processes
+  // never load a partially written model.
+  const std::string tmp_path =
+      cache_path + "." +
+      std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  SaveModel(tmp_path, lite_api::LiteModelType::kNaiveBuffer);
+  if (std::rename((tmp_path + ".nb").c_str(), (cache_path + ".nb").c_str())) {
+    LOG(WARNING) << "Failed to cache the optimized model into " << cache_path
+                 << ".nb";
+    std::remove((tmp_path + ".nb").c_str());
+  }
+}
+
 void Predictor::Build(const std::string &model_path,
                       const std::string &model_file,
                       const std::string &param_file,
@@ -360,7 +567,12 @@ void Predictor::Build(const std::shared_ptr<cpp::ProgramDesc> &program_desc,
         Place(TARGET(kHost), valid_place.precision, valid_place.layout));
   }
 
-  if (IsQuantizedMode(program_desc_)) {
+  // The ops quantized by post_quant_static_pass run the int8 kernels as the
+  // quantized models.
+  bool post_quant_static =
+      std::find(passes.begin(), passes.end(), "post_quant_static_pass") !=
+      passes.end();
+  if (IsQuantizedMode(program_desc_) || post_quant_static) {
     inner_places.insert(inner_places.begin(),
                         Place{TARGET(kARM), PRECISION(kInt8)});
   }
@@ -384,6 +596,7 @@ void Predictor::Build(const std::shared_ptr<cpp::ProgramDesc> &program_desc,
 void Predictor::GenRuntimeProgram() {
   program_ = optimizer_.GenRuntimeProgram();
   CHECK_EQ(exec_scope_, program_->exec_scope());
+  program_->set_inter_op_threads(inter_op_threads_);
   program_generated_ = true;
 }
 
@@ -477,6 +690,274 @@ void Predictor::CheckPaddleOpVersions(
 // }
 // #endif
 
+namespace {
+const size_t kBindMemoryAlignment = 64;
+
+bool IsHostTarget(TargetType target) {
+  return target == TARGET(kHost) || target == TARGET(kX86) ||
+         target == TARGET(kARM);
+}
+}  // namespace
+
+void Predictor::BindInput(size_t offset,
+                          void *data,
+                          size_t memory_size,
+                          TargetType target) {
+  CHECK(data) << "The bound memory of input " << offset << " is null.";
+  CHECK(IsHostTarget(target)) << "Only the host memory can be bound.";
+  auto buffer = std::make_shared<Buffer>(data, target, memory_size);
+  GetInput(offset)->ShareExternalBuffer(buffer);
+  bound_inputs_[offset] = buffer;
+}
+
+void Predictor::BindOutput(size_t offset,
+                           void *data,
+                           size_t memory_size,
+                           TargetType target) {
+  CHECK(output_names_.size() > offset)
+      << "The network has " << output_names_.size() << " outputs"
+      << ", the offset should be less than this.";
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  if (!data) {
+    program_->BindOutput(output_names_[offset], nullptr);
+    bound_outputs_.erase(offset);
+    return;
+  }
+  CHECK(IsHostTarget(target)) << "Only the host memory can be bound.";
+  auto buffer = std::make_shared<Buffer>(data, target, memory_size);
+  bound_outputs_[offset] = buffer;
+  // The misaligned memory is only filled by copying, since some kernels
+  // assume their outputs are aligned as the internal allocations.
+  if (reinterpret_cast<uintptr_t>(data) % kBindMemoryAlignment != 0 ||
+      !program_->BindOutput(output_names_[offset], buffer)) {
+    program_->BindOutput(output_names_[offset], nullptr);
+    LOG(WARNING) << "The output " << offset << " (" << output_names_[offset]
+                 << ") can not be written in place, it will be copied into "
+                    "the bound memory after running.";
+  }
+}
+
+void Predictor::SyncBoundOutputs() {
+  for (auto &output : bound_outputs_) {
+    auto *tensor = GetMutableTensor(output_names_[output.first]);
+    auto &buffer = output.second;
+    if (tensor->raw_data() == buffer->data()) continue;
+    size_t size = tensor->numel() * PrecisionTypeLength(tensor->precision());
+    CHECK_LE(size, buffer->space())
+        << "The bound memory of output " << output.first << " is too small, "
+        << size << " bytes are required.";
+    TargetWrapperHost::MemcpySync(
+        buffer->data(), tensor->raw_data(), size, IoDirection::HtoH);
+  }
+}
+
+namespace {
+// Only the dense inputs on host are padded, padding the sequences of a LoD
+// tensor would break its LoD.
+bool IsShapeBucketable(const lite::Tensor &tensor, int axis) {
+  return tensor.IsInitialized() && tensor.lod().empty() &&
+         static_cast<int>(tensor.dims().size()) > axis &&
+         IsHostTarget(tensor.target());
+}
+
+// Pad the `axis` dimension of `tensor` up to `bucket` with zeros in place,
+// `staging` is used to hold a copy of the origin data.
+void PadTensorToBucket(lite::Tensor *tensor,
+                       int axis,
+                       int64_t bucket,
+                       std::vector<char> *staging) {
+  auto dims = tensor->dims();
+  if (dims[axis] >= bucket) return;
+  const size_t elem_size = PrecisionTypeLength(tensor->precision());
+  const int64_t outer = dims.count(0, axis);
+  const int64_t inner = dims.count(axis + 1, dims.size());
+  const size_t src_row = dims[axis] * inner * elem_size;
+  const size_t dst_row = bucket * inner * elem_size;
+  if (staging->size() < outer * src_row) {
+    staging->resize(outer * src_row);
+  }
+  memcpy(staging->data(), tensor->raw_data(), outer * src_row);
+  dims[axis] = bucket;
+  tensor->Resize(dims);
+  auto *dst = static_cast<char *>(
+      tensor->mutable_data(tensor->target(), outer * dst_row));
+  for (int64_t i = 0; i < outer; i++) {
+    memcpy(dst + i * dst_row, staging->data() + i * src_row, src_row);
+    memset(dst + i * dst_row + src_row, 0, dst_row - src_row);
+  }
+}
+}  // namespace
+
+void Predictor::SetShapeBuckets(const std::vector<int64_t> &buckets,
+                                int axis) {
+  CHECK_GE(axis, 0) << "The axis of shape buckets should be non-negative.";
+  shape_buckets_ = buckets;
+  std::sort(shape_buckets_.begin(), shape_buckets_.end());
+  shape_buckets_.erase(
+      std::unique(shape_buckets_.begin(), shape_buckets_.end()),
+      shape_buckets_.end());
+  CHECK(shape_buckets_.empty() || shape_buckets_.front() > 0)
+      << "The shape buckets should be positive.";
+  shape_bucket_axis_ = axis;
+  shape_bucket_plans_prepared_ = false;
+}
+
+void Predictor::SetInterOpThreads(int threads) {
+  CHECK_GE(threads, 1) << "The number of inter-op threads should be positive.";
+  inter_op_threads_ = threads;
+  if (program_) {
+    program_->set_inter_op_threads(threads);
+  }
+}
+
+std::unique_ptr<PipelineExecutor> Predictor::CreatePipeline(
+    int num_stages, int threads_per_stage) {
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  // Warm up before profiling, the first run allocates the memory.
+  program_->Run();
+  auto costs = PipelineExecutor::ProfileCosts(program_.get());
+  program_->SaveToProgram(program_desc_);
+  return std::unique_ptr<PipelineExecutor>(
+      new PipelineExecutor(program_desc_,
+                           exec_scope_,
+                           input_names_,
+                           output_names_,
+                           costs,
+                           num_stages,
+                           threads_per_stage));
+}
+
+std::map<std::string, float> Predictor::Calibrate(
+    const std::vector<std::vector<lite::Tensor>> &samples,
+    const std::string &method) {
+  for (auto &pass : Calibrator::VarRenamingPasses()) {
+    CHECK(optimizer_.IsPassDisabled(pass))
+        << "The predictor to calibrate should be built with " << pass
+        << " disabled, the activations may be renamed by it.";
+  }
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  Calibrator calibrator(method);
+  for (int pass = 0; pass < Calibrator::kNumPasses; pass++) {
+    for (auto &sample : samples) {
+      CHECK_EQ(sample.size(), input_names_.size())
+          << "The calibration sample should have all of the inputs.";
+      for (size_t i = 0; i < sample.size(); i++) {
+        GetInput(i)->CopyDataFrom(sample[i]);
+      }
+      calibrator.Observe(program_.get(), exec_scope_, pass);
+    }
+  }
+  return calibrator.Thresholds();
+}
+
+void Predictor::PadInputsToShapeBucket() {
+  if (!shape_bucket_plans_prepared_) {
+    PrepareShapeBucketPlans();
+  }
+  // The plans are keyed by the input shapes, so the inputs with LoD or longer
+  // than the biggest bucket run without plan.
+  std::vector<int64_t> input_buckets(input_names_.size(), -1);
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    auto *input = GetInput(i);
+    if (!input->lod().empty()) {
+      program_->UsePlan("");
+      return;
+    }
+    if (!IsShapeBucketable(*input, shape_bucket_axis_)) continue;
+    auto it = std::lower_bound(shape_buckets_.begin(),
+                               shape_buckets_.end(),
+                               input->dims()[shape_bucket_axis_]);
+    if (it == shape_buckets_.end()) {
+      program_->UsePlan("");
+      return;
+    }
+    // The bound input is padded in place, so the caller-owned memory should
+    // hold the padded shape.
+    auto bound = bound_inputs_.find(i);
+    if (bound != bound_inputs_.end()) {
+      auto dims = input->dims();
+      dims[shape_bucket_axis_] = *it;
+      if (dims.production() * PrecisionTypeLength(input->precision()) >
+          bound->second->space()) {
+        VLOG(3) << "The bound memory of input " << i
+                << " can't hold the shape bucket " << *it;
+        program_->UsePlan("");
+        return;
+      }
+    }
+    input_buckets[i] = *it;
+  }
+  std::string key;
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    auto *input = GetInput(i);
+    if (input_buckets[i] > 0) {
+      PadTensorToBucket(
+          input, shape_bucket_axis_, input_buckets[i], &shape_bucket_staging_);
+    }
+    key += input->dims().repr();
+  }
+  program_->UsePlan(key);
+}
+
+void Predictor::PrepareShapeBucketPlans() {
+  shape_bucket_plans_prepared_ = true;
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    if (!GetInput(i)->lod().empty()) return;
+  }
+  // Stash the inputs since they are overwritten by the warm-up runs. The
+  // bound inputs run with a temporary buffer instead, the caller-owned memory
+  // can't be reallocated for the bigger buckets.
+  std::vector<lite::Tensor> inputs(input_names_.size());
+  std::vector<bool> unbound(input_names_.size(), false);
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    auto *input = GetInput(i);
+    if (bound_inputs_.count(i) &&
+        IsShapeBucketable(*input, shape_bucket_axis_)) {
+      unbound[i] = true;
+      inputs[i].ShareDataWith(*input);
+      input->ShareExternalBuffer(std::make_shared<Buffer>());
+    } else {
+      inputs[i].CopyDataFrom(*input);
+    }
+  }
+  for (auto bucket = shape_buckets_.rbegin(); bucket != shape_buckets_.rend();
+       ++bucket) {
+    std::string key;
+    for (size_t i = 0; i < input_names_.size(); i++) {
+      auto *input = GetInput(i);
+      if (IsShapeBucketable(inputs[i], shape_bucket_axis_)) {
+        auto dims = inputs[i].dims();
+        dims[shape_bucket_axis_] = *bucket;
+        input->Resize(dims);
+        const size_t size =
+            dims.production() * PrecisionTypeLength(inputs[i].precision());
+        memset(input->mutable_data(input->target(), size), 0, size);
+      }
+      key += input->dims().repr();
+    }
+    if (program_->HasPlan(key)) continue;
+    VLOG(3) << "Prepare the execution plan of shape bucket " << *bucket;
+    program_->UsePlan(key);
+    program_->Run();
+  }
+  program_->UsePlan("");
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    auto *input = GetInput(i);
+    if (unbound[i]) {
+      input->ShareExternalBuffer(bound_inputs_[i]);
+      input->Resize(inputs[i].dims());
+    } else {
+      input->CopyDataFrom(inputs[i]);
+    }
+  }
+}
+
 void Predictor::CheckInputValid() {
   for (size_t idx = 0; idx < input_precisions_.size(); ++idx) {
     if (GetInput(idx)->precision() != input_precisions_[idx]) {
@@ -20,8 +20,10 @@
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_api.h"
+#include "lite/core/calibrator.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer.h"
+#include "lite/core/pipeline_executor.h"
 #include "lite/core/program.h"
 #include "lite/core/types.h"
 #include "lite/model_parser/model_parser.h"
@@ -35,6 +37,8 @@ static const char TAILORD_OPS_LIST_NAME[] = ".tailored_ops_list";
 static const char TAILORD_KERNELS_SOURCE_LIST_FILENAME[] =
     ".tailored_kernels_source_list";
 static const char TAILORD_KERNELS_LIST_NAME[] = ".tailored_kernels_list";
+static const char TAILORD_KERNELS_ATTRS_LIST_NAME[] =
+    ".tailored_kernels_attrs_list";
 
 std::vector<std::string> GetAllOps();
 
@@ -162,12 +166,26 @@ class LITE_API Predictor {
       GenRuntimeProgram();
     }
     CheckInputValid();
+    for (auto& input : bound_inputs_) {
+      auto* tensor = GetInput(input.first);
+      CHECK_EQ(tensor->raw_data(), input.second->data())
+          << "The bound memory of input " << input.first << " is replaced.";
+      CHECK_LE(tensor->numel() * PrecisionTypeLength(tensor->precision()),
+               input.second->space())
+          << "The bound memory of input " << input.first << " is too small.";
+    }
+    if (!shape_buckets_.empty()) {
+      PadInputsToShapeBucket();
+    }
 
 #ifdef LITE_WITH_XPU
     lite::TargetWrapperXPU::MallocL3Cache();
 #endif
 
     program_->Run();
+    if (!bound_outputs_.empty()) {
+      SyncBoundOutputs();
+    }
 
 #ifdef LITE_WITH_XPU
     lite::TargetWrapperXPU::FreeL3Cache();
@@ -188,6 +206,42 @@ class LITE_API Predictor {
 
   void PrepareFeedFetch();
 
+  // Bind the caller-owned memory to the offset-th input or output, see
+  // `lite_api::PaddlePredictor::BindOutput`.
+  void BindInput(size_t offset,
+                 void* data,
+                 size_t memory_size,
+                 TargetType target);
+  void BindOutput(size_t offset,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target);
+
+  // Set the shape buckets, see `CxxConfig::set_shape_buckets`.
+  void SetShapeBuckets(const std::vector<int64_t>& buckets, int axis);
+
+  // Set the inter-op threads, see `ConfigBase::set_inter_op_threads`.
+  void SetInterOpThreads(int threads);
+
+  // Create a pipeline of the model with `num_stages` stages balanced by the
+  // costs profiled with the current inputs, so the inputs should be set
+  // before. The predictor should not run while the pipeline is running.
+  std::unique_ptr<PipelineExecutor> CreatePipeline(int num_stages,
+                                                   int threads_per_stage = 1);
+
+  // Skip the given optimization passes, it should be called before Build.
+  void DisablePasses(const std::vector<std::string>& passes) {
+    optimizer_.DisablePasses(passes);
+  }
+
+  // Run the calibration samples, each of which holds all of the inputs in the
+  // order of feed, with the fp32 kernels, and return the thresholds of the
+  // activations computed by `method`, see `Calibrator`. The predictor should
+  // be built with `Calibrator::VarRenamingPasses()` disabled.
+  std::map<std::string, float> Calibrate(
+      const std::vector<std::vector<lite::Tensor>>& samples,
+      const std::string& method = "KL");
+
   // Get offset-th col of fetch results.
   const lite::Tensor* GetOutput(size_t offset) const;
   std::vector<const lite::Tensor*> GetOutputs() const;
@@ -227,6 +281,20 @@ class LITE_API Predictor {
   // check if the input tensor precision type is correct.
   // would be called in Run().
   void CheckInputValid();
+  // Copy the outputs which are not written in place into the bound memory,
+  // would be called in Run().
+  void SyncBoundOutputs();
+  // Pad the inputs up to the nearest shape bucket and select the execution
+  // plan of it, would be called in Run().
+  void PadInputsToShapeBucket();
+  // Run every shape bucket once to record its execution plan, the biggest
+  // bucket goes first so that all of the buffers are allocated only once.
+  void PrepareShapeBucketPlans();
+  // Create the runtime program from the optimized model cached by
+  // `SaveOptimizedModelCache`, see `CxxConfig::set_optimized_model_cache_dir`.
+  void BuildFromOptimizedModel(const std::string& path,
+                               const std::vector<Place>& valid_places);
+  void SaveOptimizedModelCache(const std::string& cache_path);
 
  private:
   Optimizer optimizer_;
@@ -239,6 +307,14 @@ class LITE_API Predictor {
   std::vector<std::string> output_names_;
   std::vector<Place> valid_places_;
   std::vector<PrecisionType> input_precisions_;
+  std::map<size_t, std::shared_ptr<Buffer>> bound_inputs_;
+  std::map<size_t, std::shared_ptr<Buffer>> bound_outputs_;
+  std::vector<int64_t> shape_buckets_;
+  int shape_bucket_axis_{1};
+  bool shape_bucket_plans_prepared_{false};
+  int inter_op_threads_{1};
+  // Reused for the in-place padding to avoid allocations at every run.
+  std::vector<char> shape_bucket_staging_;
 };
 
 class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
@@ -263,6 +339,16 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
 
   std::shared_ptr<lite_api::PaddlePredictor> Clone() override;
 
+  void BindInput(int i,
+                 void* data,
+                 size_t memory_size,
+                 TargetType target = TargetType::kHost) override;
+
+  void BindOutput(int i,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target = TargetType::kHost) override;
+
   std::shared_ptr<lite_api::PaddlePredictor> Clone(
       const std::vector<std::string>& var_names) override;
 
@@ -95,6 +95,11 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
   }
   mode_ = config.power_mode();
   threads_ = config.threads();
+  if (!config.shape_buckets().empty()) {
+    raw_predictor_->SetShapeBuckets(config.shape_buckets(),
+                                    config.shape_bucket_axis());
+  }
+  raw_predictor_->SetInterOpThreads(config.inter_op_threads());
 #ifdef LITE_WITH_NPU
   // Store the model-level configuration into scope for kernels, and use
   // exe_scope to store the execution-level configuration
@@ -219,6 +224,20 @@ void CxxPaddleApiImpl::Run() {
   raw_predictor_->Run();
 }
 
+void CxxPaddleApiImpl::BindInput(int i,
+                                 void *data,
+                                 size_t memory_size,
+                                 TargetType target) {
+  raw_predictor_->BindInput(i, data, memory_size, target);
+}
+
+void CxxPaddleApiImpl::BindOutput(int i,
+                                  void *data,
+                                  size_t memory_size,
+                                  TargetType target) {
+  raw_predictor_->BindOutput(i, data, memory_size, target);
+}
+
 std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone() {
   std::lock_guard<std::mutex> lock(mutex_);
   auto predictor =
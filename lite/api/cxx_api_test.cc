@@ -15,6 +15,11 @@
 #include "lite/api/cxx_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <set>
+#include <string>
 #include <vector>
 #include "lite/api/lite_api_test_helper.h"
 #include "lite/api/paddle_use_kernels.h"
@@ -22,6 +27,8 @@
 #include "lite/api/paddle_use_passes.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/tensor.h"
+#include "lite/model_parser/model_parser.h"
+#include "lite/utils/io.h"
 
 // For training.
 DEFINE_string(startup_program_path, "", "");
@@ -100,6 +107,197 @@ TEST(CXXApi, clone_predictor) {
   }
 }
 
+TEST(CXXApi, optimized_model_cache) {
+  // A fresh cache directory, so that the first build always misses.
+  const std::string cache_dir =
+      FLAGS_optimized_model + ".cache." +
+      std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  ASSERT_FALSE(IsFileExists(cache_dir));
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_optimized_model_cache_dir(cache_dir);
+  std::vector<Place> valid_places({Place{TARGET(kX86), PRECISION(kFloat)}});
+  auto run = [&](lite::Predictor* predictor) {
+    predictor->Build(config, valid_places);
+    auto* input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({1, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100; i++) {
+      data[i] = 1;
+    }
+    predictor->Run();
+    return predictor->GetOutput(0);
+  };
+  // The cached model is written into a new file and renamed at every miss.
+  auto cached_file_id = [&]() -> ino_t {
+    auto files = ListDir(cache_dir);
+    EXPECT_EQ(files.size(), 1UL);
+    struct stat info;
+    if (files.size() != 1 ||
+        stat((cache_dir + "/" + files[0]).c_str(), &info) != 0) {
+      return static_cast<ino_t>(0);
+    }
+    return info.st_ino;
+  };
+  // The first predictor optimizes the model and caches it, the second one
+  // loads the cached model.
+  lite::Predictor predictor;
+  auto* output_tensor = run(&predictor);
+  ino_t missed_file = cached_file_id();
+  ASSERT_NE(missed_file, static_cast<ino_t>(0));
+  lite::Predictor cached_predictor;
+  auto* cached_output_tensor = run(&cached_predictor);
+  EXPECT_EQ(cached_file_id(), missed_file);
+  ASSERT_EQ(output_tensor->dims(), cached_output_tensor->dims());
+  for (int i = 0; i < output_tensor->data_size(); i++) {
+    EXPECT_NEAR(output_tensor->data<float>()[i],
+                cached_output_tensor->data<float>()[i],
+                1e-6);
+  }
+}
+
+TEST(CXXApi, bind_output_of_x86_kernel) {
+  // feed -> pool2d -> fetch, the x86 pool2d claims its output as kX86.
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block = program_desc->AddBlock<cpp::BlockDesc>();
+  block->SetIdx(0);
+  block->SetParentIdx(-1);
+  for (auto& name : {"x", "out"}) {
+    auto* var = block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var->SetDataType(VarDescAPI::Type::FP32);
+  }
+  auto* feed = block->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+  auto* pool = block->AddOp<cpp::OpDesc>();
+  pool->SetType("pool2d");
+  pool->SetInput("X", {"x"});
+  pool->SetOutput("Out", {"out"});
+  pool->SetAttr<std::string>("pooling_type", "max");
+  pool->SetAttr<std::vector<int>>("ksize", {2, 2});
+  pool->SetAttr<bool>("global_pooling", false);
+  pool->SetAttr<std::vector<int>>("strides", {2, 2});
+  pool->SetAttr<std::vector<int>>("paddings", {0, 0});
+  auto* fetch = block->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int>("col", 0);
+
+  lite::Predictor predictor;
+  std::vector<Place> valid_places({Place{TARGET(kX86), PRECISION(kFloat)}});
+  predictor.Build(program_desc, valid_places);
+  // The internal allocations are aligned as the bound memory should be.
+  lite::Tensor bound;
+  bound.Resize({2 * 2 * 2});
+  auto* bound_data = bound.mutable_data<float>();
+  predictor.BindOutput(0, bound_data, 8 * sizeof(float), TARGET(kHost));
+
+  auto* input = predictor.GetInput(0);
+  input->Resize({1, 2, 4, 4});
+  auto* input_data = input->mutable_data<float>();
+  for (int i = 0; i < 32; i++) {
+    input_data[i] = static_cast<float>((i * 5) % 32);
+  }
+  for (int repeat = 0; repeat < 2; repeat++) {
+    predictor.Run();
+    for (int c = 0; c < 2; c++) {
+      for (int h = 0; h < 2; h++) {
+        for (int w = 0; w < 2; w++) {
+          const float* window = input_data + c * 16 + h * 8 + w * 2;
+          float expected =
+              std::max(std::max(window[0], window[1]),
+                       std::max(window[4], window[5]));
+          EXPECT_EQ(bound_data[c * 4 + h * 2 + w], expected);
+        }
+      }
+    }
+  }
+}
+
+TEST(CXXApi, pipeline) {
+  lite::Predictor predictor;
+  std::vector<Place> valid_places({Place{TARGET(kX86), PRECISION(kFloat)}});
+  predictor.Build(FLAGS_model_dir, "", "", valid_places);
+  const int num_requests = 8;
+  std::vector<lite::Tensor> requests(num_requests);
+  std::vector<lite::Tensor> expected(num_requests);
+  for (int r = 0; r < num_requests; r++) {
+    requests[r].Resize(std::vector<int64_t>({1 + r % 3, 100}));
+    auto* data = requests[r].mutable_data<float>();
+    for (int i = 0; i < requests[r].numel(); i++) {
+      data[i] = static_cast<float>((i + r) % 17) / 17.f;
+    }
+    predictor.GetInput(0)->CopyDataFrom(requests[r]);
+    predictor.Run();
+    expected[r].CopyDataFrom(*predictor.GetOutput(0));
+  }
+
+  // The inputs of the last request are used to profile the costs.
+  auto pipeline = predictor.CreatePipeline(2);
+  ASSERT_GE(pipeline->num_stages(), 1);
+  std::vector<std::vector<const lite::Tensor*>> inputs;
+  for (auto& request : requests) {
+    inputs.push_back({&request});
+  }
+  std::vector<std::vector<lite::Tensor>> outputs;
+  // Run twice to reuse the slots of the boundary tensors.
+  for (int repeat = 0; repeat < 2; repeat++) {
+    pipeline->Run(inputs, &outputs);
+    ASSERT_EQ(outputs.size(), static_cast<size_t>(num_requests));
+    for (int r = 0; r < num_requests; r++) {
+      ASSERT_EQ(outputs[r].size(), 1UL);
+      ASSERT_EQ(outputs[r][0].dims(), expected[r].dims());
+      for (int i = 0; i < expected[r].numel(); i++) {
+        EXPECT_NEAR(outputs[r][0].data<float>()[i],
+                    expected[r].data<float>()[i],
+                    1e-5);
+      }
+    }
+  }
+}
+
+TEST(CXXApi, calibrate) {
+  lite::Predictor predictor;
+  std::vector<Place> valid_places({Place{TARGET(kX86), PRECISION(kFloat)},
+                                   Place{TARGET(kHost), PRECISION(kFloat)}});
+  predictor.DisablePasses(Calibrator::VarRenamingPasses());
+  predictor.Build(FLAGS_model_dir, "", "", valid_places);
+  std::vector<std::vector<lite::Tensor>> samples(4);
+  for (size_t s = 0; s < samples.size(); s++) {
+    samples[s].resize(1);
+    samples[s][0].Resize(std::vector<int64_t>({1, 100}));
+    auto* data = samples[s][0].mutable_data<float>();
+    for (int i = 0; i < 100; i++) {
+      data[i] = static_cast<float>((i * 7 + s) % 13) - 6.f;
+    }
+  }
+  auto thresholds = predictor.Calibrate(samples, "abs_max");
+  ASSERT_FALSE(thresholds.empty());
+
+  // The thresholds are keyed by the variable names of the model.
+  auto scope = std::make_shared<Scope>();
+  cpp::ProgramDesc program_desc;
+  LoadModelPb(FLAGS_model_dir, "", "", scope.get(), &program_desc);
+  std::set<std::string> var_names;
+  for (size_t i = 0; i < program_desc.BlocksSize(); i++) {
+    auto* block = program_desc.GetBlock<cpp::BlockDesc>(i);
+    for (size_t j = 0; j < block->VarsSize(); j++) {
+      var_names.insert(block->GetVar<cpp::VarDesc>(j)->Name());
+    }
+  }
+  for (auto& threshold : thresholds) {
+    EXPECT_TRUE(var_names.count(threshold.first)) << threshold.first;
+    EXPECT_GE(threshold.second, 0.f) << threshold.first;
+  }
+  EXPECT_TRUE(thresholds.count(predictor.GetOutputNames()[0]));
+}
+
 /*TEST(CXXTrainer, train) {
   Place place({TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW)});
   std::vector<Place> valid_places({place});
@@ -15,6 +15,9 @@
 #include "lite/api/light_api.h"
 #include <algorithm>
 #include <map>
+#include <set>
+#include "lite/utils/bfloat16.h"
+#include "lite/utils/float16.h"
 #ifdef ENABLE_ARM_FP16
 #include "lite/backends/arm/math/fp16/funcs_fp16.h"
 #endif
@@ -23,12 +26,20 @@ namespace paddle {
 namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
-                           bool model_from_memory) {
+                           bool model_from_memory,
+                           int param_load_threads,
+                           bool lazy_param_loading) {
   if (model_from_memory) {
-    LoadModelNaiveFromMemory(
-        lite_model_file, scope_.get(), program_desc_.get());
+    LoadModelNaiveFromMemory(lite_model_file,
+                             scope_.get(),
+                             program_desc_.get(),
+                             param_load_threads);
   } else {
-    LoadModelNaiveFromFile(lite_model_file, scope_.get(), program_desc_.get());
+    LoadModelNaiveFromFile(lite_model_file,
+                           scope_.get(),
+                           program_desc_.get(),
+                           param_load_threads,
+                           lazy_param_loading);
   }
 
   // For weight quantization of post training, load the int8/16 weights
@@ -216,14 +227,16 @@ void LightPredictor::DequantizeWeight() {
 #define PROCESS_CONV2D_DATA()                                             \
   for (int64_t i = 0; i < ch; ++i) {                                      \
     for (int64_t j = 0; j < offset; ++j) {                                \
-      fp_data[i * offset + j] = scale_list[i] * int_data[i * offset + j]; \
+      fp_data[i * offset + j] =                                           \
+          scale_list[i] * static_cast<float>(int_data[i * offset + j]);   \
     }                                                                     \
   }
 
 #define PROCESS_FC_DATA()                                               \
   for (int64_t i = 0; i < chin; i++) {                                  \
     for (int64_t j = 0; j < chout; j++) {                               \
-      fp_data[i * chout + j] = scale_list[j] * int_data[i * chout + j]; \
+      fp_data[i * chout + j] =                                          \
+          scale_list[j] * static_cast<float>(int_data[i * chout + j]);  \
     }                                                                   \
   }
 
@@ -232,22 +245,45 @@ void LightPredictor::DequantizeWeight() {
     if (op_desc->HasAttr("quantization_type")) {
       std::string type = op_desc->GetAttr<std::string>("quantization_type");
       result = (type == "post_weight_abs_max") ||
-               (type == "post_weight_channel_wise_abs_max");
+               (type == "post_weight_channel_wise_abs_max") ||
+               (type == "post_weight_fp16") || (type == "post_weight_bf16");
     } else {
       result = op_desc->HasAttr("quantize_weight_bits");
     }
     return result;
   };
+  // The x86 kernels of these ops run on the int8/int16 weights directly, so
+  // the weights are kept quantized in memory.
+  auto is_weight_only_kernel = [](const cpp::OpDesc* op_desc) {
+#ifdef LITE_WITH_X86
+    static const std::set<std::string> weight_only_ops{
+        "conv2d", "depthwise_conv2d", "fc", "mul", "lookup_table"};
+    if (!weight_only_ops.count(op_desc->Type()) ||
+        !op_desc->HasAttr(kKernelTypeAttr)) {
+      return false;
+    }
+    std::string op_type, alias;
+    Place place;
+    KernelBase::ParseKernelType(op_desc->GetAttr<std::string>(kKernelTypeAttr),
+                                &op_type,
+                                &alias,
+                                &place);
+    return place.target == TARGET(kX86);
+#else
+    return false;
+#endif
+  };
   Tensor tmp_tensor;
   for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
     auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
     for (size_t k = 0; k < block->OpsSize(); ++k) {
       auto* op_desc = block->GetOp<cpp::OpDesc>(k);
-      if (is_weight_quantized_op(op_desc)) {
+      if (is_weight_quantized_op(op_desc) && !is_weight_only_kernel(op_desc)) {
         auto input_names = op_desc->input_vars();
         for (auto& input_name : input_names) {
           std::string input_scale_name = input_name + "_quant_scale";
           if (op_desc->HasAttr(input_scale_name)) {  // the input is quantized
+            scope_->MaterializeParam(input_name);
             auto input_tensor =
                 scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
             tmp_tensor.CopyDataFrom(*input_tensor);
@@ -257,6 +293,10 @@ void LightPredictor::DequantizeWeight() {
             int quantize_weight_bits =
                 op_desc->GetAttr<int>("quantize_weight_bits");
             CHECK(quantize_weight_bits == 8 || quantize_weight_bits == 16);
+            std::string quant_type =
+                op_desc->HasAttr("quantization_type")
+                    ? op_desc->GetAttr<std::string>("quantization_type")
+                    : "";
             float* fp_data = input_tensor->mutable_data<float>();
 
             std::string op_type = op_desc->Type();
@@ -264,7 +304,13 @@ void LightPredictor::DequantizeWeight() {
               int64_t ch = input_tensor->dims()[0];
               int64_t offset = input_tensor->numel() / ch;
               CHECK_EQ(scale_list.size(), ch);
-              if (quantize_weight_bits == 8) {
+              if (quant_type == "post_weight_fp16") {
+                const float16* int_data = tmp_tensor.data<float16>();
+                PROCESS_CONV2D_DATA()
+              } else if (quant_type == "post_weight_bf16") {
+                const bfloat16* int_data = tmp_tensor.data<bfloat16>();
+                PROCESS_CONV2D_DATA()
+              } else if (quantize_weight_bits == 8) {
                 const int8_t* int_data = tmp_tensor.data<int8_t>();
                 PROCESS_CONV2D_DATA()
               } else {
@@ -276,7 +322,13 @@ void LightPredictor::DequantizeWeight() {
               int64_t chin = input_tensor->dims()[0];
               int64_t chout = input_tensor->dims()[1];
               CHECK_EQ(scale_list.size(), chout);
-              if (quantize_weight_bits == 8) {
+              if (quant_type == "post_weight_fp16") {
+                const float16* int_data = tmp_tensor.data<float16>();
+                PROCESS_FC_DATA()
+              } else if (quant_type == "post_weight_bf16") {
+                const bfloat16* int_data = tmp_tensor.data<bfloat16>();
+                PROCESS_FC_DATA()
+              } else if (quantize_weight_bits == 8) {
                 const int8_t* int_data = tmp_tensor.data<int8_t>();
                 PROCESS_FC_DATA()
               } else {
@@ -310,6 +362,7 @@ void LightPredictor::WeightFP32ToFP16() {
         for (auto& input_name : input_names) {
           std::string input_weight_name = input_name + "_fp16";
           if (op_desc->HasAttr(input_weight_name)) {  // the input is fp16
+            scope_->MaterializeParam(input_name);
             Tensor tmp_tensor;
             auto input_tensor =
                 scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
@@ -43,11 +43,18 @@ class LITE_API LightPredictor {
   // constructor function of LightPredictor, `lite_model_file` refers to data in
   // model file or buffer,`model_from_memory` refers to whther to load model
   // from memory.
+  // See `MobileConfig::set_param_load_threads` and
+  // `MobileConfig::set_lazy_param_loading` for the loading of params.
   LightPredictor(const std::string& lite_model_file,
-                 bool model_from_memory = false) {
+                 bool model_from_memory = false,
+                 int param_load_threads = 1,
+                 bool lazy_param_loading = false) {
     scope_ = std::make_shared<Scope>();
     program_desc_ = std::make_shared<cpp::ProgramDesc>();
-    Build(lite_model_file, model_from_memory);
+    Build(lite_model_file,
+          model_from_memory,
+          param_load_threads,
+          lazy_param_loading);
   }
 
   // NOTE: This is a deprecated API and will be removed in latter release.
@@ -76,6 +83,7 @@ class LITE_API LightPredictor {
 
   const lite::Tensor* GetTensor(const std::string& name) const {
     auto* var = program_->exec_scope()->FindVar(name);
+    program_->exec_scope()->MaterializeParam(name);
     return &var->Get<lite::Tensor>();
   }
 
@@ -87,13 +95,20 @@ class LITE_API LightPredictor {
   void PrepareFeedFetch();
   Scope* scope() { return scope_.get(); }
 
+  // Set the inter-op threads, see `ConfigBase::set_inter_op_threads`.
+  void SetInterOpThreads(int threads) {
+    program_->set_inter_op_threads(threads);
+  }
+
  private:
   // check if the input tensor precision type is correct.
   // would be called in Run().
   void CheckInputValid();
 
   void Build(const std::string& lite_model_file,
-             bool model_from_memory = false);
+             bool model_from_memory = false,
+             int param_load_threads = 1,
+             bool lazy_param_loading = false);
 
   // NOTE: This is a deprecated API and will be removed in latter release.
   void Build(
@@ -41,10 +41,13 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
                            lite_api::LiteModelType::kNaiveBuffer));
   } else {
     raw_predictor_.reset(new LightPredictor(config.lite_model_file(),
-                                            config.is_model_from_memory()));
+                                            config.is_model_from_memory(),
+                                            config.param_load_threads(),
+                                            config.lazy_param_loading()));
   }
   mode_ = config.power_mode();
   threads_ = config.threads();
+  raw_predictor_->SetInterOpThreads(config.inter_op_threads());
 
 #ifdef LITE_WITH_NPU
   // Store the model-level configuration into scope for kernels, and use
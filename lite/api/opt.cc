@@ -27,6 +27,8 @@
 #include "lite/api/paddle_use_kernels.h"
 #include "lite/api/paddle_use_ops.h"
 #include "lite/api/paddle_use_passes.h"
+#include "lite/core/mir/pass_manager.h"
+#include "lite/core/mir/sparse_weight_convert_pass.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/version.h"
 #include "lite/model_parser/compatible_pb.h"
@@ -65,7 +67,13 @@ DEFINE_bool(quant_model,
 DEFINE_string(quant_type,
               "QUANT_INT16",
               "Set the quant_type for post_quant_dynamic, "
-              "and it should be QUANT_INT8 or QUANT_INT16 for now.");
+              "and it should be QUANT_INT8, QUANT_INT16, QUANT_FP16 or "
+              "QUANT_BF16 for now.");
+DEFINE_double(sparse_threshold,
+              0.7,
+              "The x86 fc, mul and 1x1 conv2d are converted to the block "
+              "sparse kernels when the ratio of the zero blocks of the weight "
+              "is not less than it, and none is converted if it's above 1.");
 DEFINE_bool(enable_fp16, false, "Set kernel_type run in FP16.");
 DEFINE_bool(record_tailoring_info,
             false,
@@ -212,6 +220,10 @@ void RunOptimize(const std::string& model_dir,
     config.set_quant_type(QuantType::QUANT_INT8);
   } else if (quant_type == "QUANT_INT16") {
     config.set_quant_type(QuantType::QUANT_INT16);
+  } else if (quant_type == "QUANT_FP16") {
+    config.set_quant_type(QuantType::QUANT_FP16);
+  } else if (quant_type == "QUANT_BF16") {
+    config.set_quant_type(QuantType::QUANT_BF16);
   } else {
     OPT_LOG_FATAL << "Unsupported quant type: " << quant_type;
   }
@@ -339,7 +351,9 @@ void PrintHelpInfo() {
       "        `--record_tailoring_info=(true|false)`\n"
       "  Arguments of mode quantization in opt:\n"
       "        `--quant_model=(true|false)`\n"
-      "        `--quant_type=(QUANT_INT8|QUANT_INT16)`\n"
+      "        `--quant_type=(QUANT_INT8|QUANT_INT16|QUANT_FP16|QUANT_BF16)`\n"
+      "  Arguments of the sparse weights in opt:\n"
+      "        `--sparse_threshold=<ratio_of_zero_blocks>`\n"
       "  Arguments of enable_fp16 in opt: \n"
       "        `--enable_fp16=(true|false)`\n"
       "  Arguments of model checking and ops information:\n"
@@ -366,9 +380,10 @@ void PrintHelpInfo() {
 // Parse Input command
 void ParseInputCommand() {
   if (FLAGS_quant_model) {
-    if (FLAGS_quant_type != "QUANT_INT8" && FLAGS_quant_type != "QUANT_INT16") {
-      OPT_LOG_FATAL
-          << "quant_type should be `QUANT_INT8` or `QUANT_INT16` for now.";
+    if (FLAGS_quant_type != "QUANT_INT8" && FLAGS_quant_type != "QUANT_INT16" &&
+        FLAGS_quant_type != "QUANT_FP16" && FLAGS_quant_type != "QUANT_BF16") {
+      OPT_LOG_FATAL << "quant_type should be `QUANT_INT8`, `QUANT_INT16`, "
+                       "`QUANT_FP16` or `QUANT_BF16` for now.";
     }
   }
 
@@ -487,6 +502,11 @@ void Main() {
   }
 
   auto valid_places = ParserValidPlaces(FLAGS_enable_fp16);
+  auto* sparse_pass = lite::mir::PassManager::Global()
+                          .LookUp<lite::mir::SparseWeightConvertPass>(
+                              "sparse_weight_convert_pass");
+  CHECK(sparse_pass);
+  sparse_pass->SetSparseThreshold(static_cast<float>(FLAGS_sparse_threshold));
 
   if (FLAGS_model_set_dir == "") {
     RunOptimize(FLAGS_model_dir,
@@ -553,6 +573,8 @@ void Main() {
                        lite::TAILORD_KERNELS_SOURCE_LIST_FILENAME);
   CollectModelMetaInfo(
       FLAGS_optimize_out, model_dirs, lite::TAILORD_KERNELS_LIST_NAME);
+  CollectModelMetaInfo(
+      FLAGS_optimize_out, model_dirs, lite::TAILORD_KERNELS_ATTRS_LIST_NAME);
 }
 
 }  // namespace lite_api
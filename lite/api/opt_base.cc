@@ -13,11 +13,46 @@
 // limitations under the License.
 
 #include "lite/api/opt_base.h"
+#include <cstring>
 #include "all_kernel_faked.cc"  // NOLINT
+#include "lite/core/mir/pass_manager.h"
+#include "lite/core/mir/post_quant_static_pass.h"
+#include "lite/core/mir/sparse_weight_convert_pass.h"
 
 namespace paddle {
 namespace lite_api {
 
+namespace {
+
+// Load a calibration sample, see `OptBase::SetCalibrationDataDir`.
+std::vector<lite::Tensor> LoadCalibrationSample(const std::string& path) {
+  std::vector<char> buffer;
+  CHECK(lite::ReadFile(path, &buffer)) << "Failed to read " << path;
+  std::vector<lite::Tensor> sample;
+  size_t offset = 0;
+  while (offset < buffer.size()) {
+    int32_t rank = 0;
+    CHECK_LE(offset + sizeof(rank), buffer.size()) << "Broken sample " << path;
+    memcpy(&rank, buffer.data() + offset, sizeof(rank));
+    offset += sizeof(rank);
+    std::vector<int64_t> dims(rank);
+    CHECK_LE(offset + rank * sizeof(int64_t), buffer.size())
+        << "Broken sample " << path;
+    memcpy(dims.data(), buffer.data() + offset, rank * sizeof(int64_t));
+    offset += rank * sizeof(int64_t);
+    sample.emplace_back();
+    auto& tensor = sample.back();
+    tensor.Resize(dims);
+    size_t bytes = tensor.numel() * sizeof(float);
+    CHECK_LE(offset + bytes, buffer.size()) << "Broken sample " << path;
+    memcpy(tensor.mutable_data<float>(), buffer.data() + offset, bytes);
+    offset += bytes;
+  }
+  return sample;
+}
+
+}  // namespace
+
 void OptBase::SetModelDir(const std::string& model_path) {
   opt_config_.set_model_dir(model_path);
 }
@@ -49,11 +84,35 @@ void OptBase::SetQuantType(const std::string& quant_type) {
     opt_config_.set_quant_type(lite_api::QuantType::QUANT_INT8);
   } else if (quant_type == "QUANT_INT16") {
     opt_config_.set_quant_type(lite_api::QuantType::QUANT_INT16);
+  } else if (quant_type == "QUANT_FP16") {
+    opt_config_.set_quant_type(lite_api::QuantType::QUANT_FP16);
+  } else if (quant_type == "QUANT_BF16") {
+    opt_config_.set_quant_type(lite_api::QuantType::QUANT_BF16);
   } else {
     OPT_LOG_FATAL << "Unsupported quant type: " << quant_type;
   }
 }
 
+void OptBase::SetCalibrationDataDir(const std::string& calibration_data_dir) {
+  calibration_data_dir_ = calibration_data_dir;
+}
+
+void OptBase::SetCalibrationMethod(const std::string& calibration_method) {
+  if (calibration_method != "KL" && calibration_method != "abs_max" &&
+      calibration_method != "percentile") {
+    OPT_LOG_FATAL << "Unsupported calibration method: " << calibration_method;
+  }
+  calibration_method_ = calibration_method;
+}
+
+void OptBase::SetSparseThreshold(float threshold) {
+  auto* pass = lite::mir::PassManager::Global()
+                   .LookUp<lite::mir::SparseWeightConvertPass>(
+                       "sparse_weight_convert_pass");
+  CHECK(pass);
+  pass->SetSparseThreshold(threshold);
+}
+
 void OptBase::SetPassesInternal(
     const std::vector<std::string>& passes_internal) {
   opt_config_.set_passes_internal(passes_internal);
@@ -138,6 +197,7 @@ void OptBase::Run() {
   if (model_set_dir_ != "") {
     RunOptimizeFromModelSet(record_strip_info_);
   } else {
+    Calibrate();
     auto opt_predictor = lite_api::CreatePaddlePredictor(opt_config_);
     opt_predictor->SaveOptimizedModel(
         lite_out_name_, model_type_, record_strip_info_);
@@ -148,6 +208,55 @@ void OptBase::Run() {
   }
 }
 
+void OptBase::Calibrate() {
+  if (calibration_data_dir_.empty()) return;
+  // 1. Load the samples in the order of file names.
+  auto files = lite::ListDir(calibration_data_dir_);
+  std::sort(files.begin(), files.end());
+  std::vector<std::vector<lite::Tensor>> samples;
+  for (const auto& file : files) {
+    samples.emplace_back(LoadCalibrationSample(
+        lite::Join<std::string>({calibration_data_dir_, file}, "/")));
+  }
+  if (samples.empty()) {
+    OPT_LOG_FATAL << "[" << calibration_data_dir_
+                  << "] does not contain any calibration sample";
+  }
+
+  // 2. Run the samples with the fp32 kernels of host.
+#ifdef LITE_ON_MODEL_OPTIMIZE_TOOL
+  OPT_LOG_FATAL << "The calibration runs the model, but the kernels of the "
+                   "model optimize tool are faked, please use the opt of the "
+                   "full runtime library instead.";
+#endif
+  std::vector<Place> places;
+#if defined(LITE_WITH_X86)
+  places.emplace_back(TARGET(kX86), PRECISION(kFloat));
+#elif defined(LITE_WITH_ARM)
+  places.emplace_back(TARGET(kARM), PRECISION(kFloat));
+#endif
+  places.emplace_back(TARGET(kHost));
+  lite::Predictor predictor;
+  predictor.DisablePasses(lite::Calibrator::VarRenamingPasses());
+  predictor.Build(opt_config_, places);
+  auto thresholds = predictor.Calibrate(samples, calibration_method_);
+  OPT_LOG << "Calibrate " << thresholds.size() << " activations on "
+          << samples.size() << " samples by " << calibration_method_;
+
+  // 3. Quantize the model with the thresholds.
+  auto* pass =
+      lite::mir::PassManager::Global().LookUp<lite::mir::PostQuantStaticPass>(
+          "post_quant_static_pass");
+  CHECK(pass);
+  pass->SetThresholds(thresholds);
+  auto passes = opt_config_.get_passes_internal();
+  if (std::find(passes.begin(), passes.end(), "post_quant_static_pass") ==
+      passes.end()) {
+    passes.push_back("post_quant_static_pass");
+  }
+  opt_config_.set_passes_internal(passes);
+}
+
 void OptBase::RunOptimize(const std::string& model_dir_path,
                           const std::string& model_path,
                           const std::string& param_path,
@@ -167,6 +276,7 @@ void OptBase::RunOptimize(const std::string& model_dir_path,
   if (model_set_dir_ != "") {
     RunOptimizeFromModelSet(record_strip_info_);
   } else {
+    Calibrate();
     auto opt_predictor = lite_api::CreatePaddlePredictor(opt_config_);
     opt_predictor->SaveOptimizedModel(
         lite_out_name_, model_type_, record_strip_info_);
@@ -244,6 +354,8 @@ void OptBase::RunOptimizeFromModelSet(bool record_strip_info) {
         lite_out_name_, model_dirs, lite::TAILORD_KERNELS_SOURCE_LIST_FILENAME);
     CollectModelMetaInfo(
         lite_out_name_, model_dirs, lite::TAILORD_KERNELS_LIST_NAME);
+    CollectModelMetaInfo(
+        lite_out_name_, model_dirs, lite::TAILORD_KERNELS_ATTRS_LIST_NAME);
     OPT_LOG << "Record the information of stripped models into :"
             << lite_out_name_ << "successfully";
   }
@@ -272,6 +384,10 @@ void OptBase::PrintHelpInfo() {
       "imagination_nna|intel_fpga)`\n"
       "        `record_model_info(false|true)`: refer to whether to record ops "
       "info for striping lib, false by default`\n"
+      "        `set_calibration_data_dir(calibration_data_dir)`: quantize the "
+      "model to int8 with the calibration samples\n"
+      "        `set_calibration_method(KL|abs_max|percentile)`: KL by "
+      "default\n"
       "        `run() : start model transformation`\n"
       "    eg. `opt.set_model_dir(\"./mobilenetv1\"); "
       "opt.set_lite_out(\"mobilenetv1_opt\"); opt.set_valid_places(\"arm\"); "
@@ -315,7 +431,9 @@ void OptBase::PrintExecutableBinHelpInfo() {
       "        `--record_tailoring_info=(true|false)`\n"
       "  Arguments of mode quantization in opt:\n"
       "        `--quant_model=(true|false)`\n"
-      "        `--quant_type=(QUANT_INT8|QUANT_INT16)`\n"
+      "        `--quant_type=(QUANT_INT8|QUANT_INT16|QUANT_FP16|QUANT_BF16)`\n"
+      "        `--calibration_data_dir=<calibration_samples_dir>`\n"
+      "        `--calibration_method=(KL|abs_max|percentile)`\n"
       "  Arguments of enable_fp16 in opt: \n"
       "        `--enable_fp16=(true|false)`\n"
       "  Arguments of model checking and ops information:\n"
@@ -52,6 +52,19 @@ class LITE_API OptBase {
   void RecordModelInfo(bool record_strip_info = true);
   void SetQuantModel(bool quant_model);
   void SetQuantType(const std::string &quant_type);
+  // Quantize the weights and the activations of conv2d, depthwise_conv2d and
+  // mul to int8 with the thresholds calibrated on the samples in
+  // `calibration_data_dir`, each file of which holds all of the inputs in the
+  // order of feed, and each input is stored as the int32 rank, the int64 dims
+  // and the fp32 data. The calibration runs the model, so it needs the opt of
+  // the full runtime library rather than the model optimize tool.
+  void SetCalibrationDataDir(const std::string &calibration_data_dir);
+  // The method to calibrate the thresholds: KL, abs_max or percentile.
+  void SetCalibrationMethod(const std::string &calibration_method);
+  // Convert the x86 fc, mul and 1x1 conv2d to the block sparse kernels when
+  // the ratio of the zero blocks of the weight is not less than `threshold`,
+  // which is 0.7 by default, and none is converted if it's above 1.
+  void SetSparseThreshold(float threshold);
   // set optimized_model type
   void SetModelType(std::string model_type = "naive_buffer");
   // internal inference for developer, not recommanded.
@@ -92,7 +105,13 @@ class LITE_API OptBase {
   // Dir path of a set of models, this should be combined with model
   std::string model_set_dir_;
   bool record_strip_info_{false};
+  // Samples and method of the calibration for post_quant_static_pass.
+  std::string calibration_data_dir_;
+  std::string calibration_method_{"KL"};
   void RunOptimizeFromModelSet(bool record_strip_info = false);
+  // Calibrate the model with the fp32 kernels of host, and enable
+  // post_quant_static_pass with the thresholds.
+  void Calibrate();
 };
 
 }  // namespace lite_api
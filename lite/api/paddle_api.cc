@@ -18,6 +18,7 @@
 
 #include "lite/core/context.h"
 #include "lite/core/device_info.h"
+#include "lite/core/sequence_packing.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
 
@@ -42,6 +43,10 @@
 #include "lite/backends/metal/target_wrapper.h"
 #endif
 
+#ifdef LITE_WITH_HOST_MEMORY_POOL
+#include "lite/core/memory_pool.h"
+#endif
+
 namespace paddle {
 namespace lite_api {
 
@@ -73,6 +78,28 @@ bool IsOpenCLBackendValid(bool check_fp16_valid) {
   return opencl_valid;
 }
 
+HostMemoryPoolStats GetHostMemoryPoolStats() {
+  HostMemoryPoolStats stats;
+#ifdef LITE_WITH_HOST_MEMORY_POOL
+  auto pool_stats = lite::HostMemoryPool::Global().stats();
+  stats.bytes_in_use = pool_stats.bytes_in_use;
+  stats.peak_bytes_in_use = pool_stats.peak_bytes_in_use;
+  stats.bytes_cached = pool_stats.bytes_cached;
+  stats.num_allocs = pool_stats.num_allocs;
+  stats.num_hits = pool_stats.num_hits;
+#else
+  LOG(WARNING) << "The host memory pool is disabled, please rebuild it with "
+                  "LITE_WITH_HOST_MEMORY_POOL=ON.";
+#endif
+  return stats;
+}
+
+void TrimHostMemoryPool() {
+#ifdef LITE_WITH_HOST_MEMORY_POOL
+  lite::HostMemoryPool::Global().Trim();
+#endif
+}
+
 Tensor::Tensor(void *raw) : raw_tensor_(raw) {}
 
 // TODO(Superjomn) refine this by using another `const void* const_raw`;
@@ -274,6 +301,20 @@ std::vector<std::string> PaddlePredictor::GetParamNames() {
   return null_result;
 }
 
+void PaddlePredictor::BindInput(int i,
+                                void *data,
+                                size_t memory_size,
+                                TargetType target) {
+  LOG(FATAL) << "The BindInput API is only supported by CxxConfig predictor.";
+}
+
+void PaddlePredictor::BindOutput(int i,
+                                 void *data,
+                                 size_t memory_size,
+                                 TargetType target) {
+  LOG(FATAL) << "The BindOutput API is only supported by CxxConfig predictor.";
+}
+
 void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
                                          LiteModelType model_type,
                                          bool record_info) {
@@ -281,6 +322,80 @@ void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
       << "The SaveOptimizedModel API is only supported by CxxConfig predictor.";
 }
 
+struct RequestPacker::Impl {
+  struct Request {
+    std::vector<lite::Tensor> inputs;
+    std::vector<lite::Tensor> outputs;
+  };
+  std::vector<std::unique_ptr<Request>> requests;
+};
+
+RequestPacker::RequestPacker(std::shared_ptr<PaddlePredictor> predictor)
+    : predictor_(predictor), impl_(new Impl) {
+  CHECK(predictor_);
+}
+
+RequestPacker::~RequestPacker() = default;
+
+int RequestPacker::AddRequest() {
+  if (num_requests_ == static_cast<int>(impl_->requests.size())) {
+    std::unique_ptr<Impl::Request> request(new Impl::Request);
+    request->inputs.resize(predictor_->GetInputNames().size());
+    request->outputs.resize(predictor_->GetOutputNames().size());
+    impl_->requests.push_back(std::move(request));
+  }
+  return num_requests_++;
+}
+
+std::unique_ptr<Tensor> RequestPacker::GetInput(int request, int i) {
+  CHECK_LT(request, num_requests_);
+  auto &inputs = impl_->requests[request]->inputs;
+  CHECK_LT(i, static_cast<int>(inputs.size()));
+  return std::unique_ptr<Tensor>(new Tensor(&inputs[i]));
+}
+
+std::unique_ptr<const Tensor> RequestPacker::GetOutput(int request,
+                                                       int i) const {
+  CHECK_LT(request, num_requests_);
+  auto &outputs = impl_->requests[request]->outputs;
+  CHECK_LT(i, static_cast<int>(outputs.size()));
+  return std::unique_ptr<const Tensor>(new Tensor(&outputs[i]));
+}
+
+void RequestPacker::Run() {
+  CHECK_GT(num_requests_, 0) << "No request is added.";
+  // The outputs are split by the sequences of the first input with LoD.
+  lite::SequencePacking packing;
+  bool packing_has_lod = false;
+  std::vector<const lite::Tensor *> inputs(num_requests_);
+  size_t num_inputs = impl_->requests.front()->inputs.size();
+  for (size_t i = 0; i < num_inputs; i++) {
+    for (int r = 0; r < num_requests_; r++) {
+      inputs[r] = &impl_->requests[r]->inputs[i];
+    }
+    bool has_lod = !inputs.front()->lod().empty();
+    auto input = predictor_->GetInput(i);
+    if (i == 0 || (has_lod && !packing_has_lod)) {
+      lite::PackSequences(inputs, tensor(input->raw_tensor_), &packing);
+      packing_has_lod = has_lod;
+    } else {
+      lite::PackSequences(inputs, tensor(input->raw_tensor_));
+    }
+  }
+
+  predictor_->Run();
+
+  std::vector<lite::Tensor *> outputs(num_requests_);
+  size_t num_outputs = impl_->requests.front()->outputs.size();
+  for (size_t i = 0; i < num_outputs; i++) {
+    for (int r = 0; r < num_requests_; r++) {
+      outputs[r] = &impl_->requests[r]->outputs[i];
+    }
+    auto output = predictor_->GetOutput(i);
+    lite::SplitSequences(*ctensor(output->raw_tensor_), packing, outputs);
+  }
+}
+
 template <typename ConfigT>
 std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(const ConfigT &) {
   return std::shared_ptr<PaddlePredictor>();
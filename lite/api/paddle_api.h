@@ -45,6 +45,27 @@ enum class L3CacheSetMethod {
 // return true if current device supports OpenCL model
 LITE_API bool IsOpenCLBackendValid(bool check_fp16_valid = false);
 
+// Statistics of the pooled allocator for the host memory, it's only available
+// when the lib is compiled with LITE_WITH_HOST_MEMORY_POOL=ON.
+struct LITE_API HostMemoryPoolStats {
+  // The bytes held by the tensors and workspaces.
+  size_t bytes_in_use{0};
+  size_t peak_bytes_in_use{0};
+  // The bytes of the freed memory cached by the pool for reusing.
+  size_t bytes_cached{0};
+  uint64_t num_allocs{0};
+  uint64_t num_hits{0};
+  // The ratio of the allocations served by the cached memory.
+  double hit_rate() const {
+    return num_allocs ? static_cast<double>(num_hits) / num_allocs : 0.;
+  }
+};
+
+LITE_API HostMemoryPoolStats GetHostMemoryPoolStats();
+
+// Return the host memory cached by the pool to the system.
+LITE_API void TrimHostMemoryPool();
+
 struct LITE_API Tensor {
   explicit Tensor(void* raw);
   explicit Tensor(const void* raw);
@@ -82,6 +103,7 @@ struct LITE_API Tensor {
   bool IsInitialized() const;
 
  private:
+  friend class RequestPacker;
   void* raw_tensor_;
 };
 
@@ -121,6 +143,27 @@ class LITE_API PaddlePredictor {
   /// internal infereces API, not recommanded.
   virtual std::unique_ptr<Tensor> GetMutableTensor(const std::string& name);
 
+  /// Bind the caller-owned memory to the i-th input before `Run()`, the data
+  /// is read from it directly without copying. The input should be resized to
+  /// fit in `memory_size` bytes before `Run()`. With the shape buckets, the
+  /// input is padded in place if the memory holds the padded shape, otherwise
+  /// the run goes without the execution plan.
+  virtual void BindInput(int i,
+                         void* data,
+                         size_t memory_size,
+                         TargetType target = TargetType::kHost);
+
+  /// Bind the caller-owned memory to the i-th output before `Run()`, the
+  /// kernel producing the output writes into it directly. The output is
+  /// copied into the memory after `Run()` if it can't be written in place,
+  /// e.g. the memory is too small or not 64-byte aligned, or the output is
+  /// produced by an inplace op. Pass a null `data` to remove the binding.
+  /// This API is only supported by CxxConfig predictor on host.
+  virtual void BindOutput(int i,
+                          void* data,
+                          size_t memory_size,
+                          TargetType target = TargetType::kHost);
+
   /// Persist the optimized model to disk. This API is only supported by
   /// CxxConfig, and the persisted model can be reused for MobileConfig.
   virtual void SaveOptimizedModel(
@@ -135,6 +178,43 @@ class LITE_API PaddlePredictor {
   lite_api::PowerMode mode_{lite_api::LITE_POWER_NO_BIND};
 };
 
+/// RequestPacker packs the LoD inputs of many requests into a single batch of
+/// sequences, runs the predictor once and splits the outputs back to the
+/// requests, so that the GEMMs of the sequence ops, e.g. search_fc,
+/// search_grnn, var_conv_2d and match_matrix_tensor, run over the rows of all
+/// of the requests. The inputs of the requests are concatenated along the
+/// first dimension with the LoDs merged, so they should be of the same LoD
+/// levels and the same dimensions except the first one. An output is split
+/// by its top-level sequences, or by the rows if it has no LoD.
+class LITE_API RequestPacker {
+ public:
+  explicit RequestPacker(std::shared_ptr<PaddlePredictor> predictor);
+  ~RequestPacker();
+
+  /// Add a request and return its index.
+  int AddRequest();
+  int num_requests() const { return num_requests_; }
+
+  /// Get the i-th input of the request, which is set as the i-th input of the
+  /// predictor.
+  std::unique_ptr<Tensor> GetInput(int request, int i);
+
+  /// Run the predictor over the packed inputs of all of the requests.
+  void Run();
+
+  /// Get the i-th output of the request after `Run()`.
+  std::unique_ptr<const Tensor> GetOutput(int request, int i) const;
+
+  /// Remove all of the requests, the tensors are kept for the next requests.
+  void Clear() { num_requests_ = 0; }
+
+ private:
+  struct Impl;
+  std::shared_ptr<PaddlePredictor> predictor_;
+  std::unique_ptr<Impl> impl_;
+  int num_requests_{0};
+};
+
 /// Base class for all the configs.
 class LITE_API ConfigBase {
   std::string model_dir_;
@@ -152,6 +232,7 @@ class LITE_API ConfigBase {
       subgraph_model_cache_buffers_{};
   int device_id_{0};
   int x86_math_num_threads_ = 1;
+  int inter_op_threads_ = 1;
 
   std::string metal_path_;
   bool metal_use_agressive_;
@@ -207,6 +288,12 @@ class LITE_API ConfigBase {
   // set x86_math_num_threads
   void set_x86_math_num_threads(int threads);
   int x86_math_num_threads() const;
+  // set the number of inter-op threads, i.e. the lanes running the independent
+  // ops of the model concurrently, and each lane runs an op with
+  // `x86_math_num_threads` threads. It takes effect only if all of the kernels
+  // are x86 or host ones.
+  void set_inter_op_threads(int threads) { inter_op_threads_ = threads; }
+  int inter_op_threads() const { return inter_op_threads_; }
 
   void set_metal_dir(const std::string& path);
   void set_metal_use_aggressive_optimization(bool flag);
@@ -243,6 +330,9 @@ class LITE_API CxxConfig : public ConfigBase {
   QuantType quant_type_{QuantType::QUANT_INT16};
   std::map<int, std::vector<std::shared_ptr<void>>>
       preferred_inputs_for_warmup_;
+  std::vector<int64_t> shape_buckets_{};
+  int shape_bucket_axis_{1};
+  std::string optimized_model_cache_dir_;
 #ifdef LITE_WITH_CUDA
   bool multi_stream_{false};
 #endif
@@ -288,6 +378,18 @@ class LITE_API CxxConfig : public ConfigBase {
   // abandoned in v3.0.
   bool model_from_memory() const { return static_cast<bool>(model_buffer_); }
 
+  // set the directory caching the optimized models. The model optimized for
+  // the valid places and the passes is saved into it as a naive buffer model
+  // named by the hash of them, the model files and the library version, and
+  // it's loaded directly without optimizing the model again next time. It
+  // takes effect only for the models loaded from files.
+  void set_optimized_model_cache_dir(const std::string& dir) {
+    optimized_model_cache_dir_ = dir;
+  }
+  const std::string& optimized_model_cache_dir() const {
+    return optimized_model_cache_dir_;
+  }
+
 #ifdef LITE_WITH_CUDA
   void set_multi_stream(bool multi_stream) { multi_stream_ = multi_stream; }
   bool multi_stream() const { return multi_stream_; }
@@ -350,6 +452,19 @@ class LITE_API CxxConfig : public ConfigBase {
     return preferred_inputs_for_warmup_;
   }
 
+  // set shape buckets for the dynamic-shape models, e.g. the NLP models fed
+  // with sequences of varying length. The `axis` dimension of the dense inputs
+  // is padded with zeros up to the nearest bucket, and the execution plan of
+  // each bucket is precomputed at the first run, so that the following runs
+  // reuse the inferred shapes and the allocated buffers. Note that the outputs
+  // are of the padded shapes as well.
+  void set_shape_buckets(const std::vector<int64_t>& buckets, int axis = 1) {
+    shape_buckets_ = buckets;
+    shape_bucket_axis_ = axis;
+  }
+  const std::vector<int64_t>& shape_buckets() const { return shape_buckets_; }
+  int shape_bucket_axis() const { return shape_bucket_axis_; }
+
   void set_quant_model(bool quant_model) { quant_model_ = quant_model; }
   bool quant_model() const { return quant_model_; }
   void set_quant_type(QuantType quant_type) { quant_type_ = quant_type; }
@@ -370,6 +485,9 @@ class LITE_API MobileConfig : public ConfigBase {
   std::string model_buffer_;
   std::string param_buffer_;
 
+  int param_load_threads_{1};
+  bool lazy_param_loading_{false};
+
  public:
   // set model data in combined format, `set_model_from_file` refers to loading
   // model from file, set_model_from_buffer refers to loading model from memory
@@ -399,6 +517,17 @@ class LITE_API MobileConfig : public ConfigBase {
   // NOTE: This is a deprecated API and will be removed in latter release.
   const std::string& param_buffer() const { return param_buffer_; }
 
+  // set the number of threads decoding the params of the model in parallel
+  // when the predictor is created.
+  void set_param_load_threads(int threads) { param_load_threads_ = threads; }
+  int param_load_threads() const { return param_load_threads_; }
+  // read the data of a param from the model file when it's used for the first
+  // time instead of when the predictor is created, it takes effect only for
+  // the models set by `set_model_from_file` and optimized by the opt of this
+  // version or later.
+  void set_lazy_param_loading(bool lazy) { lazy_param_loading_ = lazy; }
+  bool lazy_param_loading() const { return lazy_param_loading_; }
+
   // This is the method for allocating workspace_size according to L3Cache size
   void SetArmL3CacheSize(
       L3CacheSetMethod method = L3CacheSetMethod::kDeviceL3Cache,
@@ -102,6 +102,48 @@ TEST(CxxApi, share_external_data) {
   EXPECT_NEAR(out[1], -28.8729, 1e-3);
 }
 
+TEST(CxxApi, bind_input_with_shape_buckets) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+  // The batch of 100 is padded up to 128.
+  config.set_shape_buckets({64, 128}, 0);
+
+  // The first memory holds the padded input, the second one doesn't and the
+  // input runs without padding.
+  for (int64_t capacity : {128, 100}) {
+    auto predictor = lite_api::CreatePaddlePredictor(config);
+    auto outputs = predictor->GetOutputNames();
+
+    std::vector<float> external_data(capacity * 100);
+    for (int i = 0; i < 100 * 100; i++) {
+      external_data[i] = i;
+    }
+    predictor->BindInput(0,
+                         external_data.data(),
+                         external_data.size() * sizeof(float),
+                         TargetType::kHost);
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+
+    for (int repeat = 0; repeat < 2; repeat++) {
+      predictor->Run();
+      auto output = predictor->GetTensor(outputs[0]);
+      EXPECT_EQ(output->shape()[0], capacity);
+      auto* out = output->data<float>();
+      EXPECT_NEAR(out[0], 50.2132, 1e-3);
+      EXPECT_NEAR(out[1], -28.8729, 1e-3);
+      // The bound memory is kept, and the origin data is intact.
+      EXPECT_EQ(input_tensor->data<float>(), external_data.data());
+      EXPECT_EQ(external_data[100 * 100 - 1], 100 * 100 - 1);
+      input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    }
+  }
+}
+
 // Demo1 for Mobile Devices :Load model from file and run
 #ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
 TEST(LightApi, run) {
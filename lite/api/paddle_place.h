@@ -163,6 +163,10 @@ static size_t PrecisionTypeLength(PrecisionType type) {
 enum class QuantType : int {
   QUANT_INT8,
   QUANT_INT16,
+  // Store the weights in fp16/bf16 without scales, only the x86 kernels run
+  // on them directly.
+  QUANT_FP16,
+  QUANT_BF16,
 };
 
 template <typename T>
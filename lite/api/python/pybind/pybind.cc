@@ -68,6 +68,9 @@ void BindLiteOpt(py::module *m) {
       .def("set_model_type", &OptBase::SetModelType)
       .def("set_quant_model", &OptBase::SetQuantModel)
       .def("set_quant_type", &OptBase::SetQuantType)
+      .def("set_calibration_data_dir", &OptBase::SetCalibrationDataDir)
+      .def("set_calibration_method", &OptBase::SetCalibrationMethod)
+      .def("set_sparse_threshold", &OptBase::SetSparseThreshold)
       .def("record_model_info", &OptBase::RecordModelInfo)
       .def("set_passes_internal", &OptBase::SetPassesInternal)
       .def("run", &OptBase::Run)
@@ -135,7 +138,10 @@ void BindLiteCxxConfig(py::module *m) {
            (void (CxxConfig::*)(std::shared_ptr<CxxModelBuffer>)) &
                CxxConfig::set_model_buffer)
       .def("set_passes_internal", &CxxConfig::set_passes_internal)
-      .def("is_model_from_memory", &CxxConfig::is_model_from_memory);
+      .def("is_model_from_memory", &CxxConfig::is_model_from_memory)
+      .def("set_optimized_model_cache_dir",
+           &CxxConfig::set_optimized_model_cache_dir)
+      .def("optimized_model_cache_dir", &CxxConfig::optimized_model_cache_dir);
 #ifdef LITE_WITH_ARM
   cxx_config.def("set_threads", &CxxConfig::set_threads)
       .def("threads", &CxxConfig::threads)
@@ -162,7 +168,11 @@ void BindLiteMobileConfig(py::module *m) {
       .def("set_model_dir", &MobileConfig::set_model_dir)
       .def("model_dir", &MobileConfig::model_dir)
       .def("set_model_buffer", &MobileConfig::set_model_buffer)
-      .def("is_model_from_memory", &MobileConfig::is_model_from_memory);
+      .def("is_model_from_memory", &MobileConfig::is_model_from_memory)
+      .def("set_param_load_threads", &MobileConfig::set_param_load_threads)
+      .def("param_load_threads", &MobileConfig::param_load_threads)
+      .def("set_lazy_param_loading", &MobileConfig::set_lazy_param_loading)
+      .def("lazy_param_loading", &MobileConfig::lazy_param_loading);
 #ifdef LITE_WITH_ARM
   mobile_config.def("set_threads", &MobileConfig::set_threads)
       .def("threads", &MobileConfig::threads)
@@ -246,10 +256,16 @@ void BindLiteTensor(py::module *m) {
     return res;
   };
 
-  py::class_<Tensor> tensor(*m, "Tensor");
+  py::class_<Tensor> tensor(*m, "Tensor", py::buffer_protocol());
 
   tensor.def("resize", &Tensor::Resize)
-      .def("numpy", [](Tensor &self) { return TensorToPyArray(self); })
+      .def_buffer([](Tensor &self) { return TensorToPyBuffer(self); })
+      // The view holds the tensor, which holds the predictor of the outputs.
+      .def("numpy",
+           [](py::object self, bool copy) {
+             return TensorToPyArray(self.cast<const Tensor &>(), copy, self);
+           },
+           py::arg("copy") = false)
       .def("shape", &Tensor::shape)
       .def("target", &Tensor::target)
       .def("precision", &Tensor::precision)
@@ -300,11 +316,25 @@ void BindLiteTensor(py::module *m) {
 
 #ifndef LITE_ON_TINY_PUBLISH
 void BindLiteCxxPredictor(py::module *m) {
-  py::class_<CxxPaddleApiImpl>(*m, "CxxPredictor")
+  py::class_<CxxPaddleApiImpl>(*m, "CxxPredictor", py::dynamic_attr())
       .def(py::init<>())
       .def("get_input", &CxxPaddleApiImpl::GetInput)
-      .def("get_output", &CxxPaddleApiImpl::GetOutput)
-      .def("run", &CxxPaddleApiImpl::Run)
+      .def("get_output", &CxxPaddleApiImpl::GetOutput, py::keep_alive<0, 1>())
+      // The bound arrays are held by the predictor until they're rebound.
+      .def("bind_input",
+           [](py::object self, int index, const py::object &array) {
+             auto bound = BindInputFromPyArray(
+                 &self.cast<CxxPaddleApiImpl &>(), index, array);
+             if (!py::hasattr(self, "_bound_inputs")) {
+               self.attr("_bound_inputs") = py::dict();
+             }
+             self.attr("_bound_inputs")[py::int_(index)] = bound;
+           },
+           py::arg("index"),
+           py::arg("array"))
+      .def("run",
+           &CxxPaddleApiImpl::Run,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_version", &CxxPaddleApiImpl::GetVersion)
       .def("save_optimized_model",
            [](CxxPaddleApiImpl &self, const std::string &output_dir) {
@@ -318,8 +348,10 @@ void BindLiteLightPredictor(py::module *m) {
   py::class_<LightPredictorImpl>(*m, "LightPredictor")
       .def(py::init<>())
       .def("get_input", &LightPredictorImpl::GetInput)
-      .def("get_output", &LightPredictorImpl::GetOutput)
-      .def("run", &LightPredictorImpl::Run)
+      .def("get_output", &LightPredictorImpl::GetOutput, py::keep_alive<0, 1>())
+      .def("run",
+           &LightPredictorImpl::Run,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_version", &LightPredictorImpl::GetVersion);
 }
 
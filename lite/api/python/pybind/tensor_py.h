@@ -71,10 +71,14 @@ inline std::string TensorDTypeToPyDTypeStr(PrecisionType type) {
 
 ////////////////////////////////////////////////////////////////
 // Function Name: TensorToPyArray
-// Usage: Transform tensor's data into numpy array
+// Usage: Transform tensor's data into numpy array. The array is
+//        a view of the tensor's data unless need_deep_copy is
+//        true, and `base` is held by the view to keep the data
+//        alive, it's a copy of the tensor if not specified.
 ////////////////////////////////////////////////////////////////
 inline py::array TensorToPyArray(const Tensor &tensor,
-                                 bool need_deep_copy = false) {
+                                 bool need_deep_copy = false,
+                                 py::object base = py::object()) {
   if (!tensor.IsInitialized()) {
     return py::array();
   }
@@ -94,7 +98,16 @@ inline py::array TensorToPyArray(const Tensor &tensor,
 
   const void *tensor_buf_ptr = static_cast<const void *>(tensor.data<int8_t>());
   std::string py_dtype_str = TensorDTypeToPyDTypeStr(tensor.precision());
-  auto base = py::cast(std::move(tensor));
+  if (need_deep_copy) {
+    // The array without the base owns a copy of the data.
+    return py::array(py::dtype(py_dtype_str.c_str()),
+                     py_dims,
+                     py_strides,
+                     tensor_buf_ptr);
+  }
+  if (!base) {
+    base = py::cast(tensor);
+  }
   return py::array(py::dtype(py_dtype_str.c_str()),
                    py_dims,
                    py_strides,
@@ -102,6 +115,38 @@ inline py::array TensorToPyArray(const Tensor &tensor,
                    base);
 }
 
+////////////////////////////////////////////////////////////////
+// Function Name: TensorToPyBuffer
+// Usage: Expose tensor's data through the buffer protocol
+//        without copying, e.g. numpy.asarray(tensor)
+////////////////////////////////////////////////////////////////
+inline py::buffer_info TensorToPyBuffer(const Tensor &tensor) {
+  if (!tensor.IsInitialized()) {
+    return py::buffer_info(nullptr,
+                           sizeof(float),
+                           py::format_descriptor<float>::format(),
+                           1,
+                           {0},
+                           {sizeof(float)});
+  }
+  const auto &tensor_dims = tensor.shape();
+  size_t sizeof_dtype = lite_api::PrecisionTypeLength(tensor.precision());
+  std::vector<py::ssize_t> py_dims(tensor_dims.size());
+  std::vector<py::ssize_t> py_strides(tensor_dims.size());
+  py::ssize_t numel = 1;
+  for (int i = tensor_dims.size() - 1; i >= 0; --i) {
+    py_dims[i] = static_cast<py::ssize_t>(tensor_dims[i]);
+    py_strides[i] = sizeof_dtype * numel;
+    numel *= py_dims[i];
+  }
+  return py::buffer_info(const_cast<int8_t *>(tensor.data<int8_t>()),
+                         sizeof_dtype,
+                         TensorDTypeToPyDTypeStr(tensor.precision()),
+                         tensor_dims.size(),
+                         py_dims,
+                         py_strides);
+}
+
 ////////////////////////////////////////////////////////////////
 // Function Name: SetTensorFromPyArrayT
 // Usage: Transform numpy of specified precision into tensor
@@ -160,6 +205,66 @@ void SetTensorFromPyArray(Tensor *self,
   }
 }
 
+////////////////////////////////////////////////////////////////
+// Function Name: BindInputFromPyArrayT
+// Usage: Bind the data of numpy array to the input of predictor
+//        without copying. The array is copied only if it's not
+//        C-contiguous or not writeable. Return the bound array,
+//        which should be kept alive until the input is rebound.
+////////////////////////////////////////////////////////////////
+template <typename T>
+py::array BindInputFromPyArrayT(lite_api::PaddlePredictor *predictor,
+                                int index,
+                                const py::array &array,
+                                PrecisionType precision) {
+  using ContiguousArray =
+      py::array_t<T, py::array::c_style | py::array::forcecast>;
+  auto bound = ContiguousArray::ensure(array);
+  if (!bound.writeable()) {
+    std::vector<py::ssize_t> shape(bound.shape(), bound.shape() + bound.ndim());
+    bound = ContiguousArray(shape, bound.data());
+  }
+  std::vector<int64_t> dims(bound.shape(), bound.shape() + bound.ndim());
+  auto input = predictor->GetInput(index);
+  input->Resize(dims);
+  input->SetPrecision(precision);
+  predictor->BindInput(
+      index, bound.mutable_data(), bound.nbytes(), TargetType::kHost);
+  return bound;
+}
+
+////////////////////////////////////////////////////////////////
+// Function Name: BindInputFromPyArray
+// Usage: Bind the input of predictor to numpy array, see
+//        BindInputFromPyArrayT.
+////////////////////////////////////////////////////////////////
+inline py::array BindInputFromPyArray(lite_api::PaddlePredictor *predictor,
+                                      int index,
+                                      const py::object &obj) {
+  auto array = obj.cast<py::array>();
+#define BIND_INPUT_FROM_PY_ARRAY(T, precision)                           \
+  if (py::isinstance<py::array_t<T>>(array)) {                           \
+    return BindInputFromPyArrayT<T>(predictor, index, array, precision); \
+  }
+
+  BIND_INPUT_FROM_PY_ARRAY(float, PrecisionType::kFloat)
+  BIND_INPUT_FROM_PY_ARRAY(int32_t, PrecisionType::kInt32)
+  BIND_INPUT_FROM_PY_ARRAY(int64_t, PrecisionType::kInt64)
+  BIND_INPUT_FROM_PY_ARRAY(double, PrecisionType::kFP64)
+  BIND_INPUT_FROM_PY_ARRAY(int8_t, PrecisionType::kInt8)
+  BIND_INPUT_FROM_PY_ARRAY(int16_t, PrecisionType::kInt16)
+  BIND_INPUT_FROM_PY_ARRAY(uint8_t, PrecisionType::kUInt8)
+  BIND_INPUT_FROM_PY_ARRAY(bool, PrecisionType::kBool)
+
+#undef BIND_INPUT_FROM_PY_ARRAY
+  LOG(FATAL) << "Input object type error or incompatible array data type. "
+                "predictor.bind_input(index, numpy.array) supports numpy "
+                "array input in bool, float32, float64, int8, int16, int32, "
+                "int64 or uint8, please check your input or input array data "
+                "type.";
+  return py::array();
+}
+
 }  // namespace pybind
 }  // namespace lite
 }  // namespace paddle
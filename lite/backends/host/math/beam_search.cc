@@ -13,110 +13,35 @@
 // limitations under the License.
 
 #include "lite/backends/host/math/beam_search.h"
+#include <algorithm>
 #include <cmath>
-#include <string>
 #include <vector>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
 
 namespace paddle {
 namespace lite {
 namespace host {
 namespace math {
-/*
-* The basic items help to sort.
-*/
-struct Item {
-  Item() {}
-  Item(size_t offset, size_t id, float score)
-      : offset(offset), id(id), score(score) {}
-  // offset in the higher lod level.
-  size_t offset;
-  // prefix id in the lower lod level.
-  // size_t prefix;
-  // the candidate id
-  size_t id;
-  // the corresponding score
-  float score;
-
-  inline bool operator<(const Item &in) const {
-    return (score < in.score) || ((score == in.score) && (offset < in.offset));
-  }
 
-  inline void operator=(const Item &in) {
-    offset = in.offset;
-    id = in.id;
-    score = in.score;
-  }
-
-  std::string ToString() {
-    std::ostringstream os;
-    os << "{";
-    os << "offset: " << offset << ", ";
-    os << "id: " << id << ", ";
-    os << "score: " << score << "";
-    os << "}";
-    return os.str();
-  }
-};
+namespace {
 
 /*
- * Prune the source sentences all branchs finished, and it is optional.
- * Pruning must one step later than finishing (thus pre_ids is needed here),
- * since the end tokens must be writed out.
+ * Insert the item into the beam sorted in descending order, the worst item is
+ * dropped if the beam is full.
  */
-void PruneEndBeams(const Tensor *pre_ids,
-                   const LoD &abs_lod,
-                   std::vector<std::vector<Item>> *items,
-                   size_t lod_level,
-                   int end_id) {
-  auto *pre_ids_data = pre_ids->data<int64_t>();
-  auto &high_level = abs_lod[lod_level];
-  for (size_t src_idx = 0; src_idx < high_level.size() - 1; ++src_idx) {
-    size_t src_prefix_start = high_level[src_idx];
-    size_t src_prefix_end = high_level[src_idx + 1];
-    bool finish_flag = true;
-    for (size_t offset = src_prefix_start; offset < src_prefix_end; offset++) {
-      for (auto &item : items->at(offset)) {
-        if (item.id != static_cast<size_t>(end_id) ||
-            pre_ids_data[offset] != end_id) {
-          finish_flag = false;
-          break;
-        }
-      }
-      if (!finish_flag) break;
-    }
-    if (finish_flag) {  // all branchs of the beam (source sentence) end and
-                        // prune this beam
-      for (size_t offset = src_prefix_start; offset < src_prefix_end; offset++)
-        items->at(offset).clear();
-    }
-  }
-}
-
-/*
- * Transform the items into a map whose key is offset, value is the items.
- * NOTE low performance.
- */
-std::vector<std::vector<Item>> ToMap(
-    const std::vector<std::vector<Item>> &items, size_t element_num) {
-  std::vector<std::vector<Item>> result;
-  result.resize(element_num);
-  for (auto &entries : items) {
-    for (const auto &item : entries) {
-      result[item.offset].push_back(item);
-    }
-  }
-  return result;
-}
-
-void Insert(std::vector<Item> *top_beam_ptr,
-            const Item &item,
+void Insert(BeamItem *top_beam,
+            size_t *num_beams_ptr,
+            const BeamItem &item,
             size_t beam_size) {
-  std::vector<Item> &top_beam = *top_beam_ptr;
-
-  size_t num_beams = top_beam.size();
+  size_t num_beams = *num_beams_ptr;
   if (num_beams < beam_size) {
-    top_beam.resize(num_beams + 1);
     num_beams++;
+    *num_beams_ptr = num_beams;
   } else {
     if (item < top_beam[beam_size - 1]) {
       return;
@@ -135,39 +60,70 @@ void Insert(std::vector<Item> *top_beam_ptr,
 }
 
 /*
- * For each source, select top beam_size records.
+ * Return the index of the first x in [begin, end) which is not less than the
+ * threshold, or end if there is none.
  */
-std::vector<std::vector<Item>> SelectTopBeamSizeItems(const Tensor *pre_ids,
-                                                      const Tensor *pre_scores,
-                                                      const Tensor *ids,
-                                                      const Tensor *scores,
-                                                      size_t lod_level,
-                                                      size_t beam_size,
-                                                      int end_id,
-                                                      bool is_accumulated) {
-  std::vector<std::vector<Item>> result;
+size_t FindNotLess(const float *x, size_t begin, size_t end, float threshold) {
+  size_t i = begin;
+#ifdef __AVX__
+  __m256 vthreshold = _mm256_set1_ps(threshold);
+  for (; i + 8 <= end; i += 8) {
+    __m256 vmask =
+        _mm256_cmp_ps(_mm256_loadu_ps(x + i), vthreshold, _CMP_NLT_UQ);
+    int mask = _mm256_movemask_ps(vmask);
+    if (mask) return i + __builtin_ctz(mask);
+  }
+#elif defined(__aarch64__)
+  float32x4_t vthreshold = vdupq_n_f32(threshold);
+  for (; i + 4 <= end; i += 4) {
+    uint32x4_t vless = vcltq_f32(vld1q_f32(x + i), vthreshold);
+    if (vminvq_u32(vless) == 0) break;
+  }
+#endif
+  for (; i < end; i++) {
+    if (!(x[i] < threshold)) return i;
+  }
+  return end;
+}
 
-  // find the current candidates
-  // auto abs_lod = framework::ToAbsOffset(scores->lod());
-  auto abs_lod = scores->lod();
+/*
+ * For each source, select top beam_size records into the flat buffers.
+ */
+void SelectTopBeamSizeItems(const Tensor *pre_ids,
+                            const Tensor *pre_scores,
+                            const Tensor *ids,
+                            const Tensor *scores,
+                            size_t lod_level,
+                            size_t beam_size,
+                            int end_id,
+                            bool is_accumulated,
+                            BeamSearchScratch *scratch) {
+  auto &abs_lod = scores->lod();
   auto *pre_ids_data = pre_ids->data<int64_t>();
   auto *pre_scores_data = pre_scores->data<float>();
 
   auto *ids_data = ids ? ids->data<int64_t>() : nullptr;
   auto *scores_data = scores->data<float>();
 
-  size_t num_seqs = abs_lod[lod_level].size() - 1;
+  int num_seqs = static_cast<int>(abs_lod[lod_level].size() - 1);
   size_t seq_width = 1;
   for (int i = 1; i < scores->dims().size(); i++) {
     seq_width *= scores->dims()[i];
   }
+  if (scratch->items.size() < num_seqs * beam_size) {
+    scratch->items.resize(num_seqs * beam_size);
+  }
+  if (scratch->num_items.size() < static_cast<size_t>(num_seqs)) {
+    scratch->num_items.resize(num_seqs);
+  }
 
-  for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+#pragma omp parallel for
+  for (int seq_id = 0; seq_id < num_seqs; ++seq_id) {
     size_t seq_offset_start = abs_lod[lod_level][seq_id];
     size_t seq_offset_end = abs_lod[lod_level][seq_id + 1];
-
-    std::vector<Item> top_beam;
-    top_beam.reserve(beam_size);
+    BeamItem *top_beam = scratch->items.data() + seq_id * beam_size;
+    size_t *num_beams = &scratch->num_items[seq_id];
+    *num_beams = 0;
 
     for (size_t offset = seq_offset_start; offset < seq_offset_end; ++offset) {
       auto pre_id = pre_ids_data[offset];
@@ -175,26 +131,63 @@ std::vector<std::vector<Item>> SelectTopBeamSizeItems(const Tensor *pre_ids,
       if (pre_id == end_id) {
         // Allocate all probability mass to end_id for finished branchs and
         // the other candidate ids can be ignored.
-        Item item(offset, end_id, pre_score);
-        Insert(&top_beam, item, beam_size);
-      } else {
-        size_t index = offset * seq_width;
-        for (size_t d = 0; d < seq_width; d++, index++) {
-          int64_t id = ids_data ? ids_data[index] : static_cast<int64_t>(d);
-          float score = is_accumulated
-                            ? scores_data[index]
-                            : pre_score + std::log(scores_data[index]);
-          Item item(offset, id, score);
-          Insert(&top_beam, item, beam_size);
+        BeamItem item(offset, end_id, pre_score);
+        Insert(top_beam, num_beams, item, beam_size);
+        continue;
+      }
+      const float *row = scores_data + offset * seq_width;
+      size_t d = 0;
+      while (d < seq_width) {
+        if (*num_beams == beam_size) {
+          // The offset is not less than the offsets of the items in the beam,
+          // so a candidate enters the full beam iff its score is not less
+          // than the worst score. The raw scores are filtered by a slightly
+          // lower bound if they are to be accumulated by the log.
+          float worst = top_beam[beam_size - 1].score;
+          float threshold = worst;
+          if (!is_accumulated) {
+            float margin =
+                1e-4f * (1.f + std::fabs(worst) + std::fabs(pre_score));
+            threshold = std::exp(worst - pre_score - margin);
+          }
+          d = FindNotLess(row, d, seq_width, threshold);
+          if (d == seq_width) break;
         }
+        int64_t id = ids_data ? ids_data[offset * seq_width + d]
+                              : static_cast<int64_t>(d);
+        float score = is_accumulated ? row[d] : pre_score + std::log(row[d]);
+        Insert(top_beam, num_beams, BeamItem(offset, id, score), beam_size);
+        d++;
       }
     }
 
-    result.emplace_back(top_beam);
+    // Order the items by offset, the items of the same offset are kept in
+    // the descending order of score.
+    std::stable_sort(top_beam,
+                     top_beam + *num_beams,
+                     [](const BeamItem &a, const BeamItem &b) {
+                       return a.offset < b.offset;
+                     });
+
+    // Prune the source sentences all branchs finished, pruning must one step
+    // later than finishing (thus pre_ids is needed here), since the end
+    // tokens must be writed out.
+    bool finish_flag = true;
+    for (size_t i = 0; i < *num_beams; i++) {
+      if (top_beam[i].id != end_id ||
+          pre_ids_data[top_beam[i].offset] != end_id) {
+        finish_flag = false;
+        break;
+      }
+    }
+    if (finish_flag) {
+      *num_beams = 0;
+    }
   }
-  return result;
 }
 
+}  // namespace
+
 void beam_search(const Tensor *pre_ids,
                  const Tensor *pre_scores,
                  const Tensor *ids,
@@ -205,26 +198,29 @@ void beam_search(const Tensor *pre_ids,
                  int level,
                  int beam_size,
                  int end_id,
-                 bool is_accumulated) {
-  auto abs_lod = scores->lod();
+                 bool is_accumulated,
+                 BeamSearchScratch *scratch) {
+  BeamSearchScratch local_scratch;
+  if (!scratch) {
+    scratch = &local_scratch;
+  }
+  auto &abs_lod = scores->lod();
   auto &high_level = abs_lod[level];
-  auto items = SelectTopBeamSizeItems(pre_ids,
-                                      pre_scores,
-                                      ids,
-                                      scores,
-                                      level,
-                                      beam_size,
-                                      end_id,
-                                      is_accumulated);
-  auto selected_items = ToMap(items, high_level.back());
-
-  PruneEndBeams(pre_ids, abs_lod, &selected_items, level, end_id);
+  SelectTopBeamSizeItems(pre_ids,
+                         pre_scores,
+                         ids,
+                         scores,
+                         level,
+                         beam_size,
+                         end_id,
+                         is_accumulated,
+                         scratch);
+  size_t num_seqs = high_level.size() - 1;
   // calculate the output tensor's height
-  size_t num_instances = std::accumulate(
-      std::begin(selected_items),
-      std::end(selected_items),
-      0,
-      [](size_t a, std::vector<Item> &b) { return a + b.size(); });
+  size_t num_instances = 0;
+  for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+    num_instances += scratch->num_items[seq_id];
+  }
   // the output tensor shape should be [num_instances, 1]
   auto dims = std::vector<int64_t>({static_cast<int>(num_instances), 1});
   selected_ids->Resize(dims);
@@ -237,30 +233,64 @@ void beam_search(const Tensor *pre_ids,
   auto *parent_idx_data =
       parent_idx ? parent_idx->mutable_data<int>() : nullptr;
 
-  // fill in data
-  std::vector<size_t> low_level;
+  // fill in data and lod, the lod vectors keep their capacity across steps.
+  auto *lod = selected_ids->mutable_lod();
+  lod->resize(2);
+  (*lod)[0].assign(high_level.begin(), high_level.end());
+  auto &low_level = (*lod)[1];
+  size_t num_offsets = high_level.back();
+  low_level.resize(num_offsets + 1);
+  size_t next_offset = 0;
   size_t low_offset = 0;
-  for (auto &items : selected_items) {
-    low_level.push_back(low_offset);
-    for (auto &item : items) {
+  for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+    const BeamItem *items = scratch->items.data() + seq_id * beam_size;
+    for (size_t i = 0; i < scratch->num_items[seq_id]; i++) {
+      auto &item = items[i];
+      while (next_offset <= item.offset) {
+        low_level[next_offset++] = low_offset;
+      }
       if (parent_idx) {
-        parent_idx_data[low_offset] = static_cast<int>(low_level.size() - 1);
+        parent_idx_data[low_offset] = static_cast<int>(item.offset);
       }
       selected_ids_data[low_offset] = item.id;
       selected_scores_data[low_offset] = item.score;
       low_offset++;
     }
   }
-  low_level.push_back(low_offset);
+  while (next_offset <= num_offsets) {
+    low_level[next_offset++] = low_offset;
+  }
+  *(selected_scores->mutable_lod()) = *lod;
+}
 
-  // fill lod
-  LoD lod(2);
-  lod[0].assign(high_level.begin(), high_level.end());
-  lod[1].assign(low_level.begin(), low_level.end());
-  *(selected_ids->mutable_lod()) = lod;
-  *(selected_scores->mutable_lod()) = lod;
+template <typename T>
+void gather_tree(const T *ids,
+                 const T *parents,
+                 T *out,
+                 int max_length,
+                 int batch_size,
+                 int beam_size) {
+  int num_beams = batch_size * beam_size;
+#pragma omp parallel for
+  for (int i = 0; i < num_beams; i++) {
+    int batch = i / beam_size;
+    int beam = i % beam_size;
+    auto idx = (max_length - 1) * num_beams + i;
+    out[idx] = ids[idx];
+    auto parent = parents[idx];
+    for (int step = max_length - 2; step >= 0; step--) {
+      idx = step * num_beams + batch * beam_size;
+      out[idx + beam] = ids[idx + parent];
+      parent = parents[idx + parent];
+    }
+  }
 }
 
+template void gather_tree<int32_t>(
+    const int32_t *, const int32_t *, int32_t *, int, int, int);
+template void gather_tree<int64_t>(
+    const int64_t *, const int64_t *, int64_t *, int, int, int);
+
 }  // namespace math
 }  // namespace host
 }  // namespace lite
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <vector>
 #include "lite/core/context.h"
 
 namespace paddle {
@@ -20,6 +21,36 @@ namespace lite {
 namespace host {
 namespace math {
 
+/*
+ * The candidate of a beam.
+ */
+struct BeamItem {
+  BeamItem() {}
+  BeamItem(size_t offset, int64_t id, float score)
+      : offset(offset), id(id), score(score) {}
+  // offset in the higher lod level.
+  size_t offset{0};
+  // the candidate id
+  int64_t id{0};
+  // the corresponding score
+  float score{0.f};
+
+  inline bool operator<(const BeamItem& in) const {
+    return (score < in.score) || ((score == in.score) && (offset < in.offset));
+  }
+};
+
+/*
+ * The flat buffers of beam_search, they are sized for the sources x beam_size
+ * candidates and reused by the following steps, so that a decoding loop
+ * doesn't allocate once the buffers reach the size of the largest step.
+ */
+struct BeamSearchScratch {
+  // The top beam_size candidates of each source.
+  std::vector<BeamItem> items;
+  std::vector<size_t> num_items;
+};
+
 void beam_search(const Tensor* pre_ids,
                  const Tensor* pre_scores,
                  const Tensor* ids,
@@ -30,7 +61,18 @@ void beam_search(const Tensor* pre_ids,
                  int level,
                  int beam_size,
                  int end_id,
-                 bool is_accumulated);
+                 bool is_accumulated,
+                 BeamSearchScratch* scratch = nullptr);
+
+// Backtrace the beams of [max_length, batch_size, beam_size] ids from their
+// parents at the last step.
+template <typename T>
+void gather_tree(const T* ids,
+                 const T* parents,
+                 T* out,
+                 int max_length,
+                 int batch_size,
+                 int beam_size);
 
 }  // namespace math
 }  // namespace host
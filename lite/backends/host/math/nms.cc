@@ -0,0 +1,298 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/nms.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "lite/backends/host/math/nms_util.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+namespace {
+
+// Sort the indices of the scores above the threshold in the descending order
+// of the scores, the ties are kept in the ascending order of the indices like
+// GetMaxScoreIndex, and only the top_k ones are sorted if top_k > -1.
+std::vector<int> SortedScoreIndex(const float* scores,
+                                  const int64_t score_stride,
+                                  const int64_t num_boxes,
+                                  const float threshold,
+                                  const int64_t top_k) {
+  std::vector<int> indices;
+  indices.reserve(num_boxes);
+  for (int64_t i = 0; i < num_boxes; ++i) {
+    if (scores[i * score_stride] > threshold) {
+      indices.push_back(static_cast<int>(i));
+    }
+  }
+  auto greater = [&](int lhs, int rhs) {
+    float l = scores[lhs * score_stride];
+    float r = scores[rhs * score_stride];
+    return l > r || (l == r && lhs < rhs);
+  };
+  if (top_k > -1 && top_k < static_cast<int64_t>(indices.size())) {
+    std::partial_sort(
+        indices.begin(), indices.begin() + top_k, indices.end(), greater);
+    indices.resize(top_k);
+  } else {
+    std::sort(indices.begin(), indices.end(), greater);
+  }
+  return indices;
+}
+
+}  // namespace
+
+void NmsBoxes::Reserve(size_t n) {
+  x1_.reserve(n);
+  y1_.reserve(n);
+  x2_.reserve(n);
+  y2_.reserve(n);
+  area_.reserve(n);
+}
+
+void NmsBoxes::Clear() {
+  x1_.clear();
+  y1_.clear();
+  x2_.clear();
+  y2_.clear();
+  area_.clear();
+}
+
+void NmsBoxes::Push(const float* box) {
+  x1_.push_back(box[0]);
+  y1_.push_back(box[1]);
+  x2_.push_back(box[2]);
+  y2_.push_back(box[3]);
+  area_.push_back(BBoxArea<float>(box, normalized_));
+}
+
+void NmsBoxes::IoU(const float* box,
+                   size_t begin,
+                   size_t end,
+                   float* iou) const {
+  const float norm = normalized_ ? 0.f : 1.f;
+  const float area = BBoxArea<float>(box, normalized_);
+  size_t i = begin;
+#if defined(__AVX__)
+  const __m256 vx1 = _mm256_set1_ps(box[0]);
+  const __m256 vy1 = _mm256_set1_ps(box[1]);
+  const __m256 vx2 = _mm256_set1_ps(box[2]);
+  const __m256 vy2 = _mm256_set1_ps(box[3]);
+  const __m256 varea = _mm256_set1_ps(area);
+  const __m256 vnorm = _mm256_set1_ps(norm);
+  for (; i + 8 <= end; i += 8) {
+    __m256 kx1 = _mm256_loadu_ps(x1_.data() + i);
+    __m256 ky1 = _mm256_loadu_ps(y1_.data() + i);
+    __m256 kx2 = _mm256_loadu_ps(x2_.data() + i);
+    __m256 ky2 = _mm256_loadu_ps(y2_.data() + i);
+    __m256 karea = _mm256_loadu_ps(area_.data() + i);
+    __m256 disjoint = _mm256_or_ps(
+        _mm256_or_ps(_mm256_cmp_ps(kx1, vx2, _CMP_GT_OQ),
+                     _mm256_cmp_ps(kx2, vx1, _CMP_LT_OQ)),
+        _mm256_or_ps(_mm256_cmp_ps(ky1, vy2, _CMP_GT_OQ),
+                     _mm256_cmp_ps(ky2, vy1, _CMP_LT_OQ)));
+    __m256 inter_w = _mm256_add_ps(
+        _mm256_sub_ps(_mm256_min_ps(vx2, kx2), _mm256_max_ps(vx1, kx1)),
+        vnorm);
+    __m256 inter_h = _mm256_add_ps(
+        _mm256_sub_ps(_mm256_min_ps(vy2, ky2), _mm256_max_ps(vy1, ky1)),
+        vnorm);
+    __m256 inter = _mm256_mul_ps(inter_w, inter_h);
+    __m256 vunion = _mm256_sub_ps(_mm256_add_ps(varea, karea), inter);
+    __m256 viou = _mm256_div_ps(inter, vunion);
+    _mm256_storeu_ps(iou + i - begin, _mm256_andnot_ps(disjoint, viou));
+  }
+#elif defined(__aarch64__)
+  const float32x4_t vx1 = vdupq_n_f32(box[0]);
+  const float32x4_t vy1 = vdupq_n_f32(box[1]);
+  const float32x4_t vx2 = vdupq_n_f32(box[2]);
+  const float32x4_t vy2 = vdupq_n_f32(box[3]);
+  const float32x4_t varea = vdupq_n_f32(area);
+  const float32x4_t vnorm = vdupq_n_f32(norm);
+  for (; i + 4 <= end; i += 4) {
+    float32x4_t kx1 = vld1q_f32(x1_.data() + i);
+    float32x4_t ky1 = vld1q_f32(y1_.data() + i);
+    float32x4_t kx2 = vld1q_f32(x2_.data() + i);
+    float32x4_t ky2 = vld1q_f32(y2_.data() + i);
+    float32x4_t karea = vld1q_f32(area_.data() + i);
+    uint32x4_t disjoint =
+        vorrq_u32(vorrq_u32(vcgtq_f32(kx1, vx2), vcltq_f32(kx2, vx1)),
+                  vorrq_u32(vcgtq_f32(ky1, vy2), vcltq_f32(ky2, vy1)));
+    float32x4_t inter_w =
+        vaddq_f32(vsubq_f32(vminq_f32(vx2, kx2), vmaxq_f32(vx1, kx1)), vnorm);
+    float32x4_t inter_h =
+        vaddq_f32(vsubq_f32(vminq_f32(vy2, ky2), vmaxq_f32(vy1, ky1)), vnorm);
+    float32x4_t inter = vmulq_f32(inter_w, inter_h);
+    float32x4_t vunion = vsubq_f32(vaddq_f32(varea, karea), inter);
+    float32x4_t viou = vdivq_f32(inter, vunion);
+    vst1q_f32(iou + i - begin,
+              vreinterpretq_f32_u32(
+                  vbicq_u32(vreinterpretq_u32_f32(viou), disjoint)));
+  }
+#endif
+  for (; i < end; ++i) {
+    if (x1_[i] > box[2] || x2_[i] < box[0] || y1_[i] > box[3] ||
+        y2_[i] < box[1]) {
+      iou[i - begin] = 0.f;
+      continue;
+    }
+    float inter_w =
+        (std::min)(box[2], x2_[i]) - (std::max)(box[0], x1_[i]) + norm;
+    float inter_h =
+        (std::min)(box[3], y2_[i]) - (std::max)(box[1], y1_[i]) + norm;
+    float inter = inter_w * inter_h;
+    iou[i - begin] = inter / (area + area_[i] - inter);
+  }
+}
+
+bool NmsBoxes::AnyAbove(const float* box, float threshold) const {
+  const size_t kBlock = 32;
+  float iou[kBlock];
+  for (size_t begin = 0; begin < size(); begin += kBlock) {
+    size_t end = (std::min)(begin + kBlock, size());
+    IoU(box, begin, end, iou);
+    for (size_t i = 0; i < end - begin; ++i) {
+      if (iou[i] > threshold) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void NMSFast(const float* boxes,
+             const int64_t box_size,
+             const int64_t box_stride,
+             const float* scores,
+             const int64_t score_stride,
+             const int64_t num_boxes,
+             const float score_threshold,
+             const float nms_threshold,
+             const float eta,
+             const int64_t top_k,
+             const bool normalized,
+             std::vector<int>* selected_indices) {
+  // 4: [xmin ymin xmax ymax]
+  // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
+  const bool is_poly = box_size == 8 || box_size == 16 || box_size == 24 ||
+                       box_size == 32;
+  CHECK(box_size == 4 || is_poly)
+      << "Unsupported box size " << box_size
+      << " of NMS, expect 4, 8, 16, 24 or 32.";
+  selected_indices->clear();
+  std::vector<int> sorted_indices = SortedScoreIndex(
+      scores, score_stride, num_boxes, score_threshold, top_k);
+  NmsBoxes kept(normalized);
+  if (box_size == 4) {
+    kept.Reserve(sorted_indices.size());
+  }
+  float adaptive_threshold = nms_threshold;
+  for (int idx : sorted_indices) {
+    const float* box = boxes + idx * box_stride;
+    bool keep = true;
+    if (box_size == 4) {
+      keep = !kept.AnyAbove(box, adaptive_threshold);
+    } else {
+      for (int kept_idx : *selected_indices) {
+        float overlap = PolyIoU<float>(
+            box, boxes + kept_idx * box_stride, box_size, normalized);
+        if (overlap > adaptive_threshold) {
+          keep = false;
+          break;
+        }
+      }
+    }
+    if (keep) {
+      selected_indices->push_back(idx);
+      if (box_size == 4) {
+        kept.Push(box);
+      }
+      if (eta < 1 && adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
+    }
+  }
+}
+
+void NMSMatrix(const float* boxes,
+               const int64_t box_size,
+               const float* scores,
+               const int64_t num_boxes,
+               const float score_threshold,
+               const float post_threshold,
+               const float sigma,
+               const int64_t top_k,
+               const bool normalized,
+               const bool use_gaussian,
+               std::vector<int>* selected_indices,
+               std::vector<float>* decayed_scores) {
+  std::vector<int> perm =
+      SortedScoreIndex(scores, 1, num_boxes, score_threshold, top_k);
+  const int64_t num_pre = perm.size();
+  if (num_pre <= 0) {
+    return;
+  }
+
+  NmsBoxes sorted_boxes(normalized);
+  sorted_boxes.Reserve(num_pre);
+  for (int64_t i = 0; i < num_pre; i++) {
+    sorted_boxes.Push(boxes + perm[i] * box_size);
+  }
+  // The lower triangle of the IoU matrix, row i holds the IoU of box i
+  // against the boxes [0, i).
+  std::vector<float> iou_matrix((num_pre * (num_pre - 1)) >> 1);
+  std::vector<float> iou_max(num_pre);
+  iou_max[0] = 0.;
+  for (int64_t i = 1; i < num_pre; i++) {
+    float* row = iou_matrix.data() + i * (i - 1) / 2;
+    sorted_boxes.IoU(boxes + perm[i] * box_size, 0, i, row);
+    iou_max[i] = (std::max)(0.f, *std::max_element(row, row + i));
+  }
+
+  if (scores[perm[0]] > post_threshold) {
+    selected_indices->push_back(perm[0]);
+    decayed_scores->push_back(scores[perm[0]]);
+  }
+
+  for (int64_t i = 1; i < num_pre; i++) {
+    const float* row = iou_matrix.data() + i * (i - 1) / 2;
+    float min_decay = 1.;
+    for (int64_t j = 0; j < i; j++) {
+      float max_iou = iou_max[j];
+      float iou = row[j];
+      float decay = use_gaussian
+                        ? std::exp((max_iou * max_iou - iou * iou) * sigma)
+                        : (1. - iou) / (1. - max_iou);
+      min_decay = (std::min)(min_decay, decay);
+    }
+    float ds = min_decay * scores[perm[i]];
+    if (ds <= post_threshold) continue;
+    selected_indices->push_back(perm[i]);
+    decayed_scores->push_back(ds);
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
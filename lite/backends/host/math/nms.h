@@ -0,0 +1,88 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The boxes of [xmin, ymin, xmax, ymax] stored as the structure of arrays, so
+// that the IoU of a box against a block of them is computed with SIMD.
+class NmsBoxes {
+ public:
+  explicit NmsBoxes(bool normalized) : normalized_(normalized) {}
+
+  void Reserve(size_t n);
+  void Clear();
+  void Push(const float* box);
+  size_t size() const { return x1_.size(); }
+
+  // The IoU of the box against the boxes in [begin, end), which is the same
+  // as JaccardOverlap in nms_util.h.
+  void IoU(const float* box, size_t begin, size_t end, float* iou) const;
+  // Whether the IoU of the box against any of the boxes is above threshold.
+  bool AnyAbove(const float* box, float threshold) const;
+
+ private:
+  bool normalized_;
+  std::vector<float> x1_;
+  std::vector<float> y1_;
+  std::vector<float> x2_;
+  std::vector<float> y2_;
+  std::vector<float> area_;
+};
+
+// The greedy NMS of the boxes of one class, the box and the score of i are
+// boxes[i * box_stride] and scores[i * score_stride], so that the classes
+// interleaved in the inputs are processed without slicing. The boxes of 4
+// coordinates are compared with the kept ones in SIMD blocks, the polygons
+// of 8, 16, 24 or 32 coordinates fall back to PolyIoU.
+void NMSFast(const float* boxes,
+             const int64_t box_size,
+             const int64_t box_stride,
+             const float* scores,
+             const int64_t score_stride,
+             const int64_t num_boxes,
+             const float score_threshold,
+             const float nms_threshold,
+             const float eta,
+             const int64_t top_k,
+             const bool normalized,
+             std::vector<int>* selected_indices);
+
+// The matrix NMS of the boxes of one class, the selected indices and their
+// decayed scores are appended to the outputs. The boxes are
+// [num_boxes, box_size] and only the first 4 coordinates are used.
+void NMSMatrix(const float* boxes,
+               const int64_t box_size,
+               const float* scores,
+               const int64_t num_boxes,
+               const float score_threshold,
+               const float post_threshold,
+               const float sigma,
+               const int64_t top_k,
+               const bool normalized,
+               const bool use_gaussian,
+               std::vector<int>* selected_indices,
+               std::vector<float>* decayed_scores);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -13,38 +13,261 @@
 // limitations under the License.
 
 #include "lite/backends/host/math/topk.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
+#include "lite/utils/cp_logging.h"
 
 namespace paddle {
 namespace lite {
 namespace host {
 namespace math {
 
-bool comp_func(std::pair<float, int> a, std::pair<float, int> b) {
-  return (a.first > b.first);
+namespace {
+
+// The rows not shorter than it are split into chunks searched in parallel if
+// there are fewer rows than threads.
+const int kMinChunkSize = 1 << 15;
+
+template <typename T>
+using Candidate = std::pair<T, int64_t>;
+
+// Whether a is ranked before b, the ties are ordered by index.
+template <typename T, bool kLargest>
+struct Better {
+  bool operator()(const Candidate<T>& a, const Candidate<T>& b) const {
+    if (a.first != b.first) {
+      return kLargest ? a.first > b.first : a.first < b.first;
+    }
+    return a.second < b.second;
+  }
+};
+
+template <typename T, bool kLargest>
+inline bool Beats(T x, T threshold) {
+  return kLargest ? x > threshold : x < threshold;
+}
+
+// Return the index of the first element in [begin, n) beating the threshold,
+// or n if there is none.
+template <typename T, bool kLargest>
+struct NextCandidate {
+  static int Find(const T* x, int begin, int n, T threshold) {
+    for (int j = begin; j < n; j++) {
+      if (Beats<T, kLargest>(x[j], threshold)) return j;
+    }
+    return n;
+  }
+};
+
+template <bool kLargest>
+struct NextCandidate<float, kLargest> {
+  static int Find(const float* x, int begin, int n, float threshold) {
+    int j = begin;
+#ifdef __AVX__
+    __m256 vthreshold = _mm256_set1_ps(threshold);
+    for (; j + 8 <= n; j += 8) {
+      __m256 vx = _mm256_loadu_ps(x + j);
+      __m256 vmask = kLargest ? _mm256_cmp_ps(vx, vthreshold, _CMP_GT_OQ)
+                              : _mm256_cmp_ps(vx, vthreshold, _CMP_LT_OQ);
+      int mask = _mm256_movemask_ps(vmask);
+      if (mask) return j + __builtin_ctz(mask);
+    }
+#elif defined(__aarch64__)
+    float32x4_t vthreshold = vdupq_n_f32(threshold);
+    for (; j + 4 <= n; j += 4) {
+      float32x4_t vx = vld1q_f32(x + j);
+      uint32x4_t vmask = kLargest ? vcgtq_f32(vx, vthreshold)
+                                  : vcltq_f32(vx, vthreshold);
+      if (vmaxvq_u32(vmask)) break;
+    }
+#endif
+    for (; j < n; j++) {
+      if (Beats<float, kLargest>(x[j], threshold)) return j;
+    }
+    return n;
+  }
+};
+
+// Append the top k candidates of x[0, n) to `result` unordered, the indices
+// are offset by `base`. `heap` is the scratch space.
+template <typename T, bool kLargest>
+void SelectCandidates(const T* x,
+                      int n,
+                      int k,
+                      int64_t base,
+                      std::vector<Candidate<T>>* heap,
+                      std::vector<Candidate<T>>* result) {
+  k = std::min(k, n);
+  if (k <= 0) return;
+  Better<T, kLargest> better;
+  heap->clear();
+  if (static_cast<int64_t>(k) * 16 > n) {
+    // Too many candidates to be filtered, select them by nth_element.
+    for (int j = 0; j < n; j++) {
+      heap->emplace_back(x[j], base + j);
+    }
+    if (k < n) {
+      std::nth_element(
+          heap->begin(), heap->begin() + k - 1, heap->end(), better);
+    }
+    result->insert(result->end(), heap->begin(), heap->begin() + k);
+    return;
+  }
+  // The front of the heap is the worst candidate, the following elements are
+  // larger in index, so they have to beat its value to replace it.
+  for (int j = 0; j < k; j++) {
+    heap->emplace_back(x[j], base + j);
+  }
+  std::make_heap(heap->begin(), heap->end(), better);
+  int j = NextCandidate<T, kLargest>::Find(x, k, n, heap->front().first);
+  while (j < n) {
+    std::pop_heap(heap->begin(), heap->end(), better);
+    heap->back() = Candidate<T>(x[j], base + j);
+    std::push_heap(heap->begin(), heap->end(), better);
+    j = NextCandidate<T, kLargest>::Find(x, j + 1, n, heap->front().first);
+  }
+  result->insert(result->end(), heap->begin(), heap->end());
+}
+
+// Sort the top k of the candidates and write them with the stride.
+template <typename T, bool kLargest>
+void WriteSorted(std::vector<Candidate<T>>* candidates,
+                 int k,
+                 int stride,
+                 T* out_val,
+                 int64_t* out_ind) {
+  Better<T, kLargest> better;
+  auto mid = candidates->begin() + k;
+  if (candidates->size() > static_cast<size_t>(k)) {
+    std::partial_sort(candidates->begin(), mid, candidates->end(), better);
+  } else {
+    std::sort(candidates->begin(), mid, better);
+  }
+  for (int j = 0; j < k; j++) {
+    out_val[j * stride] = (*candidates)[j].first;
+    out_ind[j * stride] = (*candidates)[j].second;
+  }
 }
 
+int MaxThreads() {
+#ifdef _OPENMP
+  return omp_in_parallel() ? 1 : omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+template <typename T, bool kLargest>
+void TopkImpl(const T* din,
+              T* out_val,
+              int64_t* out_ind,
+              int outer,
+              int axis_size,
+              int inner,
+              int k) {
+  int rows = outer * inner;
+  int threads = MaxThreads();
+  int chunks = std::min(threads, axis_size / kMinChunkSize);
+  if (rows < threads && inner == 1 && chunks > 1 &&
+      static_cast<int64_t>(k) * chunks * 16 <= axis_size) {
+    // Few long rows, search the chunks of each row in parallel and merge
+    // their candidates.
+    int chunk_size = (axis_size + chunks - 1) / chunks;
+    std::vector<std::vector<Candidate<T>>> results(chunks);
+    for (int r = 0; r < rows; r++) {
+      const T* x = din + static_cast<int64_t>(r) * axis_size;
+#pragma omp parallel for
+      for (int c = 0; c < chunks; c++) {
+        int begin = c * chunk_size;
+        int size = std::min(chunk_size, axis_size - begin);
+        std::vector<Candidate<T>> heap;
+        results[c].clear();
+        SelectCandidates<T, kLargest>(
+            x + begin, size, k, begin, &heap, &results[c]);
+      }
+      std::vector<Candidate<T>> merged;
+      merged.reserve(static_cast<size_t>(k) * chunks);
+      for (auto& result : results) {
+        merged.insert(merged.end(), result.begin(), result.end());
+      }
+      WriteSorted<T, kLargest>(&merged,
+                               k,
+                               1,
+                               out_val + static_cast<int64_t>(r) * k,
+                               out_ind + static_cast<int64_t>(r) * k);
+    }
+    return;
+  }
+#pragma omp parallel
+  {
+    std::vector<T> row(inner > 1 ? axis_size : 0);
+    std::vector<Candidate<T>> heap;
+    std::vector<Candidate<T>> candidates;
+#pragma omp for
+    for (int r = 0; r < rows; r++) {
+      int n = r / inner;
+      int i = r % inner;
+      const T* x = din + static_cast<int64_t>(n) * axis_size * inner + i;
+      if (inner > 1) {
+        for (int j = 0; j < axis_size; j++) {
+          row[j] = x[j * inner];
+        }
+        x = row.data();
+      }
+      candidates.clear();
+      SelectCandidates<T, kLargest>(x, axis_size, k, 0, &heap, &candidates);
+      int64_t offset = static_cast<int64_t>(n) * k * inner + i;
+      WriteSorted<T, kLargest>(
+          &candidates, k, inner, out_val + offset, out_ind + offset);
+    }
+  }
+}
+
+}  // namespace
+
 void topk(const float* in_data,
           float* out_val,
           int64_t* out_ind,
           int m,
           int n,
           int k) {
-  for (int i = 0; i < m; i++) {
-    const float* in_tmp = in_data + i * n;
-    float* out_val_tmp = out_val + i * k;
-    int64_t* out_ind_tmp = out_ind + i * k;
-    std::vector<std::pair<float, int>> vec;
-    for (int j = 0; j < n; j++) {
-      vec.push_back(std::make_pair(in_tmp[j], j));
-    }
-    std::partial_sort(vec.begin(), vec.begin() + k, vec.end(), comp_func);
-    for (int q = 0; q < k; q++) {
-      out_val_tmp[q] = vec[q].first;
-      out_ind_tmp[q] = vec[q].second;
-    }
+  topk<float>(in_data, out_val, out_ind, m, n, 1, k, true);
+}
+
+template <typename T>
+void topk(const T* din,
+          T* out_val,
+          int64_t* out_ind,
+          int outer,
+          int axis_size,
+          int inner,
+          int k,
+          bool largest) {
+  CHECK_LE(k, axis_size) << "k should not be larger than the axis size.";
+  if (largest) {
+    TopkImpl<T, true>(din, out_val, out_ind, outer, axis_size, inner, k);
+  } else {
+    TopkImpl<T, false>(din, out_val, out_ind, outer, axis_size, inner, k);
   }
 }
 
+template void topk<float>(
+    const float*, float*, int64_t*, int, int, int, int, bool);
+template void topk<int32_t>(
+    const int32_t*, int32_t*, int64_t*, int, int, int, int, bool);
+template void topk<int64_t>(
+    const int64_t*, int64_t*, int64_t*, int, int, int, int, bool);
+
 }  // namespace math
 }  // namespace host
 }  // namespace lite
@@ -13,18 +13,37 @@
 // limitations under the License.
 
 #pragma once
-#include <algorithm>
-#include <utility>
-#include <vector>
+#include <cstdint>
 
 namespace paddle {
 namespace lite {
 namespace host {
 namespace math {
 
+// Select the k largest elements of each of the m rows of size n.
 void topk(
     const float* din, float* out_val, int64_t* out_ind, int m, int n, int k);
 
+// Select the k largest, or the k smallest if `largest` is false, elements
+// along the axis of `din` viewed as [outer, axis_size, inner], the results are
+// written in the same layout with the axis of size k. The results are sorted
+// and the ties are ordered by index.
+//
+// The rows are processed in parallel. A candidate heap of size k is kept for
+// each row, and the elements not beating the worst candidate are filtered by
+// SIMD comparisons; a large k falls back to the selection by nth_element.
+// When there are fewer rows than threads, the long rows are split into
+// chunks searched in parallel, then the candidates of the chunks are merged.
+template <typename T>
+void topk(const T* din,
+          T* out_val,
+          int64_t* out_ind,
+          int outer,
+          int axis_size,
+          int inner,
+          int k,
+          bool largest = true);
+
 }  // namespace math
 }  // namespace host
 }  // namespace lite
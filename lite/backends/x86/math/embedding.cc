@@ -0,0 +1,213 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/embedding.h"
+#include <xmmintrin.h>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The rows are prefetched several ids ahead to hide the cache misses of the
+// random access to a large table.
+const int64_t kPrefetchDistance = 8;
+const int64_t kPrefetchLines = 8;
+// Sorting the ids only pays off for the tables much larger than the L2 cache.
+const int64_t kSortMinIds = 64;
+const int64_t kSortMinTableBytes = 8 << 20;
+
+struct IdPos {
+  int64_t id;
+  int64_t pos;
+};
+
+inline void prefetch_row(const float* table,
+                         const int64_t row_number,
+                         const int64_t row_width,
+                         const int64_t id) {
+  if (id < 0 || id >= row_number) return;
+  const char* row = reinterpret_cast<const char*>(table + id * row_width);
+  int64_t lines =
+      std::min<int64_t>((row_width * sizeof(float) + 63) / 64, kPrefetchLines);
+  for (int64_t i = 0; i < lines; i++) {
+    _mm_prefetch(row + i * 64, _MM_HINT_T0);
+  }
+}
+
+inline const float* row_of(const float* table,
+                           const int64_t row_number,
+                           const int64_t row_width,
+                           const int64_t id) {
+  CHECK_LT(id, row_number);
+  CHECK_GE(id, 0);
+  return table + id * row_width;
+}
+
+inline void add_row(const float* x, const int64_t n, float* y) {
+  int64_t i = 0;
+#ifdef __AVX__
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(
+        y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_loadu_ps(x + i)));
+  }
+#endif
+  for (; i < n; i++) {
+    y[i] += x[i];
+  }
+}
+
+inline void scale_row(const float scale, const int64_t n, float* y) {
+  int64_t i = 0;
+#ifdef __AVX__
+  __m256 vscale = _mm256_set1_ps(scale);
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(y + i, _mm256_mul_ps(_mm256_loadu_ps(y + i), vscale));
+  }
+#endif
+  for (; i < n; i++) {
+    y[i] *= scale;
+  }
+}
+
+}  // namespace
+
+size_t lookup_table_workspace_size(const int64_t row_number,
+                                   const int64_t row_width,
+                                   const int64_t ids_numel) {
+  int64_t table_bytes = row_number * row_width * sizeof(float);
+  if (ids_numel < kSortMinIds || table_bytes < kSortMinTableBytes) {
+    return 0;
+  }
+  return ids_numel * sizeof(IdPos);
+}
+
+void lookup_table(const float* table,
+                  const int64_t row_number,
+                  const int64_t row_width,
+                  const int64_t* ids,
+                  const int64_t ids_numel,
+                  const int64_t padding_idx,
+                  float* out,
+                  void* workspace) {
+  const size_t row_bytes = row_width * sizeof(float);
+  if (workspace == nullptr) {
+    for (int64_t i = 0; i < ids_numel; ++i) {
+      if (i + kPrefetchDistance < ids_numel) {
+        prefetch_row(table, row_number, row_width, ids[i + kPrefetchDistance]);
+      }
+      if (padding_idx != -1 && ids[i] == padding_idx) {
+        memset(out + i * row_width, 0, row_bytes);
+      } else {
+        memcpy(out + i * row_width,
+               row_of(table, row_number, row_width, ids[i]),
+               row_bytes);
+      }
+    }
+    return;
+  }
+
+  auto* order = static_cast<IdPos*>(workspace);
+  for (int64_t i = 0; i < ids_numel; ++i) {
+    order[i].id = ids[i];
+    order[i].pos = i;
+  }
+  std::sort(order, order + ids_numel, [](const IdPos& a, const IdPos& b) {
+    return a.id < b.id;
+  });
+  int64_t i = 0;
+  while (i < ids_numel) {
+    const int64_t id = order[i].id;
+    float* first = out + order[i].pos * row_width;
+    if (padding_idx != -1 && id == padding_idx) {
+      memset(first, 0, row_bytes);
+    } else {
+      memcpy(first, row_of(table, row_number, row_width, id), row_bytes);
+    }
+    // The duplicated ids copy the row just written, which is still in cache.
+    int64_t j = i + 1;
+    for (; j < ids_numel && order[j].id == id; ++j) {
+      memcpy(out + order[j].pos * row_width, first, row_bytes);
+    }
+    if (j + kPrefetchDistance < ids_numel) {
+      prefetch_row(
+          table, row_number, row_width, order[j + kPrefetchDistance].id);
+    }
+    i = j;
+  }
+}
+
+void embedding_seq_pool(const float* table,
+                        const int64_t row_number,
+                        const int64_t row_width,
+                        const int64_t* ids,
+                        const int64_t ids_per_pos,
+                        const uint64_t* lod,
+                        const int64_t seq_num,
+                        const int64_t padding_idx,
+                        const std::string& pool_type,
+                        float* out) {
+  const bool is_first = pool_type == "FIRST";
+  const bool is_last = pool_type == "LAST";
+  CHECK(is_first || is_last || pool_type == "SUM" ||
+        pool_type == "AVERAGE" || pool_type == "SQRT")
+      << "Unsupported pooltype: " << pool_type;
+  const int64_t out_width = ids_per_pos * row_width;
+  const int64_t ids_numel = lod[seq_num] * ids_per_pos;
+  for (int64_t s = 0; s < seq_num; ++s) {
+    float* dst = out + s * out_width;
+    memset(dst, 0, out_width * sizeof(float));
+    int64_t begin = lod[s];
+    int64_t end = lod[s + 1];
+    if (begin == end) {
+      continue;
+    }
+    if (is_first) {
+      end = begin + 1;
+    } else if (is_last) {
+      begin = end - 1;
+    }
+    for (int64_t i = begin * ids_per_pos; i < end * ids_per_pos; ++i) {
+      if (i + kPrefetchDistance < ids_numel) {
+        prefetch_row(table, row_number, row_width, ids[i + kPrefetchDistance]);
+      }
+      if (padding_idx != -1 && ids[i] == padding_idx) {
+        continue;
+      }
+      add_row(row_of(table, row_number, row_width, ids[i]),
+              row_width,
+              dst + (i % ids_per_pos) * row_width);
+    }
+    const int64_t len = end - begin;
+    if (pool_type == "AVERAGE") {
+      scale_row(1.f / len, out_width, dst);
+    } else if (pool_type == "SQRT") {
+      scale_row(1.f / std::sqrt(static_cast<float>(len)), out_width, dst);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
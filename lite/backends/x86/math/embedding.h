@@ -0,0 +1,64 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The bytes of the workspace needed by lookup_table to sort the ids, it's 0
+// if the ids are looked up in their original order, e.g. the table fits in
+// the cache or there are only a few ids.
+size_t lookup_table_workspace_size(const int64_t row_number,
+                                   const int64_t row_width,
+                                   const int64_t ids_numel);
+
+// Gather the rows of the table indexed by the ids, the rows of padding_idx are
+// filled with zeros. If the workspace is given, the ids are sorted and
+// deduplicated so that each row is read from the table only once and in the
+// ascending order of the addresses.
+void lookup_table(const float* table,
+                  const int64_t row_number,
+                  const int64_t row_width,
+                  const int64_t* ids,
+                  const int64_t ids_numel,
+                  const int64_t padding_idx,
+                  float* out,
+                  void* workspace);
+
+// Look up the ids and pool the rows of each sequence in one pass, which is
+// lookup_table followed by sequence_pool without the intermediate tensor.
+// Each sequence position has ids_per_pos ids, their rows are concatenated,
+// so each pooled row of the output is of ids_per_pos * row_width. The
+// pool_type is one of SUM, AVERAGE, SQRT, FIRST and LAST.
+void embedding_seq_pool(const float* table,
+                        const int64_t row_number,
+                        const int64_t row_width,
+                        const int64_t* ids,
+                        const int64_t ids_per_pos,
+                        const uint64_t* lod,
+                        const int64_t seq_num,
+                        const int64_t padding_idx,
+                        const std::string& pool_type,
+                        float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
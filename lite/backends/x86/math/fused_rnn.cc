@@ -0,0 +1,331 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/fused_rnn.h"
+#include <algorithm>
+#include <numeric>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The max number of the sequences processed together by a thread.
+const int kMaxBlockSize = 8;
+
+#ifdef __AVX__
+inline __m256 Fmadd(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+#endif
+
+// c[i][0, n) += a[i][0, k) x w for i in [0, MR), where w is [k, n] with the
+// leading dimension ldw. The panels of 16 columns of w are loaded once for
+// the MR rows.
+template <int MR>
+void GemmAccKernel(const float* const* a,
+                   float* const* c,
+                   const float* w,
+                   int k,
+                   int n,
+                   int ldw) {
+  int j = 0;
+#ifdef __AVX__
+  for (; j + 16 <= n; j += 16) {
+    __m256 acc0[MR];
+    __m256 acc1[MR];
+    for (int i = 0; i < MR; i++) {
+      acc0[i] = _mm256_loadu_ps(c[i] + j);
+      acc1[i] = _mm256_loadu_ps(c[i] + j + 8);
+    }
+    const float* wp = w + j;
+    for (int p = 0; p < k; p++, wp += ldw) {
+      __m256 w0 = _mm256_loadu_ps(wp);
+      __m256 w1 = _mm256_loadu_ps(wp + 8);
+      for (int i = 0; i < MR; i++) {
+        __m256 va = _mm256_broadcast_ss(a[i] + p);
+        acc0[i] = Fmadd(va, w0, acc0[i]);
+        acc1[i] = Fmadd(va, w1, acc1[i]);
+      }
+    }
+    for (int i = 0; i < MR; i++) {
+      _mm256_storeu_ps(c[i] + j, acc0[i]);
+      _mm256_storeu_ps(c[i] + j + 8, acc1[i]);
+    }
+  }
+  for (; j + 8 <= n; j += 8) {
+    __m256 acc[MR];
+    for (int i = 0; i < MR; i++) {
+      acc[i] = _mm256_loadu_ps(c[i] + j);
+    }
+    const float* wp = w + j;
+    for (int p = 0; p < k; p++, wp += ldw) {
+      __m256 w0 = _mm256_loadu_ps(wp);
+      for (int i = 0; i < MR; i++) {
+        acc[i] = Fmadd(_mm256_broadcast_ss(a[i] + p), w0, acc[i]);
+      }
+    }
+    for (int i = 0; i < MR; i++) {
+      _mm256_storeu_ps(c[i] + j, acc[i]);
+    }
+  }
+#endif
+  if (j == n) return;
+  for (int i = 0; i < MR; i++) {
+    for (int p = 0; p < k; p++) {
+      float ap = a[i][p];
+      const float* wp = w + p * ldw;
+      for (int q = j; q < n; q++) {
+        c[i][q] += ap * wp[q];
+      }
+    }
+  }
+}
+
+void GemmAcc(const float* const* a,
+             float* const* c,
+             int m,
+             const float* w,
+             int k,
+             int n,
+             int ldw) {
+  for (int i = 0; i < m; i += 4) {
+    switch (std::min(4, m - i)) {
+      case 4:
+        GemmAccKernel<4>(a + i, c + i, w, k, n, ldw);
+        break;
+      case 3:
+        GemmAccKernel<3>(a + i, c + i, w, k, n, ldw);
+        break;
+      case 2:
+        GemmAccKernel<2>(a + i, c + i, w, k, n, ldw);
+        break;
+      default:
+        GemmAccKernel<1>(a + i, c + i, w, k, n, ldw);
+        break;
+    }
+  }
+}
+
+void Activate(float* x, int n, detail::ActivationType act) {
+  int i = 0;
+#ifdef __AVX__
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(x + i,
+                     detail::forward::activation(_mm256_loadu_ps(x + i), act));
+  }
+#endif
+  for (; i < n; i++) {
+    x[i] = detail::forward::activation(x[i], act);
+  }
+}
+
+// The sequences are sorted by length in descending order and split into the
+// blocks processed by the threads.
+struct SequenceBlocks {
+  explicit SequenceBlocks(const std::vector<uint64_t>& lod)
+      : order(lod.size() - 1) {
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+      return lod[a + 1] - lod[a] > lod[b + 1] - lod[b];
+    });
+    int num_seqs = static_cast<int>(order.size());
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_in_parallel() ? 1 : omp_get_max_threads();
+#endif
+    block_size = (num_seqs + threads - 1) / std::max(threads, 1);
+    block_size = std::max(1, std::min(kMaxBlockSize, block_size));
+    num_blocks = (num_seqs + block_size - 1) / block_size;
+  }
+
+  std::vector<int> order;
+  int block_size{1};
+  int num_blocks{0};
+};
+
+}  // namespace
+
+void FusedGRU(const std::vector<uint64_t>& lod,
+              const float* h0,
+              const float* weight,
+              int frame_size,
+              bool is_reverse,
+              bool origin_mode,
+              detail::ActivationType active_node,
+              detail::ActivationType active_gate,
+              float* gate,
+              float* reset_hidden_prev,
+              float* hidden) {
+  const int d = frame_size;
+  const float* gate_weight = weight;
+  const float* state_weight = weight + 2 * d * d;
+  SequenceBlocks blocks(lod);
+  int num_seqs = static_cast<int>(blocks.order.size());
+#pragma omp parallel for
+  for (int b = 0; b < blocks.num_blocks; b++) {
+    const int* seqs = blocks.order.data() + b * blocks.block_size;
+    int m = std::min(blocks.block_size, num_seqs - b * blocks.block_size);
+    const float* prev[kMaxBlockSize];
+    float* gates[kMaxBlockSize];
+    float* states[kMaxBlockSize];
+    float* resets[kMaxBlockSize];
+    int64_t rows[kMaxBlockSize];
+    int64_t max_len = lod[seqs[0] + 1] - lod[seqs[0]];
+    for (int64_t t = 0; t < max_len; t++) {
+      int active = 0;
+      for (; active < m; active++) {
+        int s = seqs[active];
+        int64_t len = lod[s + 1] - lod[s];
+        if (len <= t) break;
+        int64_t row = lod[s] + (is_reverse ? len - 1 - t : t);
+        if (t == 0) {
+          prev[active] = h0 ? h0 + s * d : nullptr;
+        } else {
+          prev[active] = hidden + (row + (is_reverse ? 1 : -1)) * d;
+        }
+        gates[active] = gate + row * 3 * d;
+        states[active] = gates[active] + 2 * d;
+        resets[active] = reset_hidden_prev + row * d;
+        rows[active] = row;
+      }
+      bool has_prev = prev[0] != nullptr;
+      if (has_prev) {
+        GemmAcc(prev, gates, active, gate_weight, d, 2 * d, 2 * d);
+      }
+      for (int i = 0; i < active; i++) {
+        Activate(gates[i], 2 * d, active_gate);
+        const float* r = gates[i] + d;
+        for (int j = 0; j < d; j++) {
+          resets[i][j] = has_prev ? prev[i][j] * r[j] : 0.f;
+        }
+      }
+      if (has_prev) {
+        GemmAcc(resets, states, active, state_weight, d, d, d);
+      }
+      for (int i = 0; i < active; i++) {
+        Activate(states[i], d, active_node);
+        const float* u = gates[i];
+        const float* c = states[i];
+        float* h = hidden + rows[i] * d;
+        for (int j = 0; j < d; j++) {
+          float p = has_prev ? prev[i][j] : 0.f;
+          h[j] = origin_mode ? u[j] * p + c[j] - u[j] * c[j]
+                             : p - u[j] * p + u[j] * c[j];
+        }
+      }
+    }
+  }
+}
+
+void FusedLSTM(const std::vector<uint64_t>& lod,
+               const float* h0,
+               const float* c0,
+               const float* weight,
+               const float* check,
+               int frame_size,
+               bool is_reverse,
+               detail::ActivationType active_gate,
+               detail::ActivationType active_cell,
+               detail::ActivationType active_cand,
+               float* gate,
+               float* cell_pre_act,
+               float* hidden,
+               float* cell) {
+  const int d = frame_size;
+  SequenceBlocks blocks(lod);
+  int num_seqs = static_cast<int>(blocks.order.size());
+#pragma omp parallel for
+  for (int b = 0; b < blocks.num_blocks; b++) {
+    const int* seqs = blocks.order.data() + b * blocks.block_size;
+    int m = std::min(blocks.block_size, num_seqs - b * blocks.block_size);
+    const float* prev_h[kMaxBlockSize];
+    const float* prev_c[kMaxBlockSize];
+    float* gates[kMaxBlockSize];
+    int64_t rows[kMaxBlockSize];
+    int64_t max_len = lod[seqs[0] + 1] - lod[seqs[0]];
+    for (int64_t t = 0; t < max_len; t++) {
+      int active = 0;
+      for (; active < m; active++) {
+        int s = seqs[active];
+        int64_t len = lod[s + 1] - lod[s];
+        if (len <= t) break;
+        int64_t row = lod[s] + (is_reverse ? len - 1 - t : t);
+        if (t == 0) {
+          prev_h[active] = h0 ? h0 + s * d : nullptr;
+          prev_c[active] = c0 ? c0 + s * d : nullptr;
+        } else {
+          int64_t prev_row = row + (is_reverse ? 1 : -1);
+          prev_h[active] = hidden + prev_row * d;
+          prev_c[active] = cell + prev_row * d;
+        }
+        gates[active] = gate + row * 4 * d;
+        rows[active] = row;
+      }
+      if (prev_h[0]) {
+        GemmAcc(prev_h, gates, active, weight, d, 4 * d, 4 * d);
+      }
+      for (int i = 0; i < active; i++) {
+        float* in = gates[i];
+        float* ig = in + d;
+        float* fg = ig + d;
+        float* og = fg + d;
+        const float* pc = prev_c[i];
+        float* c = cell + rows[i] * d;
+        float* c_act = cell_pre_act + rows[i] * d;
+        float* h = hidden + rows[i] * d;
+        Activate(in, d, active_cand);
+        if (check && pc) {
+          for (int j = 0; j < d; j++) {
+            ig[j] += pc[j] * check[j];
+            fg[j] += pc[j] * check[d + j];
+          }
+        }
+        Activate(ig, d, active_gate);
+        Activate(fg, d, active_gate);
+        for (int j = 0; j < d; j++) {
+          c[j] = in[j] * ig[j] + (pc ? pc[j] * fg[j] : 0.f);
+        }
+        if (check) {
+          for (int j = 0; j < d; j++) {
+            og[j] += c[j] * check[2 * d + j];
+          }
+        }
+        Activate(og, d, active_gate);
+        std::copy(c, c + d, c_act);
+        Activate(c_act, d, active_cell);
+        for (int j = 0; j < d; j++) {
+          h[j] = og[j] * c_act[j];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,79 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "lite/backends/x86/math/detail/activation_functions.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The recurrent parts of gru and lstm computed over the sequences of the LoD
+ * in place, without reordering them into the time-major batches. The input
+ * projections of all of the time steps, i.e. the rows of `gate`, are computed
+ * in advance as one GEMM by the preceding fc or mul. The sequences are sorted
+ * by length and processed in blocks in parallel, each step of a block
+ * multiplies the hidden states of its sequences with the recurrent weights
+ * panel by panel, so that a panel is loaded once for all of the sequences of
+ * the block and the weights stay in the cache of the thread across the steps.
+ */
+
+// gate: [T, 3D] of the projections with the bias added, the update, reset
+// gates and the candidate are activated in place.
+// weight: [D, 2D] of the update and reset gates followed by [D, D] of the
+// candidate, which is the layout of the gru op.
+// h0: [num_sequences, D] or null for zeros.
+// reset_hidden_prev, hidden: [T, D].
+void FusedGRU(const std::vector<uint64_t>& lod,
+              const float* h0,
+              const float* weight,
+              int frame_size,
+              bool is_reverse,
+              bool origin_mode,
+              detail::ActivationType active_node,
+              detail::ActivationType active_gate,
+              float* gate,
+              float* reset_hidden_prev,
+              float* hidden);
+
+// gate: [T, 4D] of the projections with the bias added in the order of the
+// candidate, input, forget and output gates, which are activated in place.
+// weight: [D, 4D].
+// check: the peephole weights [3D] of the input, forget and output gates or
+// null.
+// h0, c0: [num_sequences, D] or null for zeros.
+// cell_pre_act, hidden, cell: [T, D].
+void FusedLSTM(const std::vector<uint64_t>& lod,
+               const float* h0,
+               const float* c0,
+               const float* weight,
+               const float* check,
+               int frame_size,
+               bool is_reverse,
+               detail::ActivationType active_gate,
+               detail::ActivationType active_cell,
+               detail::ActivationType active_cand,
+               float* gate,
+               float* cell_pre_act,
+               float* hidden,
+               float* cell);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,325 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sparse_gemm.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <functional>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+using lite_api::ActivationType;
+
+// The columns of Y are processed in the tiles of 8 * kTileVectors floats, so
+// that the columns of X in a tile stay in the L1 cache while all of the rows
+// of blocks of a thread are multiplied with them.
+const int kTileVectors = 2;
+
+inline float activate(const float x, const ActivationType act) {
+  if (act == ActivationType::kRelu) {
+    return std::max(x, 0.f);
+  } else if (act == ActivationType::kRelu6) {
+    return std::min(std::max(x, 0.f), 6.f);
+  }
+  return x;
+}
+
+#ifdef __AVX2__
+inline __m256 fmadd_ps(const __m256 a, const __m256 b, const __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+inline __m256 activate(const __m256 x, const ActivationType act) {
+  if (act == ActivationType::kRelu) {
+    return _mm256_max_ps(x, _mm256_setzero_ps());
+  } else if (act == ActivationType::kRelu6) {
+    return _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()),
+                         _mm256_set1_ps(6.f));
+  }
+  return x;
+}
+
+// Y[0 : R, 0 : 8 * NV] of the ib-th row of blocks, the columns of X and Y
+// are contiguous. The accumulators are kept in the registers, each element of
+// a block is broadcasted once and multiplied with NV vectors of X.
+template <int R, int C, int NV>
+inline void sparse_tile(const BlockSparseMatrix& S,
+                        const int64_t ib,
+                        const float* X,
+                        const int64_t ldx,
+                        const float* bias,
+                        const ActivationType act,
+                        float* Y,
+                        const int64_t y_row_stride,
+                        const int64_t y_col_stride) {
+  __m256 acc[R][NV];
+  for (int r = 0; r < R; r++) {
+    __m256 b = bias ? _mm256_set1_ps(bias[r]) : _mm256_setzero_ps();
+    for (int v = 0; v < NV; v++) {
+      acc[r][v] = b;
+    }
+  }
+  const int32_t begin = S.row_offset[ib];
+  const int32_t end = S.row_offset[ib + 1];
+  const float* w = S.values + static_cast<int64_t>(begin) * R * C;
+  for (int32_t p = begin; p < end; p++, w += R * C) {
+    const float* x = X + static_cast<int64_t>(S.col_index[p]) * ldx;
+    for (int c = 0; c < C; c++, x += ldx) {
+      __m256 xv[NV];
+      for (int v = 0; v < NV; v++) {
+        xv[v] = _mm256_loadu_ps(x + 8 * v);
+      }
+      for (int r = 0; r < R; r++) {
+        __m256 wv = _mm256_broadcast_ss(w + r * C + c);
+        for (int v = 0; v < NV; v++) {
+          acc[r][v] = fmadd_ps(wv, xv[v], acc[r][v]);
+        }
+      }
+    }
+  }
+  for (int r = 0; r < R; r++) {
+    float* y = Y + r * y_row_stride;
+    for (int v = 0; v < NV; v++) {
+      __m256 out = activate(acc[r][v], act);
+      if (y_col_stride == 1) {
+        _mm256_storeu_ps(y + 8 * v, out);
+      } else {
+        float tmp[8];
+        _mm256_storeu_ps(tmp, out);
+        for (int l = 0; l < 8; l++) {
+          y[(8 * v + l) * y_col_stride] = tmp[l];
+        }
+      }
+    }
+  }
+}
+#endif
+
+// Y[0 : R, 0] of the ib-th row of blocks, X[:, 0] is strided by ldx.
+template <int R, int C>
+inline void sparse_column(const BlockSparseMatrix& S,
+                          const int64_t ib,
+                          const float* X,
+                          const int64_t ldx,
+                          const float* bias,
+                          const ActivationType act,
+                          float* Y,
+                          const int64_t y_row_stride) {
+  float acc[R];
+  for (int r = 0; r < R; r++) {
+    acc[r] = bias ? bias[r] : 0.f;
+  }
+  const int32_t begin = S.row_offset[ib];
+  const int32_t end = S.row_offset[ib + 1];
+  const float* w = S.values + static_cast<int64_t>(begin) * R * C;
+  int32_t p = begin;
+#ifdef __AVX2__
+  // The dot products of the rows of 4 elements with the contiguous X, which
+  // is the fc of a few rows.
+  if (C == 4 && ldx == 1) {
+    __m128 acc4[R];
+    for (int r = 0; r < R; r++) {
+      acc4[r] = _mm_setzero_ps();
+    }
+    for (; p < end; p++, w += R * C) {
+      __m128 xv = _mm_loadu_ps(X + S.col_index[p]);
+      for (int r = 0; r < R; r++) {
+        acc4[r] = _mm_add_ps(acc4[r], _mm_mul_ps(_mm_loadu_ps(w + r * C), xv));
+      }
+    }
+    for (int r = 0; r < R; r++) {
+      __m128 sum = _mm_hadd_ps(acc4[r], acc4[r]);
+      sum = _mm_hadd_ps(sum, sum);
+      acc[r] += _mm_cvtss_f32(sum);
+    }
+  }
+#endif
+  for (; p < end; p++) {
+    const float* x = X + static_cast<int64_t>(S.col_index[p]) * ldx;
+    for (int c = 0; c < C; c++) {
+      for (int r = 0; r < R; r++) {
+        acc[r] += w[r * C + c] * x[c * ldx];
+      }
+    }
+    w += R * C;
+  }
+  for (int r = 0; r < R; r++) {
+    Y[r * y_row_stride] = activate(acc[r], act);
+  }
+}
+
+// Y = act(S * X + bias), the elements of X and Y are addressed by the
+// strides, only the contiguous columns are vectorized.
+template <int R, int C>
+void block_sparse_gemm_impl(const BlockSparseMatrix& S,
+                            const int N,
+                            const float* X,
+                            const int64_t x_row_stride,
+                            const int64_t x_col_stride,
+                            const float* bias,
+                            const ActivationType act,
+                            float* Y,
+                            const int64_t y_row_stride,
+                            const int64_t y_col_stride) {
+  const int64_t block_rows = S.rows / R;
+  RunParallelFor(0, block_rows, [&](int64_t begin, int64_t end) {
+    int j = 0;
+#ifdef __AVX2__
+    if (x_col_stride == 1) {
+      const int tile = 8 * kTileVectors;
+      for (; j + tile <= N; j += tile) {
+        for (int64_t ib = begin; ib < end; ib++) {
+          sparse_tile<R, C, kTileVectors>(
+              S,
+              ib,
+              X + j,
+              x_row_stride,
+              bias ? bias + ib * R : nullptr,
+              act,
+              Y + ib * R * y_row_stride + j * y_col_stride,
+              y_row_stride,
+              y_col_stride);
+        }
+      }
+      for (; j + 8 <= N; j += 8) {
+        for (int64_t ib = begin; ib < end; ib++) {
+          sparse_tile<R, C, 1>(S,
+                               ib,
+                               X + j,
+                               x_row_stride,
+                               bias ? bias + ib * R : nullptr,
+                               act,
+                               Y + ib * R * y_row_stride + j * y_col_stride,
+                               y_row_stride,
+                               y_col_stride);
+        }
+      }
+    }
+#endif
+    for (; j < N; j++) {
+      for (int64_t ib = begin; ib < end; ib++) {
+        sparse_column<R, C>(S,
+                            ib,
+                            X + j * x_col_stride,
+                            x_row_stride,
+                            bias ? bias + ib * R : nullptr,
+                            act,
+                            Y + ib * R * y_row_stride + j * y_col_stride,
+                            y_row_stride);
+      }
+    }
+  });
+}
+
+void block_sparse_gemm_strided(const BlockSparseMatrix& S,
+                               const int N,
+                               const float* X,
+                               const int64_t x_row_stride,
+                               const int64_t x_col_stride,
+                               const float* bias,
+                               const ActivationType act,
+                               float* Y,
+                               const int64_t y_row_stride,
+                               const int64_t y_col_stride) {
+  CHECK(act == ActivationType::kIndentity || act == ActivationType::kRelu ||
+        act == ActivationType::kRelu6)
+      << "Unsupported activation of block_sparse_gemm.";
+  CHECK_EQ(S.rows % S.block_rows, 0);
+  CHECK_EQ(S.cols % S.block_cols, 0);
+#define BLOCK_SPARSE_GEMM(R, C)                              \
+  if (S.block_rows == R && S.block_cols == C) {              \
+    return block_sparse_gemm_impl<R, C>(S,                   \
+                                        N,                   \
+                                        X,                   \
+                                        x_row_stride,        \
+                                        x_col_stride,        \
+                                        bias,                \
+                                        act,                 \
+                                        Y,                   \
+                                        y_row_stride,        \
+                                        y_col_stride);       \
+  }
+  BLOCK_SPARSE_GEMM(1, 1);
+  BLOCK_SPARSE_GEMM(1, 4);
+  BLOCK_SPARSE_GEMM(4, 1);
+  BLOCK_SPARSE_GEMM(4, 4);
+#undef BLOCK_SPARSE_GEMM
+  LOG(FATAL) << "Unsupported block shape " << S.block_rows << "x"
+             << S.block_cols;
+}
+
+}  // namespace
+
+void block_sparse_gemm(const BlockSparseMatrix& S,
+                       const int N,
+                       const float* X,
+                       const int ldx,
+                       const float* bias,
+                       const ActivationType act,
+                       float* Y,
+                       const int ldy) {
+  block_sparse_gemm_strided(S, N, X, ldx, 1, bias, act, Y, ldy, 1);
+}
+
+size_t block_sparse_gemm_trans_workspace_size(const int M, const int cols) {
+#ifdef __AVX2__
+  if (M >= 8) {
+    return static_cast<size_t>(M) * cols * sizeof(float);
+  }
+#endif
+  return 0;
+}
+
+void block_sparse_gemm_trans(const int M,
+                             const float* X,
+                             const BlockSparseMatrix& S,
+                             const float* bias,
+                             const ActivationType act,
+                             float* Y,
+                             void* workspace) {
+  // The columns of Y^T = S * X^T are the rows of X, they are strided unless X
+  // is transposed, which is worth it when the columns can be vectorized.
+  if (block_sparse_gemm_trans_workspace_size(M, S.cols) == 0) {
+    block_sparse_gemm_strided(S, M, X, 1, S.cols, bias, act, Y, 1, S.rows);
+    return;
+  }
+  CHECK(workspace) << "The workspace of block_sparse_gemm is not allocated.";
+  auto* x_trans = static_cast<float*>(workspace);
+  RunParallelFor(0, S.cols, [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; k++) {
+      for (int m = 0; m < M; m++) {
+        x_trans[k * M + m] = X[static_cast<int64_t>(m) * S.cols + k];
+      }
+    }
+  });
+  block_sparse_gemm_strided(S, M, x_trans, M, 1, bias, act, Y, 1, S.rows);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
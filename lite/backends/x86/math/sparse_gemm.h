@@ -0,0 +1,72 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "lite/api/paddle_place.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The weight converted by sparse_weight_convert_pass. The matrix of
+// rows x cols is divided into the blocks of block_rows x block_cols, and the
+// non-zero blocks are stored row of blocks by row of blocks:
+// - values: the elements of the blocks, each block is in row major,
+// - col_index: the first column of each block,
+// - row_offset: the i-th row of blocks is [row_offset[i], row_offset[i + 1])
+//   of the blocks.
+// rows and cols are multiples of block_rows and block_cols, which are 1 or 4.
+struct BlockSparseMatrix {
+  int rows{0};
+  int cols{0};
+  int block_rows{1};
+  int block_cols{1};
+  const float* values{nullptr};
+  const int32_t* col_index{nullptr};
+  const int32_t* row_offset{nullptr};
+};
+
+// Y = act(S * X + bias), X is a matrix of cols x N and Y is a matrix of
+// rows x N, both are in row major, e.g. the 1x1 conv2d in NCHW. bias is of
+// rows and optional, act is kIndentity, kRelu or kRelu6.
+void block_sparse_gemm(const BlockSparseMatrix& S,
+                       const int N,
+                       const float* X,
+                       const int ldx,
+                       const float* bias,
+                       const lite_api::ActivationType act,
+                       float* Y,
+                       const int ldy);
+
+// The bytes of the workspace needed by block_sparse_gemm_trans to transpose
+// the M x cols matrix X.
+size_t block_sparse_gemm_trans_workspace_size(const int M, const int cols);
+
+// Y = act(X * S^T + bias), X is a matrix of M x cols and Y is a matrix of
+// M x rows, both are in row major, e.g. the fc whose weight is S^T.
+void block_sparse_gemm_trans(const int M,
+                             const float* X,
+                             const BlockSparseMatrix& S,
+                             const float* bias,
+                             const lite_api::ActivationType act,
+                             float* Y,
+                             void* workspace);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,398 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/weight_only_gemm.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/bfloat16.h"
+#include "lite/utils/cp_logging.h"
+#include "lite/utils/float16.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The rows of X multiplied by streaming the weight instead of blas.
+const int kStreamMaxRows = 4;
+// The columns of Y accumulated by a thread in the streaming path.
+const int kStreamBlock = 256;
+// The fp32 tile of the weight is at most 256 x 256, i.e. 256KB, so that it's
+// still in the L2 cache when blas reads it.
+const int kTileSize = 256;
+
+inline float to_float(const int8_t x) { return x; }
+inline float to_float(const int16_t x) { return x; }
+inline float to_float(const lite::float16 x) { return static_cast<float>(x); }
+inline float to_float(const lite::bfloat16 x) { return static_cast<float>(x); }
+
+#ifdef __AVX2__
+inline __m256 load8_ps(const int8_t* x) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(x))));
+}
+
+inline __m256 load8_ps(const int16_t* x) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(x))));
+}
+
+// bf16 is the high half of fp32.
+inline __m256 load8_ps(const lite::bfloat16* x) {
+  return _mm256_castsi256_ps(_mm256_slli_epi32(
+      _mm256_cvtepu16_epi32(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(x))),
+      16));
+}
+
+#ifdef __F16C__
+inline __m256 load8_ps(const lite::float16* x) {
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+}
+#else
+inline __m256 load8_ps(const lite::float16* x) {
+  float y[8];
+  for (int i = 0; i < 8; i++) {
+    y[i] = static_cast<float>(x[i]);
+  }
+  return _mm256_loadu_ps(y);
+}
+#endif
+#endif
+
+// y[i] = x[i] * scale[i]
+template <typename T>
+inline void dequantize_row(const T* x,
+                           const float* scale,
+                           const int n,
+                           float* y) {
+  int i = 0;
+#ifdef __AVX2__
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(
+        y + i, _mm256_mul_ps(load8_ps(x + i), _mm256_loadu_ps(scale + i)));
+  }
+#endif
+  for (; i < n; i++) {
+    y[i] = to_float(x[i]) * scale[i];
+  }
+}
+
+// y[i] = x[i] * scale
+template <typename T>
+inline void dequantize_row(const T* x,
+                           const float scale,
+                           const int n,
+                           float* y) {
+  int i = 0;
+#ifdef __AVX2__
+  __m256 vscale = _mm256_set1_ps(scale);
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(y + i, _mm256_mul_ps(load8_ps(x + i), vscale));
+  }
+#endif
+  for (; i < n; i++) {
+    y[i] = to_float(x[i]) * scale;
+  }
+}
+
+// y[i] += a * x[i]
+template <typename T>
+inline void axpy_row(const float a, const T* x, const int n, float* y) {
+  int i = 0;
+#ifdef __AVX2__
+  __m256 va = _mm256_set1_ps(a);
+  for (; i + 8 <= n; i += 8) {
+#ifdef __FMA__
+    _mm256_storeu_ps(
+        y + i, _mm256_fmadd_ps(va, load8_ps(x + i), _mm256_loadu_ps(y + i)));
+#else
+    _mm256_storeu_ps(y + i,
+                     _mm256_add_ps(_mm256_loadu_ps(y + i),
+                                   _mm256_mul_ps(va, load8_ps(x + i))));
+#endif
+  }
+#endif
+  for (; i < n; i++) {
+    y[i] += a * to_float(x[i]);
+  }
+}
+
+// The weight is read once for all of the rows of X, and the partial sums of a
+// block of columns are kept in the L1 cache.
+template <typename T>
+void weight_only_gemm_stream(const int M,
+                             const int N,
+                             const int K,
+                             const float* X,
+                             const int ldx,
+                             const T* weight,
+                             const int ldw,
+                             const float* scale,
+                             float* Y,
+                             const int ldy) {
+  const int64_t blocks = (N + kStreamBlock - 1) / kStreamBlock;
+  RunParallelFor(0, blocks, [&](int64_t begin, int64_t end) {
+    float acc[kStreamMaxRows * kStreamBlock];
+    for (int64_t b = begin; b < end; b++) {
+      const int n0 = static_cast<int>(b) * kStreamBlock;
+      const int nb = std::min(kStreamBlock, N - n0);
+      memset(acc, 0, sizeof(float) * M * kStreamBlock);
+      for (int k = 0; k < K; k++) {
+        const T* w = weight + static_cast<int64_t>(k) * ldw + n0;
+        for (int m = 0; m < M; m++) {
+          const float x = X[static_cast<int64_t>(m) * ldx + k];
+          if (x != 0.f) {
+            axpy_row(x, w, nb, acc + m * kStreamBlock);
+          }
+        }
+      }
+      for (int m = 0; m < M; m++) {
+        float* y = Y + static_cast<int64_t>(m) * ldy + n0;
+        const float* a = acc + m * kStreamBlock;
+        for (int n = 0; n < nb; n++) {
+          y[n] = a[n] * scale[n0 + n];
+        }
+      }
+    }
+  });
+}
+
+template <typename T>
+void weight_only_gemm_impl(const lite::X86Context& context,
+                           const int M,
+                           const int N,
+                           const int K,
+                           const float* X,
+                           const int ldx,
+                           const T* weight,
+                           const int ldw,
+                           const float* scale,
+                           float* Y,
+                           const int ldy,
+                           void* workspace) {
+  if (M <= kStreamMaxRows) {
+    weight_only_gemm_stream(M, N, K, X, ldx, weight, ldw, scale, Y, ldy);
+    return;
+  }
+  CHECK(workspace) << "The workspace of weight_only_gemm is not allocated.";
+  auto blas = GetBlas<lite::TargetType::kX86, float>(context);
+  auto* tile = static_cast<float*>(workspace);
+  for (int n0 = 0; n0 < N; n0 += kTileSize) {
+    const int nb = std::min(kTileSize, N - n0);
+    for (int k0 = 0; k0 < K; k0 += kTileSize) {
+      const int kb = std::min(kTileSize, K - k0);
+      RunParallelFor(0, kb, [&](int64_t begin, int64_t end) {
+        for (int64_t k = begin; k < end; k++) {
+          dequantize_row(weight + (k0 + k) * ldw + n0,
+                         scale + n0,
+                         nb,
+                         tile + k * nb);
+        }
+      });
+      blas.GEMM(false,
+                false,
+                M,
+                nb,
+                kb,
+                1.f,
+                X + k0,
+                ldx,
+                tile,
+                nb,
+                k0 == 0 ? 0.f : 1.f,
+                Y + n0,
+                ldy);
+    }
+  }
+}
+
+template <typename T>
+void weight_only_gemm_row_scale_impl(const lite::X86Context& context,
+                                     const int M,
+                                     const int N,
+                                     const int K,
+                                     const T* weight,
+                                     const float* scale,
+                                     const float* X,
+                                     float* Y,
+                                     void* workspace) {
+  CHECK(workspace) << "The workspace of weight_only_gemm is not allocated.";
+  auto blas = GetBlas<lite::TargetType::kX86, float>(context);
+  auto* tile = static_cast<float*>(workspace);
+  for (int m0 = 0; m0 < M; m0 += kTileSize) {
+    const int mb = std::min(kTileSize, M - m0);
+    for (int k0 = 0; k0 < K; k0 += kTileSize) {
+      const int kb = std::min(kTileSize, K - k0);
+      RunParallelFor(0, mb, [&](int64_t begin, int64_t end) {
+        for (int64_t m = begin; m < end; m++) {
+          dequantize_row(weight + (m0 + m) * K + k0,
+                         scale[m0 + m],
+                         kb,
+                         tile + m * kb);
+        }
+      });
+      blas.GEMM(false,
+                false,
+                mb,
+                N,
+                kb,
+                1.f,
+                tile,
+                kb,
+                X + static_cast<int64_t>(k0) * N,
+                N,
+                k0 == 0 ? 0.f : 1.f,
+                Y + static_cast<int64_t>(m0) * N,
+                N);
+    }
+  }
+}
+
+template <typename T>
+void weight_only_lookup_table_impl(const T* table,
+                                   const float* scale,
+                                   const int64_t row_number,
+                                   const int64_t row_width,
+                                   const int64_t* ids,
+                                   const int64_t ids_numel,
+                                   const int64_t padding_idx,
+                                   float* out) {
+  for (int64_t i = 0; i < ids_numel; ++i) {
+    float* row = out + i * row_width;
+    if (padding_idx != -1 && ids[i] == padding_idx) {
+      memset(row, 0, row_width * sizeof(float));
+      continue;
+    }
+    CHECK_LT(ids[i], row_number);
+    CHECK_GE(ids[i], 0);
+    dequantize_row(table + ids[i] * row_width, scale, row_width, row);
+  }
+}
+
+}  // namespace
+
+size_t weight_only_gemm_workspace_size(const int rows, const int cols) {
+  return static_cast<size_t>(std::min(rows, kTileSize)) *
+         std::min(cols, kTileSize) * sizeof(float);
+}
+
+// Run the statement with T defined as the storage type of the weight.
+#define WEIGHT_ONLY_DISPATCH(type, ...)    \
+  switch (type) {                          \
+    case WeightOnlyType::kInt8: {          \
+      typedef int8_t T;                    \
+      __VA_ARGS__;                         \
+    } break;                               \
+    case WeightOnlyType::kInt16: {         \
+      typedef int16_t T;                   \
+      __VA_ARGS__;                         \
+    } break;                               \
+    case WeightOnlyType::kFP16: {          \
+      typedef lite::float16 T;             \
+      __VA_ARGS__;                         \
+    } break;                               \
+    case WeightOnlyType::kBF16: {          \
+      typedef lite::bfloat16 T;            \
+      __VA_ARGS__;                         \
+    } break;                               \
+    default:                               \
+      LOG(FATAL) << "Unsupported weight."; \
+  }
+
+void weight_only_gemm(const lite::X86Context& context,
+                      const int M,
+                      const int N,
+                      const int K,
+                      const float* X,
+                      const int ldx,
+                      const lite::Tensor& weight,
+                      const WeightOnlyType type,
+                      const int ldw,
+                      const float* scale,
+                      float* Y,
+                      const int ldy,
+                      void* workspace) {
+  WEIGHT_ONLY_DISPATCH(type,
+                       weight_only_gemm_impl(context,
+                                             M,
+                                             N,
+                                             K,
+                                             X,
+                                             ldx,
+                                             weight.data<T>(),
+                                             ldw,
+                                             scale,
+                                             Y,
+                                             ldy,
+                                             workspace));
+}
+
+void weight_only_gemm_row_scale(const lite::X86Context& context,
+                                const int M,
+                                const int N,
+                                const int K,
+                                const lite::Tensor& weight,
+                                const WeightOnlyType type,
+                                const int64_t offset,
+                                const float* scale,
+                                const float* X,
+                                float* Y,
+                                void* workspace) {
+  WEIGHT_ONLY_DISPATCH(type,
+                       weight_only_gemm_row_scale_impl(context,
+                                                       M,
+                                                       N,
+                                                       K,
+                                                       weight.data<T>() +
+                                                           offset,
+                                                       scale,
+                                                       X,
+                                                       Y,
+                                                       workspace));
+}
+
+void weight_only_lookup_table(const lite::Tensor& table,
+                              const WeightOnlyType type,
+                              const float* scale,
+                              const int64_t row_number,
+                              const int64_t row_width,
+                              const int64_t* ids,
+                              const int64_t ids_numel,
+                              const int64_t padding_idx,
+                              float* out) {
+  WEIGHT_ONLY_DISPATCH(type,
+                       weight_only_lookup_table_impl(table.data<T>(),
+                                                     scale,
+                                                     row_number,
+                                                     row_width,
+                                                     ids,
+                                                     ids_numel,
+                                                     padding_idx,
+                                                     out));
+}
+
+#undef WEIGHT_ONLY_DISPATCH
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
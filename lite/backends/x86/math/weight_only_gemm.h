@@ -0,0 +1,112 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The storage types of the weight kept by post_quant_dynamic_pass. The fp16
+// and bf16 weights are converted to fp32 in the loads, and their scales are
+// all ones.
+enum class WeightOnlyType { kInt8, kInt16, kFP16, kBF16 };
+
+// Whether the weight is kept in int8, int16, fp16 or bf16 with the
+// per-channel scales by post_quant_dynamic_pass, and should be run by the
+// weight-only kernels below.
+inline bool is_weight_only_quantized(const lite::Tensor& weight,
+                                     const std::vector<float>& scale) {
+  return !scale.empty() && (weight.precision() == PRECISION(kInt8) ||
+                            weight.precision() == PRECISION(kInt16) ||
+                            weight.precision() == PRECISION(kFP16));
+}
+
+// The storage type of the weight, `quant_type` is the quantization_type attr
+// of the op. There is no bf16 precision, so the bf16 weight is held by the
+// int16 tensor and told by "post_weight_bf16".
+inline WeightOnlyType get_weight_only_type(const lite::Tensor& weight,
+                                           const std::string& quant_type) {
+  if (weight.precision() == PRECISION(kInt8)) {
+    return WeightOnlyType::kInt8;
+  } else if (weight.precision() == PRECISION(kFP16)) {
+    return WeightOnlyType::kFP16;
+  }
+  return quant_type == "post_weight_bf16" ? WeightOnlyType::kBF16
+                                          : WeightOnlyType::kInt16;
+}
+
+// The bytes of the workspace needed by weight_only_gemm and
+// weight_only_gemm_row_scale to hold a dequantized tile of the weight, which
+// is a matrix of rows x cols, i.e. K x N or M x K.
+size_t weight_only_gemm_workspace_size(const int rows, const int cols);
+
+// Y[M, N] = X[M, K] * W[K, N], W is quantized per column, i.e. the element
+// (k, n) of W is weight[k * ldw + n] * scale[n]. The weight is never
+// dequantized as a whole: for a few rows of X, it's streamed once and
+// multiplied on the fly, otherwise it's dequantized tile by tile into the
+// workspace and multiplied by blas, so only a tile of the fp32 weight is
+// alive at a time.
+void weight_only_gemm(const lite::X86Context& context,
+                      const int M,
+                      const int N,
+                      const int K,
+                      const float* X,
+                      const int ldx,
+                      const lite::Tensor& weight,
+                      const WeightOnlyType type,
+                      const int ldw,
+                      const float* scale,
+                      float* Y,
+                      const int ldy,
+                      void* workspace);
+
+// Y[M, N] = W[M, K] * X[K, N], W is quantized per row, i.e. the element
+// (m, k) of W is weight[offset + m * K + k] * scale[m], e.g. the filter of
+// conv, where `offset` is the element offset of the group.
+void weight_only_gemm_row_scale(const lite::X86Context& context,
+                                const int M,
+                                const int N,
+                                const int K,
+                                const lite::Tensor& weight,
+                                const WeightOnlyType type,
+                                const int64_t offset,
+                                const float* scale,
+                                const float* X,
+                                float* Y,
+                                void* workspace);
+
+// Gather and dequantize the rows of the table quantized per column, the rows
+// of padding_idx are filled with zeros.
+void weight_only_lookup_table(const lite::Tensor& table,
+                              const WeightOnlyType type,
+                              const float* scale,
+                              const int64_t row_number,
+                              const int64_t row_width,
+                              const int64_t* ids,
+                              const int64_t ids_numel,
+                              const int64_t padding_idx,
+                              float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
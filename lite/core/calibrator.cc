@@ -0,0 +1,199 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/calibrator.h"
+#include <algorithm>
+#include <cmath>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The int8 values are in [-127, 127], so the abs values fall into 128 bins.
+const int kQuantBins = 128;
+
+// Spread the counts of the merged bins evenly over the non-empty bins of the
+// reference distribution they cover.
+std::vector<double> ExpandQuantizedBins(const std::vector<double>& quantized,
+                                        const std::vector<uint64_t>& ref,
+                                        int merged) {
+  std::vector<double> expanded(ref.size(), 0.);
+  const int size = static_cast<int>(ref.size());
+  for (int q = 0; q < kQuantBins; q++) {
+    int begin = q * merged;
+    int end = q == kQuantBins - 1 ? size : begin + merged;
+    int non_empty = 0;
+    for (int i = begin; i < end; i++) {
+      non_empty += ref[i] != 0;
+    }
+    if (non_empty == 0) continue;
+    double avg = quantized[q] / non_empty;
+    for (int i = begin; i < end; i++) {
+      if (ref[i] != 0) expanded[i] = avg;
+    }
+  }
+  return expanded;
+}
+
+}  // namespace
+
+Calibrator::Calibrator(const std::string& method, float percentile)
+    : method_(method), percentile_(percentile) {
+  CHECK(method_ == "KL" || method_ == "abs_max" || method_ == "percentile")
+      << "Unsupported calibration method: " << method_;
+  CHECK(percentile_ > 0.f && percentile_ <= 1.f);
+}
+
+const std::vector<std::string>& Calibrator::VarRenamingPasses() {
+  static const std::vector<std::string> passes = {"lite_inplace_fuse_pass",
+                                                  "memory_optimize_pass"};
+  return passes;
+}
+
+void Calibrator::Observe(RuntimeProgram* program, Scope* scope, int pass) {
+  CHECK(program);
+  CHECK(scope);
+  CHECK(pass >= 0 && pass < kNumPasses);
+  // The histograms are not needed by abs_max.
+  if (pass > 0 && method_ == "abs_max") return;
+  for (auto& inst : *program->mutable_instructions(kRootBlockIdx)) {
+    inst.Run();
+    if (inst.op()->Type() == "fetch") continue;
+    // The outputs are observed right after they are written, since their
+    // buffers may be reused by the following instructions.
+    for (auto& name : inst.op()->op_info()->output_names()) {
+      auto* var = scope->FindVar(name);
+      if (!var || !var->IsType<lite::Tensor>()) continue;
+      auto& tensor = var->Get<lite::Tensor>();
+      if (tensor.precision() != PRECISION(kFloat) || tensor.numel() <= 0 ||
+          !(tensor.target() == TARGET(kHost) ||
+            tensor.target() == TARGET(kX86) ||
+            tensor.target() == TARGET(kARM))) {
+        continue;
+      }
+      Update(name, tensor.data<float>(), tensor.numel(), pass);
+    }
+  }
+}
+
+void Calibrator::Update(const std::string& name,
+                        const float* data,
+                        int64_t size,
+                        int pass) {
+  auto& stats = stats_[name];
+  if (pass == 0) {
+    for (int64_t i = 0; i < size; i++) {
+      stats.abs_max = std::max(stats.abs_max, std::fabs(data[i]));
+    }
+    return;
+  }
+  if (stats.hist.empty()) {
+    stats.hist.resize(kNumBins, 0);
+  }
+  if (stats.abs_max <= 0.f) return;
+  const float scale = kNumBins / stats.abs_max;
+  for (int64_t i = 0; i < size; i++) {
+    int bin = static_cast<int>(std::fabs(data[i]) * scale);
+    stats.hist[std::min(bin, kNumBins - 1)]++;
+  }
+}
+
+std::map<std::string, float> Calibrator::Thresholds() const {
+  std::map<std::string, float> thresholds;
+  for (auto& it : stats_) {
+    auto& stats = it.second;
+    float threshold = stats.abs_max;
+    if (method_ != "abs_max" && !stats.hist.empty() && stats.abs_max > 0.f) {
+      float bin_width = stats.abs_max / kNumBins;
+      threshold = method_ == "KL"
+                      ? KLThreshold(stats.hist, bin_width)
+                      : PercentileThreshold(stats.hist, bin_width, percentile_);
+    }
+    if (threshold > 0.f) {
+      thresholds[it.first] = threshold;
+    }
+  }
+  return thresholds;
+}
+
+float Calibrator::KLThreshold(const std::vector<uint64_t>& hist,
+                              float bin_width) {
+  const int size = static_cast<int>(hist.size());
+  CHECK_GE(size, kQuantBins);
+  double total = 0.;
+  for (auto count : hist) total += count;
+  if (total == 0.) return 0.f;
+
+  // Try to clip the histogram at each bin, the outliers are accumulated into
+  // the last bin kept, and pick the one whose distribution quantized into
+  // kQuantBins bins is the closest to the clipped one.
+  std::vector<double> suffix(size + 1, 0.);
+  for (int i = size - 1; i >= 0; i--) {
+    suffix[i] = suffix[i + 1] + hist[i];
+  }
+  double min_kl = -1.;
+  int best = size;
+  std::vector<uint64_t> ref;
+  std::vector<double> quantized(kQuantBins);
+  for (int i = kQuantBins; i <= size; i++) {
+    if (hist[i - 1] == 0) continue;
+    ref.assign(hist.begin(), hist.begin() + i);
+    const int merged = i / kQuantBins;
+    for (int q = 0; q < kQuantBins; q++) {
+      int begin = q * merged;
+      int end = q == kQuantBins - 1 ? i : begin + merged;
+      double sum = 0.;
+      for (int j = begin; j < end; j++) sum += ref[j];
+      quantized[q] = sum;
+    }
+    auto expanded = ExpandQuantizedBins(quantized, ref, merged);
+    ref[i - 1] += static_cast<uint64_t>(suffix[i]);
+    double q_total = 0.;
+    for (auto q : expanded) q_total += q;
+    double kl = 0.;
+    for (int j = 0; j < i; j++) {
+      if (ref[j] == 0) continue;
+      double p = ref[j] / total;
+      // The bins absent from the quantized distribution are smoothed.
+      double q = std::max(expanded[j] / q_total, 1e-10);
+      kl += p * std::log(p / q);
+    }
+    if (min_kl < 0. || kl < min_kl) {
+      min_kl = kl;
+      best = i;
+    }
+  }
+  return std::min(best + 0.5f, static_cast<float>(size)) * bin_width;
+}
+
+float Calibrator::PercentileThreshold(const std::vector<uint64_t>& hist,
+                                      float bin_width,
+                                      float percentile) {
+  double total = 0.;
+  for (auto count : hist) total += count;
+  if (total == 0.) return 0.f;
+  double sum = 0.;
+  for (size_t i = 0; i < hist.size(); i++) {
+    sum += hist[i];
+    if (sum >= percentile * total) {
+      return (i + 1) * bin_width;
+    }
+  }
+  return hist.size() * bin_width;
+}
+
+}  // namespace lite
+}  // namespace paddle
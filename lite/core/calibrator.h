@@ -0,0 +1,82 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/core/program.h"
+#include "lite/core/scope.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * Calibrator collects the statistics of the fp32 activations of a program over
+ * the calibration samples, and computes the thresholds of them for the post
+ * training static quantization, i.e. the abs values mapped to the max of int8.
+ *
+ * The samples are run kNumPasses times: the first pass finds the abs max of
+ * each activation, and the second one collects the histogram of the abs values
+ * over [0, abs max], from which the threshold minimizing the KL divergence, or
+ * the percentile of the abs values, is taken. The thresholds of abs_max are
+ * the abs max themselves.
+ */
+class Calibrator {
+ public:
+  static const int kNumPasses = 2;
+  static const int kNumBins = 2048;
+
+  // The passes renaming or sharing the activations, e.g. to reuse their
+  // memory, they should be disabled when building the program to calibrate,
+  // since the thresholds are looked up by the variable names of the model.
+  static const std::vector<std::string>& VarRenamingPasses();
+
+  // `method` is one of "KL", "abs_max" and "percentile".
+  explicit Calibrator(const std::string& method = "KL",
+                      float percentile = 0.9999f);
+
+  // Run the instructions of the root block one by one with the inputs fed,
+  // and observe the fp32 outputs of them as the sample of the pass.
+  void Observe(RuntimeProgram* program, Scope* scope, int pass);
+
+  // The thresholds of the observed activations, keyed by the variable names.
+  std::map<std::string, float> Thresholds() const;
+
+  // The thresholds computed from the histogram of the abs values with bins of
+  // `bin_width`.
+  static float KLThreshold(const std::vector<uint64_t>& hist, float bin_width);
+  static float PercentileThreshold(const std::vector<uint64_t>& hist,
+                                   float bin_width,
+                                   float percentile);
+
+ private:
+  struct Stats {
+    float abs_max{0.f};
+    std::vector<uint64_t> hist;
+  };
+
+  void Update(const std::string& name,
+              const float* data,
+              int64_t size,
+              int pass);
+
+  std::string method_;
+  float percentile_;
+  std::map<std::string, Stats> stats_;
+};
+
+}  // namespace lite
+}  // namespace paddle
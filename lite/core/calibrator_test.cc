@@ -0,0 +1,56 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/calibrator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(Calibrator, percentile) {
+  std::vector<uint64_t> hist(Calibrator::kNumBins, 1);
+  float bin_width = 0.01f;
+  float threshold = Calibrator::PercentileThreshold(hist, bin_width, 0.5f);
+  EXPECT_NEAR(threshold, Calibrator::kNumBins / 2 * bin_width, 1e-4);
+  threshold = Calibrator::PercentileThreshold(hist, bin_width, 1.f);
+  EXPECT_NEAR(threshold, Calibrator::kNumBins * bin_width, 1e-4);
+}
+
+TEST(Calibrator, kl_clips_outliers) {
+  // Most of the values are in the first quarter of the range, and there are a
+  // few outliers near the max.
+  std::vector<uint64_t> hist(Calibrator::kNumBins, 0);
+  for (int i = 0; i < Calibrator::kNumBins / 4; i++) {
+    hist[i] = static_cast<uint64_t>(
+        100000 * std::exp(-8.f * i / Calibrator::kNumBins));
+  }
+  hist[Calibrator::kNumBins - 1] = 1;
+  float bin_width = 1.f / Calibrator::kNumBins;
+  float threshold = Calibrator::KLThreshold(hist, bin_width);
+  EXPECT_GT(threshold, 0.f);
+  EXPECT_LT(threshold, 0.5f);
+}
+
+TEST(Calibrator, kl_keeps_uniform_range) {
+  std::vector<uint64_t> hist(Calibrator::kNumBins, 1000);
+  float bin_width = 1.f / Calibrator::kNumBins;
+  float threshold = Calibrator::KLThreshold(hist, bin_width);
+  EXPECT_GT(threshold, 0.9f);
+  EXPECT_LE(threshold, 1.f);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -58,6 +58,22 @@ class KernelBase {
   /// Run the kernel. Before Run, both the param_ and context_ should be valid.
   virtual void Run() = 0;
 
+  /// The bytes of the temporary memory allocated from `workspace()` by Run
+  /// for the current input shapes, it's called after ReInitWhenNeeded.
+  virtual size_t WorkspaceSize() { return 0; }
+
+  /// Whether the outputs may share the memory of the input `X` through
+  /// `ShareDataWith` rather than being written, the inter-op scheduling
+  /// treats such outputs as the same variable as `X`.
+  virtual bool AliasesInput() const { return false; }
+
+  /// Let the host kernel allocate the temporary memory from the given
+  /// workspace instead of the thread-local one.
+  void SetWorkSpace(WorkSpace* workspace) { workspace_ = workspace; }
+  WorkSpace* workspace() {
+    return workspace_ ? workspace_ : &WorkSpace::Global_Host();
+  }
+
 #ifdef LITE_WITH_METAL
   virtual void SaveOutput() {}
 #endif
@@ -91,21 +107,27 @@ class KernelBase {
     /// kernel)
     ReInitWhenNeeded();
 
-    // Reset the workspace to make every kernel in the same thread to share the
-    // temporary memory.
-    WorkSpace::Global_Host().AllocReset();
+    if (workspace_) {
+      // The workspace is shared by the kernels of the same program.
+      workspace_->AllocReset();
+    } else {
+      // Reset the workspace to make every kernel in the same thread to share
+      // the temporary memory.
+      WorkSpace::Global_Host().AllocReset();
 #if defined(LITE_WITH_X86)
-    WorkSpace::Global_X86().AllocReset();
+      WorkSpace::Global_X86().AllocReset();
 #endif
 #if defined(LITE_WITH_CUDA)
-    WorkSpace::Global_CUDA().AllocReset();
+      WorkSpace::Global_CUDA().AllocReset();
 #endif
 #if defined(LITE_WITH_METAL)
-    WorkSpace::Global_METAL().AllocReset();
+      WorkSpace::Global_METAL().AllocReset();
 #endif
 #if defined(LITE_WITH_MLU)
-    WorkSpace::Global_MLU().AllocReset();
+      WorkSpace::Global_MLU().AllocReset();
 #endif
+    }
+    workspace()->Reserve(WorkspaceSize());
 
 #ifdef LITE_WITH_PROFILE
     if (!is_kernel_test_) {
@@ -208,6 +230,7 @@ class KernelBase {
   // is the unique ID for the kernel.
   std::string alias_{};
   bool is_first_epoch_{true};
+  WorkSpace* workspace_{nullptr};
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler* profiler_{nullptr};
@@ -58,5 +58,24 @@ TEST(tensor, shared_memory) {
 #endif
 }
 
+TEST(tensor, reserve) {
+  TensorLite tensor;
+  tensor.Resize({2, 2});
+  tensor.mutable_data<float>();
+  EXPECT_GE(tensor.capacity(), 4 * sizeof(float));
+  EXPECT_TRUE(tensor.Reserve(64 * sizeof(float)));
+  EXPECT_GE(tensor.capacity(), 64 * sizeof(float));
+  const void* reserved = tensor.raw_data();
+  // Growing within the reserved capacity doesn't reallocate.
+  tensor.Resize({8, 8});
+  float* data = tensor.mutable_data<float>();
+  EXPECT_EQ(reserved, data);
+  // The tensor sharing the buffer is left as it is.
+  TensorLite shared;
+  shared.ShareDataWith(tensor);
+  EXPECT_FALSE(shared.Reserve(128 * sizeof(float)));
+  EXPECT_EQ(shared.raw_data(), data);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -14,6 +14,10 @@
 
 #include "lite/core/memory.h"
 
+#ifdef LITE_WITH_HOST_MEMORY_POOL
+#include "lite/core/memory_pool.h"
+#endif
+
 #ifdef LITE_WITH_METAL
 #include "lite/backends/metal/target_wrapper.h"
 #include "lite/core/device_info.h"
@@ -28,7 +32,11 @@ void* TargetMalloc(TargetType target, size_t size) {
     case TargetType::kHost:
     case TargetType::kX86:
     case TargetType::kARM:
+#ifdef LITE_WITH_HOST_MEMORY_POOL
+      data = HostMemoryPool::Global().Malloc(size);
+#else
       data = TargetWrapper<TARGET(kHost)>::Malloc(size);
+#endif
       break;
 #ifdef LITE_WITH_CUDA
     case TargetType::kCUDA:
@@ -77,7 +85,11 @@ void TargetFree(TargetType target, void* data, std::string free_flag) {
     case TargetType::kHost:
     case TargetType::kX86:
     case TargetType::kARM:
+#ifdef LITE_WITH_HOST_MEMORY_POOL
+      HostMemoryPool::Global().Free(data);
+#else
       TargetWrapper<TARGET(kHost)>::Free(data);
+#endif
       break;
 
 #ifdef LITE_WITH_CUDA
@@ -128,6 +140,16 @@ void TargetFree(TargetType target, void* data, std::string free_flag) {
   }
 }
 
+size_t TargetMallocCapacity(TargetType target, const void* data, size_t size) {
+#ifdef LITE_WITH_HOST_MEMORY_POOL
+  if (target == TargetType::kHost || target == TargetType::kX86 ||
+      target == TargetType::kARM) {
+    return HostMemoryPool::Capacity(data);
+  }
+#endif
+  return size;
+}
+
 void TargetCopy(TargetType target, void* dst, const void* src, size_t size) {
   switch (target) {
     case TargetType::kHost:
@@ -60,6 +60,10 @@ void LITE_API TargetFree(TargetType target,
                          void* data,
                          std::string free_flag = "");
 
+// Get the usable size of the memory returned by TargetMalloc, which may be
+// larger than the requested `size`.
+size_t TargetMallocCapacity(TargetType target, const void* data, size_t size);
+
 // Copy a buffer from host to another target.
 void TargetCopy(TargetType target, void* dst, const void* src, size_t size);
 #ifdef LITE_WITH_OPENCL
@@ -134,12 +138,18 @@ class Buffer {
   bool own_data() const { return own_data_; }
 
   void ResetLazy(TargetType target, size_t size) {
+    // The host targets share the same memory, so that an unowned host buffer
+    // serves the kernels claiming it with any of them, e.g. a bound output.
+    if (!own_data_ && space_ >= size && IsHostTarget(target) &&
+        IsHostTarget(target_)) {
+      return;
+    }
     if (target != target_ || space_ < size) {
       CHECK_EQ(own_data_, true) << "Can not reset unowned buffer.";
       Free();
       data_ = TargetMalloc(target, size);
       target_ = target;
-      space_ = size;
+      space_ = TargetMallocCapacity(target, data_, size);
 #ifdef LITE_WITH_OPENCL
       cl_use_image2d_ = false;
 #endif
@@ -245,6 +255,11 @@ class Buffer {
   Buffer(Buffer&&) = default;
 
  private:
+  static bool IsHostTarget(TargetType target) {
+    return target == TargetType::kHost || target == TargetType::kX86 ||
+           target == TargetType::kARM;
+  }
+
   // memory it actually malloced.
   size_t space_{0};
   bool cl_use_image2d_{false};   // only used for OpenCL Image2D
@@ -0,0 +1,268 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+const size_t kAlignment = 64;
+const size_t kHugePageSize = 2 << 20;
+const uint32_t kBlockMagic = 0x6c697465;
+
+// The header is stored right before the block returned by Malloc, it takes
+// kAlignment bytes to keep the block aligned.
+struct BlockHeader {
+  void* raw;
+  size_t size_class;
+  size_t capacity;
+  uint32_t magic;
+};
+static_assert(sizeof(BlockHeader) <= kAlignment, "BlockHeader is too large.");
+
+BlockHeader* HeaderOf(const void* ptr) {
+  return reinterpret_cast<BlockHeader*>(
+      const_cast<char*>(static_cast<const char*>(ptr)) - kAlignment);
+}
+
+// The size classes are 64, 128, 192, 256, then 4 classes per power of two,
+// e.g. 320, 384, 448, 512, 640, ..., the waste is less than 25%.
+std::vector<size_t> GenSizeClasses() {
+  std::vector<size_t> classes;
+  for (size_t size = kAlignment; size <= 4 * kAlignment; size += kAlignment) {
+    classes.push_back(size);
+  }
+  for (size_t base = 4 * kAlignment; base < HostMemoryPool::kMaxCachedSize;
+       base *= 2) {
+    for (size_t i = 1; i <= 4; i++) {
+      classes.push_back(base + base / 4 * i);
+    }
+  }
+  return classes;
+}
+
+const std::vector<size_t>& SizeClasses() {
+  static const std::vector<size_t> classes = GenSizeClasses();
+  return classes;
+}
+
+// Trivially destructible, so it's still valid when the blocks held by the
+// other thread local objects are freed after the thread cache is destroyed.
+LITE_THREAD_LOCAL bool thread_cache_destroyed = false;
+}  // namespace
+
+// The per-thread bins, the cached blocks are returned to the shared bins when
+// the thread exits.
+struct HostMemoryThreadCache {
+  HostMemoryThreadCache() : bins(HostMemoryPool::NumSizeClasses()) {}
+  ~HostMemoryThreadCache() {
+    Flush();
+    thread_cache_destroyed = true;
+  }
+
+  // Return null if the thread cache of the current thread is destroyed.
+  static HostMemoryThreadCache* Get() {
+    if (thread_cache_destroyed) return nullptr;
+    static LITE_THREAD_LOCAL HostMemoryThreadCache cache;
+    return &cache;
+  }
+
+  void Flush() {
+    auto& pool = HostMemoryPool::Global();
+    for (size_t i = 0; i < bins.size(); i++) {
+      for (auto* ptr : bins[i]) {
+        pool.bytes_cached_ -= HostMemoryPool::SizeOfClass(i);
+        pool.ReleaseShared(ptr, i);
+      }
+      bins[i].clear();
+    }
+    bytes = 0;
+  }
+
+  std::vector<std::vector<void*>> bins;
+  size_t bytes{0};
+};
+
+HostMemoryPool& HostMemoryPool::Global() {
+  // Never destroyed since the thread caches may be flushed into it after the
+  // static objects are destroyed at exit.
+  static HostMemoryPool* pool = new HostMemoryPool();
+  return *pool;
+}
+
+HostMemoryPool::HostMemoryPool() : bins_(NumSizeClasses()) {}
+
+size_t HostMemoryPool::NumSizeClasses() { return SizeClasses().size(); }
+
+size_t HostMemoryPool::SizeClassOf(size_t size) {
+  auto& classes = SizeClasses();
+  return std::lower_bound(classes.begin(), classes.end(), size) -
+         classes.begin();
+}
+
+size_t HostMemoryPool::SizeOfClass(size_t size_class) {
+  auto& classes = SizeClasses();
+  return size_class < classes.size() ? classes[size_class] : 0;
+}
+
+size_t HostMemoryPool::Capacity(const void* ptr) {
+  return ptr ? HeaderOf(ptr)->capacity : 0;
+}
+
+void* HostMemoryPool::SystemMalloc(size_t size) {
+  size_t alignment = size >= kHugePageSize ? kHugePageSize : kAlignment;
+  size_t offset = alignment > kAlignment ? alignment : kAlignment;
+  char* raw = static_cast<char*>(malloc(size + offset + alignment - 1));
+  CHECK(raw) << "Error occurred in HostMemoryPool::Malloc period: no enough "
+                "for mallocing "
+             << size << " bytes.";
+  // Align the block and leave at least kAlignment bytes for the header.
+  char* ptr = reinterpret_cast<char*>(
+      (reinterpret_cast<uintptr_t>(raw) + offset + alignment - 1) &
+      ~(alignment - 1));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (alignment == kHugePageSize) {
+    madvise(ptr, size / kHugePageSize * kHugePageSize, MADV_HUGEPAGE);
+  }
+#endif
+  auto* header = HeaderOf(ptr);
+  header->raw = raw;
+  header->capacity = size;
+  header->magic = kBlockMagic;
+  return ptr;
+}
+
+void HostMemoryPool::SystemFree(void* ptr) { free(HeaderOf(ptr)->raw); }
+
+void* HostMemoryPool::FetchShared(size_t size_class) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& bin = bins_[size_class];
+  if (bin.empty()) return nullptr;
+  void* ptr = bin.back();
+  bin.pop_back();
+  shared_bytes_cached_ -= SizeOfClass(size_class);
+  return ptr;
+}
+
+void HostMemoryPool::ReleaseShared(void* ptr, size_t size_class) {
+  size_t size = SizeOfClass(size_class);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shared_bytes_cached_ + size <= kMaxSharedCachedBytes) {
+      bins_[size_class].push_back(ptr);
+      shared_bytes_cached_ += size;
+      bytes_cached_ += size;
+      return;
+    }
+  }
+  SystemFree(ptr);
+}
+
+void HostMemoryPool::RecordMalloc(size_t size, bool hit) {
+  num_allocs_++;
+  if (hit) num_hits_++;
+  size_t in_use = bytes_in_use_ += size;
+  size_t peak = peak_bytes_in_use_;
+  while (in_use > peak &&
+         !peak_bytes_in_use_.compare_exchange_weak(peak, in_use)) {
+  }
+}
+
+void* HostMemoryPool::Malloc(size_t size) {
+  size_t size_class = SizeClassOf(size);
+  if (size_class >= NumSizeClasses()) {
+    // Too big to be cached, the block is of the exact size.
+    void* ptr = SystemMalloc(size);
+    HeaderOf(ptr)->size_class = size_class;
+    RecordMalloc(size, false);
+    return ptr;
+  }
+  size_t capacity = SizeOfClass(size_class);
+  void* ptr = nullptr;
+  auto* cache = HostMemoryThreadCache::Get();
+  if (cache && !cache->bins[size_class].empty()) {
+    ptr = cache->bins[size_class].back();
+    cache->bins[size_class].pop_back();
+    cache->bytes -= capacity;
+    bytes_cached_ -= capacity;
+  } else {
+    ptr = FetchShared(size_class);
+    if (ptr) bytes_cached_ -= capacity;
+  }
+  bool hit = ptr != nullptr;
+  if (!hit) {
+    ptr = SystemMalloc(capacity);
+    HeaderOf(ptr)->size_class = size_class;
+  }
+  RecordMalloc(capacity, hit);
+  return ptr;
+}
+
+void HostMemoryPool::Free(void* ptr) {
+  if (!ptr) return;
+  auto* header = HeaderOf(ptr);
+  CHECK_EQ(header->magic, kBlockMagic)
+      << "The memory is not allocated by HostMemoryPool.";
+  size_t size_class = header->size_class;
+  size_t capacity = header->capacity;
+  bytes_in_use_ -= capacity;
+  if (size_class >= NumSizeClasses()) {
+    SystemFree(ptr);
+    return;
+  }
+  auto* cache = HostMemoryThreadCache::Get();
+  if (cache && capacity <= kMaxThreadCachedSize &&
+      cache->bytes + capacity <= kMaxThreadCachedBytes) {
+    cache->bins[size_class].push_back(ptr);
+    cache->bytes += capacity;
+    bytes_cached_ += capacity;
+  } else {
+    ReleaseShared(ptr, size_class);
+  }
+}
+
+void HostMemoryPool::Trim() {
+  auto* cache = HostMemoryThreadCache::Get();
+  if (cache) cache->Flush();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < bins_.size(); i++) {
+    for (auto* ptr : bins_[i]) {
+      SystemFree(ptr);
+    }
+    bytes_cached_ -= SizeOfClass(i) * bins_[i].size();
+    bins_[i].clear();
+  }
+  shared_bytes_cached_ = 0;
+}
+
+HostMemoryStats HostMemoryPool::stats() const {
+  HostMemoryStats stats;
+  stats.bytes_in_use = bytes_in_use_;
+  stats.peak_bytes_in_use = peak_bytes_in_use_;
+  stats.bytes_cached = bytes_cached_;
+  stats.num_allocs = num_allocs_;
+  stats.num_hits = num_hits_;
+  return stats;
+}
+
+}  // namespace lite
+}  // namespace paddle
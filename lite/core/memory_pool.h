@@ -0,0 +1,108 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+
+struct HostMemoryStats {
+  // The bytes held by the allocated blocks, rounded up to the size classes.
+  size_t bytes_in_use{0};
+  size_t peak_bytes_in_use{0};
+  // The bytes of the free blocks cached by the pool.
+  size_t bytes_cached{0};
+  uint64_t num_allocs{0};
+  // The allocations served by the cached blocks.
+  uint64_t num_hits{0};
+};
+
+/*
+ * HostMemoryPool is a thread-caching size-class allocator for the host memory,
+ * TargetMalloc and TargetFree go through it for kHost, kX86 and kARM when
+ * LITE_WITH_HOST_MEMORY_POOL is defined.
+ *
+ * The requested sizes are rounded up to the size classes, which are spaced by
+ * a quarter of the power of two, and the freed blocks are cached in the
+ * per-thread bins first, then in the shared bins, so that the tensors growing
+ * with the varying input shapes reuse the blocks freed by each other instead
+ * of hitting the system allocator. The blocks are 64-byte aligned, and the
+ * blocks not smaller than a huge page are aligned to it and advised to be
+ * backed by the transparent huge pages on linux.
+ */
+class HostMemoryPool {
+ public:
+  static HostMemoryPool& Global();
+
+  void* Malloc(size_t size);
+  void Free(void* ptr);
+
+  // The usable size of the block returned by Malloc.
+  static size_t Capacity(const void* ptr);
+
+  // Return all of the blocks cached by the shared bins and the bins of the
+  // current thread to the system.
+  void Trim();
+
+  HostMemoryStats stats() const;
+
+  // The size classes.
+  static size_t SizeClassOf(size_t size);
+  static size_t SizeOfClass(size_t size_class);
+  static size_t NumSizeClasses();
+
+  // The blocks bigger than it are not cached by the bins of threads.
+  static const size_t kMaxThreadCachedSize = 4 << 20;
+  // The blocks bigger than it are not cached at all.
+  static const size_t kMaxCachedSize = 512 << 20;
+  // The limit of the bytes cached by the shared bins.
+  static const size_t kMaxSharedCachedBytes = 1024UL << 20;
+  // The limit of the bytes cached by the bins of a thread.
+  static const size_t kMaxThreadCachedBytes = 32 << 20;
+
+ private:
+  friend struct HostMemoryThreadCache;
+
+  HostMemoryPool();
+
+  // Allocate and free the blocks from and to the system.
+  void* SystemMalloc(size_t size);
+  void SystemFree(void* ptr);
+
+  // Fetch a block from or put a block into the shared bins.
+  void* FetchShared(size_t size_class);
+  void ReleaseShared(void* ptr, size_t size_class);
+
+  void RecordMalloc(size_t size, bool hit);
+
+  std::mutex mutex_;
+  std::vector<std::vector<void*>> bins_;
+  std::atomic<size_t> bytes_in_use_{0};
+  std::atomic<size_t> peak_bytes_in_use_{0};
+  std::atomic<size_t> bytes_cached_{0};
+  std::atomic<size_t> shared_bytes_cached_{0};
+  std::atomic<uint64_t> num_allocs_{0};
+  std::atomic<uint64_t> num_hits_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(HostMemoryPool);
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_pool.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+
+namespace paddle {
+namespace lite {
+
+TEST(memory_pool, size_class) {
+  for (size_t size : {1, 64, 65, 1000, 4096, 100000, 3 << 20}) {
+    size_t size_class = HostMemoryPool::SizeClassOf(size);
+    ASSERT_LT(size_class, HostMemoryPool::NumSizeClasses());
+    size_t capacity = HostMemoryPool::SizeOfClass(size_class);
+    EXPECT_GE(capacity, size);
+    EXPECT_LE(capacity, size + size / 4 + 64);
+  }
+  EXPECT_EQ(HostMemoryPool::SizeClassOf(HostMemoryPool::kMaxCachedSize + 1),
+            HostMemoryPool::NumSizeClasses());
+}
+
+TEST(memory_pool, malloc) {
+  auto& pool = HostMemoryPool::Global();
+  for (size_t size : {1, 100, 5000, 3 << 20, 600 << 20}) {
+    void* ptr = pool.Malloc(size);
+    ASSERT_TRUE(ptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0u);
+    EXPECT_GE(HostMemoryPool::Capacity(ptr), size);
+    memset(ptr, 0, HostMemoryPool::Capacity(ptr));
+    pool.Free(ptr);
+  }
+}
+
+TEST(memory_pool, reuse) {
+  auto& pool = HostMemoryPool::Global();
+  pool.Trim();
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.bytes_cached, 0u);
+
+  void* ptr = pool.Malloc(1000);
+  size_t capacity = HostMemoryPool::Capacity(ptr);
+  EXPECT_EQ(pool.stats().bytes_in_use, stats.bytes_in_use + capacity);
+  pool.Free(ptr);
+  EXPECT_EQ(pool.stats().bytes_in_use, stats.bytes_in_use);
+  EXPECT_EQ(pool.stats().bytes_cached, capacity);
+
+  // The sizes of the same class share the cached block.
+  void* other = pool.Malloc(capacity);
+  EXPECT_EQ(other, ptr);
+  EXPECT_EQ(pool.stats().num_hits, stats.num_hits + 1);
+  EXPECT_EQ(pool.stats().num_allocs, stats.num_allocs + 2);
+  pool.Free(other);
+
+  pool.Trim();
+  EXPECT_EQ(pool.stats().bytes_cached, 0u);
+  EXPECT_GE(pool.stats().peak_bytes_in_use, capacity);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -49,11 +49,6 @@ void ElementwiseActivationFusePass::Apply(
   if (has_opencl) {
     act_types.push_back("relu");
   }
-  bool has_x86 = has_target(TARGET(kX86));
-  if (has_x86 && !has_opencl) {
-    LOG(INFO) << "skipped when x86 target only.";
-    return;
-  }
 
   // start fuse using params
   for (auto elt_type : elt_types) {
@@ -73,7 +68,6 @@ REGISTER_MIR_PASS(lite_elementwise_activation_fuse_pass,
     .BindTargets({TARGET(kAny)})
     .ExcludeTargets({TARGET(kXPU)})
     .ExcludeTargets({TARGET(kBM)})
-    .ExcludeTargets({TARGET(kX86)})
     .ExcludeTargets({TARGET(kRKNPU)})
     .BindKernel("fusion_elementwise_add_activation")
     .BindKernel("fusion_elementwise_sub_activation");
@@ -0,0 +1,123 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/embedding_seq_pool_fuser.h"
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// """
+// merge {lookup_table, sequence_pool} => fused_embedding_seq_pool
+//        w    ids                   w    ids
+//        |     |                    |     |
+//        v     v                    v     v
+//      lookup_table      =>   fused_embedding_seq_pool
+//            |                          |
+//            v                          v
+//      sequence_pool                   out
+//            |
+//            v
+//           out
+// """
+void EmbeddingSeqPoolFuser::BuildPattern() {
+  // create input nodes.
+  auto* w = VarNode("w")->assert_is_op_input(lookup_type_, "W")->AsInput();
+  auto* ids =
+      VarNode("ids")->assert_is_op_input(lookup_type_, "Ids")->AsInput();
+
+  // create op nodes
+  auto* lookup_table = OpNode("lookup_table", lookup_type_)
+                           ->assert_is_op(lookup_type_)
+                           ->AsIntermediate();
+  // The MAX pooling outputs the indices of the max values, which can't be
+  // computed without the embeddings. The fused kernel pads the empty
+  // sequences with 0.
+  auto pad_value_teller = [](const Node* x) -> bool {
+    if (x && x->IsStmt()) {
+      auto* op_info = x->stmt()->op_info();
+      return !op_info->HasAttr("pad_value") ||
+             op_info->GetAttr<float>("pad_value") == 0.f;
+    }
+    return false;
+  };
+  auto* sequence_pool =
+      OpNode("sequence_pool", "sequence_pool")
+          ->assert_is_op("sequence_pool")
+          ->assert_op_attr_satisfied<std::string>(
+              "pooltype",
+              [](const std::string& type) { return type != "MAX"; })
+          ->assert_node_satisfied(pad_value_teller)
+          ->AsIntermediate();
+
+  // create intermediate nodes
+  auto* lookup_table_out = VarNode("lookup_table_out")
+                               ->assert_is_op_output(lookup_type_, "Out")
+                               ->assert_is_op_input("sequence_pool", "X")
+                               ->assert_only_one_output()
+                               ->AsIntermediate();
+  auto* sequence_pool_idx =
+      VarNode("sequence_pool_idx")
+          ->assert_is_op_output("sequence_pool", "MaxIndex")
+          ->AsIntermediate();
+
+  // create output node
+  auto* out =
+      VarNode("out")->assert_is_op_output("sequence_pool", "Out")->AsOutput();
+
+  // create topology.
+  *w >> *lookup_table;
+  *ids >> *lookup_table >> *lookup_table_out >> *sequence_pool >> *out;
+  *sequence_pool >> *sequence_pool_idx;
+}
+
+void EmbeddingSeqPoolFuser::InsertNewNode(SSAGraph* graph,
+                                          const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto fuse_op = LiteOpRegistry::Global().Create("fused_embedding_seq_pool");
+  auto lookup_table = matched.at("lookup_table")->stmt()->op();
+  auto* scope = lookup_table->scope();
+  auto& valid_places = lookup_table->valid_places();
+  fuse_op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(fuse_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("w"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("ids"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc EmbeddingSeqPoolFuser::GenOpDesc(const key2nodes_t& matched) {
+  auto* lookup_table_desc = matched.at("lookup_table")->stmt()->op_info();
+  auto* sequence_pool_desc = matched.at("sequence_pool")->stmt()->op_info();
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_embedding_seq_pool");
+  op_desc.SetInput("W", {matched.at("w")->arg()->name});
+  op_desc.SetInput("Ids", {matched.at("ids")->arg()->name});
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  op_desc.SetAttr("padding_idx",
+                  lookup_table_desc->GetAttr<int64_t>("padding_idx"));
+  op_desc.SetAttr("pooltype",
+                  sequence_pool_desc->GetAttr<std::string>("pooltype"));
+  op_desc.SetAttr("lookup_type", lookup_type_);
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
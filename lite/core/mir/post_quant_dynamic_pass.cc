@@ -20,6 +20,8 @@
 #include <vector>
 #include "lite/api/paddle_place.h"
 #include "lite/core/mir/pass_registry.h"
+#include "lite/utils/bfloat16.h"
+#include "lite/utils/float16.h"
 
 namespace paddle {
 namespace lite {
@@ -115,6 +117,16 @@ void QuantizeWeightPerChannel(const Tensor& src,
   }
 }
 
+template void QuantizeWeightPerChannel<int8_t>(const Tensor& src,
+                                               const std::vector<float>& scales,
+                                               int quant_axis,
+                                               int8_t* dest_data);
+template void QuantizeWeightPerChannel<int16_t>(
+    const Tensor& src,
+    const std::vector<float>& scales,
+    int quant_axis,
+    int16_t* dest_data);
+
 void PostQuantDynamicPerChannel(OpInfo* op_info,
                                 Tensor* weight,
                                 const std::string weight_name,
@@ -154,12 +166,53 @@ void PostQuantDynamicPerChannel(OpInfo* op_info,
   op_info->SetAttr(weight_name + "_quant_scale", scales);
 }
 
+// Convert the fp32 weight to fp16 or bf16. The scales of the channels are all
+// ones, so the weight is run by the same weight-only kernels as int8/int16.
+void PostQuantDynamicHalf(OpInfo* op_info,
+                          Tensor* weight,
+                          const std::string weight_name,
+                          int quant_axis,
+                          lite_api::QuantType quant_type) {
+  const DDim weight_dims = weight->dims();
+  CHECK(weight_dims.size() == 2 || weight_dims.size() == 4);
+  CHECK(quant_axis == 0 || quant_axis == 1);
+  std::vector<float> scales(weight_dims[quant_axis], 1.f);
+
+  Tensor tmp_tensor;
+  tmp_tensor.CopyDataFrom(*weight);
+  weight->clear();
+  const float* src = tmp_tensor.data<float>();
+  const int64_t size = tmp_tensor.numel();
+  if (quant_type == lite_api::QuantType::QUANT_FP16) {
+    auto* dest = weight->mutable_data<lite::float16>();
+    for (int64_t i = 0; i < size; i++) {
+      dest[i] = lite::float16(src[i]);
+    }
+    weight->set_precision(PRECISION(kFP16));
+    op_info->SetAttr<std::string>("quantization_type", "post_weight_fp16");
+  } else {
+    // There is no bf16 precision, the bf16 weight is held by int16 tensor.
+    auto* dest = weight->mutable_data<lite::bfloat16>();
+    for (int64_t i = 0; i < size; i++) {
+      dest[i] = lite::bfloat16(src[i]);
+    }
+    weight->set_precision(PRECISION(kInt16));
+    op_info->SetAttr<std::string>("quantization_type", "post_weight_bf16");
+  }
+  op_info->SetAttr("quantize_weight_bits", 16);
+  op_info->SetAttr(weight_name + "_quant_scale", scales);
+}
+
 void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   int quant_bits = 16;
+  bool quant_half = false;
   if (quant_type_ == lite_api::QuantType::QUANT_INT8) {
     quant_bits = 8;
   } else if (quant_type_ == lite_api::QuantType::QUANT_INT16) {
     quant_bits = 16;
+  } else if (quant_type_ == lite_api::QuantType::QUANT_FP16 ||
+             quant_type_ == lite_api::QuantType::QUANT_BF16) {
+    quant_half = true;
   } else {
     LOG(FATAL) << "Not support quant type:" << static_cast<int>(quant_type_);
   }
@@ -193,8 +246,13 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
         auto iter =
             std::find(quant_axis1_ops.begin(), quant_axis1_ops.end(), op_type);
         int quant_axis = iter != quant_axis1_ops.end() ? 1 : 0;
-        PostQuantDynamicPerChannel(
-            op_info, weight, weight_name, quant_axis, quant_bits);
+        if (quant_half) {
+          PostQuantDynamicHalf(
+              op_info, weight, weight_name, quant_axis, quant_type_);
+        } else {
+          PostQuantDynamicPerChannel(
+              op_info, weight, weight_name, quant_axis, quant_bits);
+        }
       }
     }
   }
@@ -28,8 +28,12 @@ namespace mir {
  * Use post_quant_dynamic method to quantize the model.
  * In optimization stage, if the data type of weights is fp32, quantize the
  * weights to int8/16. So the size of the quantized weights is reduced 4x/2x.
+ * The weights can also be converted to fp16/bf16 without scales, which halves
+ * the size with less loss.
  * In inference stage, the quantized weights are dequantized to fp32 and run
- * all ops to get output.
+ * all ops to get output, except for the x86 conv2d, fc, mul and lookup_table
+ * kernels, which keep the weights in int8/16 or fp16/bf16 and dequantize them
+ * tile by tile, with the accumulation in fp32.
  */
 class PostQuantDynamicPass : public ProgramPass {
  public:
@@ -51,6 +55,19 @@ class PostQuantDynamicPass : public ProgramPass {
   lite_api::QuantType quant_type_{lite_api::QuantType::QUANT_INT16};
 };
 
+// Find the abs max of each channel of the fp32 tensor along `quant_axis`.
+void FindAbsMaxPerChannel(const Tensor& tensor,
+                          int quant_axis,
+                          std::vector<float>* res);
+
+// Quantize the fp32 tensor with the scales of each channel along `quant_axis`.
+// It's instantiated for int8_t and int16_t.
+template <typename T>
+void QuantizeWeightPerChannel(const Tensor& src,
+                              const std::vector<float>& scales,
+                              int quant_axis,
+                              T* dest_data);
+
 }  // namespace mir
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,107 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/post_quant_static_pass.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/post_quant_dynamic_pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+std::vector<std::string> PostQuantStaticPass::quant_ops = {
+    "conv2d", "depthwise_conv2d", "mul"};
+
+void PostQuantStaticPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  if (thresholds_.empty()) {
+    LOG(WARNING) << "No thresholds are set, skip post_quant_static_pass.";
+    return;
+  }
+  const int bit_length = 8;
+  const float range = (1 << (bit_length - 1)) - 1;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    const std::string op_type = node->stmt()->op_type();
+    if (std::find(quant_ops.begin(), quant_ops.end(), op_type) ==
+        quant_ops.end()) {
+      continue;
+    }
+    auto op_info = *node->stmt()->op_info();
+    // Skip the ops quantized already.
+    if (op_info.HasAttr("enable_int8") &&
+        op_info.GetAttr<bool>("enable_int8")) {
+      continue;
+    }
+    const bool is_conv = op_type != "mul";
+    const std::string act_name =
+        op_info.Input(is_conv ? "Input" : "X").front();
+    const std::string weight_name =
+        op_info.Input(is_conv ? "Filter" : "Y").front();
+    const std::string out_name =
+        op_info.Output(is_conv ? "Output" : "Out").front();
+    auto act_iter = thresholds_.find(act_name);
+    if (act_iter == thresholds_.end()) {
+      VLOG(4) << "No threshold of " << act_name << ", skip " << op_type;
+      continue;
+    }
+    auto* scope = node->stmt()->op()->scope();
+    auto* weight_var = scope->FindVar(weight_name);
+    if (!weight_var) continue;
+    auto* weight = weight_var->GetMutable<Tensor>();
+    if (!weight->persistable() ||
+        weight->precision() != PrecisionType::kFloat) {
+      continue;
+    }
+
+    // The quant axis of conv2d and depthwise_conv2d is 0, and it's 1 for mul.
+    const int quant_axis = is_conv ? 0 : 1;
+    std::vector<float> weight_scale;
+    FindAbsMaxPerChannel(*weight, quant_axis, &weight_scale);
+    for (auto& scale : weight_scale) {
+      // Avoid dividing by zero for the channels of all zeros.
+      scale = std::max(scale, 1e-8f) / range;
+    }
+    Tensor tmp_tensor;
+    tmp_tensor.CopyDataFrom(*weight);
+    weight->clear();
+    weight->set_precision(PRECISION(kInt8));
+    QuantizeWeightPerChannel(tmp_tensor,
+                             weight_scale,
+                             quant_axis,
+                             weight->mutable_data<int8_t>());
+
+    op_info.SetAttr<int>("bit_length", bit_length);
+    op_info.SetInputScale(act_name, {act_iter->second / range});
+    op_info.SetInputScale(weight_name, weight_scale);
+    auto out_iter = thresholds_.find(out_name);
+    if (out_iter != thresholds_.end()) {
+      op_info.SetAttr<float>("out_threshold", out_iter->second);
+    }
+    op_info.SetAttr("enable_int8", true);
+    node->stmt()->ResetOp(op_info, graph->valid_places());
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(post_quant_static_pass,
+                  paddle::lite::mir::PostQuantStaticPass)
+    .BindTargets({TARGET(kAny)});
@@ -0,0 +1,54 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+/*
+ * Use post_quant_static method to quantize the model.
+ * With the thresholds of the activations collected by the calibration, see
+ * `Calibrator`, the weights of the fp32 ops are quantized to int8 per channel,
+ * and the ops are marked as the int8 ops, with the scales of the inputs and
+ * the out_threshold set in the same format as lite_quant_dequant_fuse_pass,
+ * so they are picked the int8 kernels as the quantized models.
+ */
+class PostQuantStaticPass : public ProgramPass {
+ public:
+  // The ops in quant_ops will be applied post_quant_static.
+  // Default, quant_ops = {"conv2d", "depthwise_conv2d", "mul"}
+  static std::vector<std::string> quant_ops;
+
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  // The thresholds keyed by the names of the activations.
+  void SetThresholds(const std::map<std::string, float>& thresholds) {
+    thresholds_ = thresholds;
+  }
+
+ private:
+  std::map<std::string, float> thresholds_;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,340 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/sparse_weight_convert_pass.h"
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+bool AllEqual(const std::vector<int>& values, int value) {
+  return std::all_of(
+      values.begin(), values.end(), [&](int x) { return x == value; });
+}
+
+// Whether the attributes of the op are supported by sparse_fc or
+// sparse_conv2d.
+bool IsSupportedOp(const OpInfo& op_info, const std::string& weight_name) {
+  const std::string op_type = op_info.Type();
+  if ((op_info.HasAttr("enable_int8") &&
+       op_info.GetAttr<bool>("enable_int8")) ||
+      op_info.HasAttr(weight_name + "_quant_scale")) {
+    return false;
+  }
+  if (op_type == "fc") {
+    std::string act = op_info.HasAttr("activation_type")
+                          ? op_info.GetAttr<std::string>("activation_type")
+                          : "";
+    return (act.empty() || act == "relu") &&
+           !(op_info.HasAttr("padding_weights") &&
+             op_info.GetAttr<bool>("padding_weights"));
+  } else if (op_type == "mul") {
+    return !op_info.HasAttr("y_num_col_dims") ||
+           op_info.GetAttr<int>("y_num_col_dims") == 1;
+  } else if (op_type == "conv2d") {
+    if (op_info.GetAttr<int>("groups") != 1 ||
+        !AllEqual(op_info.GetAttr<std::vector<int>>("strides"), 1) ||
+        !AllEqual(op_info.GetAttr<std::vector<int>>("paddings"), 0) ||
+        !AllEqual(op_info.GetAttr<std::vector<int>>("dilations"), 1)) {
+      return false;
+    }
+    if (op_info.HasInput("ResidualData") &&
+        !op_info.Input("ResidualData").empty()) {
+      return false;
+    }
+    if (op_info.HasAttr("with_act") && op_info.GetAttr<bool>("with_act")) {
+      auto act = op_info.GetAttr<std::string>("act_type");
+      return act == "relu" ||
+             (act == "relu6" &&
+              op_info.GetAttr<float>("fuse_brelu_threshold") == 6.f);
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+std::vector<int> SparseWeightConvertPass::PickBlockShape(const float* dense,
+                                                         int rows,
+                                                         int cols,
+                                                         float threshold,
+                                                         float* sparsity) {
+  std::vector<int> best;
+  int64_t best_cost = 0;
+  for (auto& shape : std::vector<std::vector<int>>{
+           {4, 4}, {4, 1}, {1, 4}, {1, 1}}) {
+    const int r = shape[0];
+    const int c = shape[1];
+    if (rows % r != 0 || cols % c != 0) continue;
+    int64_t blocks = 0;
+    for (int i = 0; i < rows; i += r) {
+      for (int j = 0; j < cols; j += c) {
+        bool non_zero = false;
+        for (int k = 0; k < r * c && !non_zero; k++) {
+          non_zero = dense[static_cast<int64_t>(i + k / c) * cols + j +
+                           k % c] != 0.f;
+        }
+        blocks += non_zero;
+      }
+    }
+    const int64_t total = static_cast<int64_t>(rows / r) * (cols / c);
+    const float ratio = 1.f - static_cast<float>(blocks) / total;
+    if (blocks == 0 || ratio < threshold) continue;
+    // The loads and the multiply-adds of a block in the kernels, i.e. c rows
+    // of the input, r * c elements of the block and its column index.
+    const int64_t cost = blocks * (r * c + c + 1);
+    if (best.empty() || cost < best_cost) {
+      best = shape;
+      best_cost = cost;
+      *sparsity = ratio;
+    }
+  }
+  return best;
+}
+
+void SparseWeightConvertPass::ToBlockSparse(const float* dense,
+                                            int rows,
+                                            int cols,
+                                            int block_rows,
+                                            int block_cols,
+                                            std::vector<float>* values,
+                                            std::vector<int32_t>* col_index,
+                                            std::vector<int32_t>* row_offset) {
+  CHECK_EQ(rows % block_rows, 0);
+  CHECK_EQ(cols % block_cols, 0);
+  values->clear();
+  col_index->clear();
+  row_offset->assign(1, 0);
+  for (int i = 0; i < rows; i += block_rows) {
+    for (int j = 0; j < cols; j += block_cols) {
+      std::vector<float> block;
+      bool non_zero = false;
+      for (int r = 0; r < block_rows; r++) {
+        for (int c = 0; c < block_cols; c++) {
+          float x = dense[static_cast<int64_t>(i + r) * cols + j + c];
+          non_zero = non_zero || x != 0.f;
+          block.push_back(x);
+        }
+      }
+      if (non_zero) {
+        values->insert(values->end(), block.begin(), block.end());
+        col_index->push_back(j);
+      }
+    }
+    row_offset->push_back(static_cast<int32_t>(col_index->size()));
+  }
+}
+
+bool SparseWeightConvertPass::ConvertOp(SSAGraph* graph,
+                                        Node* node,
+                                        const std::string& weight_name,
+                                        const std::vector<float>& dense,
+                                        int rows,
+                                        int cols) {
+  float sparsity = 0.f;
+  auto block_shape =
+      PickBlockShape(dense.data(), rows, cols, threshold_, &sparsity);
+  if (block_shape.empty()) return false;
+  std::vector<float> values;
+  std::vector<int32_t> col_index;
+  std::vector<int32_t> row_offset;
+  ToBlockSparse(dense.data(),
+                rows,
+                cols,
+                block_shape[0],
+                block_shape[1],
+                &values,
+                &col_index,
+                &row_offset);
+
+  auto* stmt = node->stmt();
+  auto* op_info = stmt->op_info();
+  auto* scope = stmt->op()->scope();
+  const std::string op_type = op_info->Type();
+  const bool is_conv = op_type == "conv2d";
+  cpp::OpDesc op_desc;
+  op_desc.SetType(is_conv ? "sparse_conv2d" : "sparse_fc");
+  op_desc.SetInput("Input",
+                   {op_info->Input(op_type == "mul" ? "X" : "Input").front()});
+  if (op_info->HasInput("Bias") && !op_info->Input("Bias").empty()) {
+    op_desc.SetInput("Bias", {op_info->Input("Bias").front()});
+  }
+  std::string activation_type;
+  if (is_conv) {
+    op_desc.SetOutput("Output", op_info->Output("Output"));
+    if (op_info->HasAttr("with_act") && op_info->GetAttr<bool>("with_act")) {
+      activation_type = op_info->GetAttr<std::string>("act_type");
+    }
+  } else {
+    op_desc.SetOutput("Out", op_info->Output("Out"));
+    op_desc.SetAttr<int>("in_num_col_dims",
+                         op_type == "mul"
+                             ? op_info->GetAttr<int>("x_num_col_dims")
+                             : op_info->GetAttr<int>("in_num_col_dims"));
+    if (op_info->HasAttr("activation_type")) {
+      activation_type = op_info->GetAttr<std::string>("activation_type");
+    }
+  }
+  op_desc.SetAttr<std::string>("activation_type", activation_type);
+  op_desc.SetAttr<std::vector<int>>("sparse_shape", {rows, cols});
+  op_desc.SetAttr<std::vector<int>>("block_shape", block_shape);
+
+  // The weight in the block sparse format.
+  const std::string values_name = weight_name + "_sparse_values";
+  const std::string col_index_name = weight_name + "_sparse_col_index";
+  const std::string row_offset_name = weight_name + "_sparse_row_offset";
+  auto* values_t = scope->NewTensor(values_name);
+  values_t->Resize({static_cast<int64_t>(values.size())});
+  memcpy(values_t->mutable_data<float>(),
+         values.data(),
+         values.size() * sizeof(float));
+  auto* col_index_t = scope->NewTensor(col_index_name);
+  col_index_t->Resize({static_cast<int64_t>(col_index.size())});
+  memcpy(col_index_t->mutable_data<int32_t>(),
+         col_index.data(),
+         col_index.size() * sizeof(int32_t));
+  auto* row_offset_t = scope->NewTensor(row_offset_name);
+  row_offset_t->Resize({static_cast<int64_t>(row_offset.size())});
+  memcpy(row_offset_t->mutable_data<int32_t>(),
+         row_offset.data(),
+         row_offset.size() * sizeof(int32_t));
+  op_desc.SetInput("Values", {values_name});
+  op_desc.SetInput("ColIndex", {col_index_name});
+  op_desc.SetInput("RowOffset", {row_offset_name});
+
+  auto sparse_op = LiteOpRegistry::Global().Create(op_desc.Type());
+  CHECK(sparse_op) << "The op " << op_desc.Type() << " is not registered.";
+  sparse_op->Attach(op_desc, scope);
+  auto* sparse_node =
+      graph->GraphCreateInstructNode(sparse_op, stmt->op()->valid_places());
+  Node* weight_node = nullptr;
+  for (auto* in : node->inlinks) {
+    if (in->arg()->name == weight_name) {
+      weight_node = in;
+    } else {
+      DirectedLink(in, sparse_node);
+    }
+  }
+  for (auto* out : node->outlinks) {
+    DirectedLink(sparse_node, out);
+  }
+  for (auto* tensor : {values_t, col_index_t, row_offset_t}) {
+    tensor->set_persistable(true);
+  }
+  for (auto& name : {values_name, col_index_name, row_offset_name}) {
+    auto* arg_node = graph->NewArgumentNode(name);
+    arg_node->arg()->is_weight = true;
+    DirectedLink(arg_node, sparse_node);
+  }
+
+  // The dense weight is dropped from the graph if no other op refers to it,
+  // so that it's not saved with the optimized model.
+  std::set<const Node*> nodes2rm{node};
+  if (weight_node && weight_node->outlinks.size() == 1) {
+    nodes2rm.insert(weight_node);
+  }
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  VLOG(3) << "Convert " << op_type << " to " << op_desc.Type() << " with "
+          << block_shape[0] << "x" << block_shape[1] << " blocks of "
+          << weight_name << ", the sparsity is " << sparsity;
+  return true;
+}
+
+void SparseWeightConvertPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The sparse kernels are only available on x86.
+  if (threshold_ > 1.f || graph->valid_places().empty() ||
+      graph->valid_places().front().target != TARGET(kX86)) {
+    return;
+  }
+  std::vector<Node*> nodes;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (node->IsStmt()) {
+      nodes.push_back(node);
+    }
+  }
+  int converted = 0;
+  for (auto* node : nodes) {
+    auto* op_info = node->stmt()->op_info();
+    const std::string op_type = op_info->Type();
+    std::string weight_name;
+    if (op_type == "fc") {
+      weight_name = op_info->Input("W").front();
+    } else if (op_type == "mul") {
+      weight_name = op_info->Input("Y").front();
+    } else if (op_type == "conv2d") {
+      weight_name = op_info->Input("Filter").front();
+    } else {
+      continue;
+    }
+    if (!IsSupportedOp(*op_info, weight_name)) continue;
+    bool is_weight = false;
+    for (auto* in : node->inlinks) {
+      is_weight = is_weight ||
+                  (in->arg()->name == weight_name && in->arg()->is_weight);
+    }
+    if (!is_weight) continue;
+    auto* var = node->stmt()->op()->scope()->FindVar(weight_name);
+    if (!var) continue;
+    const auto& weight = var->Get<lite::Tensor>();
+    if (weight.precision() != PRECISION(kFloat)) continue;
+    const auto& dims = weight.dims();
+    const float* data = weight.data<float>();
+    std::vector<float> dense;
+    int rows = 0;
+    int cols = 0;
+    if (op_type == "conv2d") {
+      // The 1x1 filter of OC x IC x 1 x 1 is already OC x IC.
+      if (dims.size() != 4 || dims[2] != 1 || dims[3] != 1) continue;
+      rows = static_cast<int>(dims[0]);
+      cols = static_cast<int>(dims[1]);
+      dense.assign(data, data + weight.numel());
+    } else {
+      // The weight of K x N is transposed to N x K.
+      if (dims.size() != 2) continue;
+      rows = static_cast<int>(dims[1]);
+      cols = static_cast<int>(dims[0]);
+      dense.resize(weight.numel());
+      for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+          dense[static_cast<int64_t>(i) * cols + j] =
+              data[static_cast<int64_t>(j) * rows + i];
+        }
+      }
+    }
+    converted += ConvertOp(graph.get(), node, weight_name, dense, rows, cols);
+  }
+  if (converted > 0) {
+    LOG(INFO) << "Converted " << converted
+              << " ops to the block sparse kernels.";
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(sparse_weight_convert_pass,
+                  paddle::lite::mir::SparseWeightConvertPass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("sparse_fc")
+    .BindKernel("sparse_conv2d");
@@ -0,0 +1,80 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * mir::SparseWeightConvertPass converts the x86 fc, mul and 1x1 conv2d whose
+ * persistable weights are mostly zeros, e.g. the magnitude-pruned ones, to
+ * sparse_fc and sparse_conv2d. The weight is replaced by three persistable
+ * tensors holding it in the block sparse format, i.e. the non-zero blocks of
+ * 1x1, 1x4, 4x1 or 4x4 in CSR, and the op is converted only when the ratio of
+ * the zero blocks is not less than the threshold, so that the cost of the
+ * sparse kernels is proportional to the non-zeros.
+ */
+class SparseWeightConvertPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  // The ops are converted when the ratio of the zero blocks of the weight is
+  // not less than it, which is 0.7 by default, and no op is converted if it's
+  // greater than 1.
+  void SetSparseThreshold(float threshold) { threshold_ = threshold; }
+  float sparse_threshold() const { return threshold_; }
+
+  // Pick the block shape of the rows x cols matrix, whose ratio of the zero
+  // blocks is not less than threshold and which costs the least, the ratio is
+  // returned by sparsity. Return an empty vector if there is none.
+  static std::vector<int> PickBlockShape(const float* dense,
+                                         int rows,
+                                         int cols,
+                                         float threshold,
+                                         float* sparsity);
+
+  // Convert the rows x cols matrix to the block sparse format, see
+  // x86::math::BlockSparseMatrix.
+  static void ToBlockSparse(const float* dense,
+                            int rows,
+                            int cols,
+                            int block_rows,
+                            int block_cols,
+                            std::vector<float>* values,
+                            std::vector<int32_t>* col_index,
+                            std::vector<int32_t>* row_offset);
+
+ private:
+  // Convert the op if its weight is sparse enough, the weight is transposed
+  // to a matrix of output x input channels in `dense`.
+  bool ConvertOp(SSAGraph* graph,
+                 Node* node,
+                 const std::string& weight_name,
+                 const std::vector<float>& dense,
+                 int rows,
+                 int cols);
+
+  float threshold_{0.7f};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,383 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/sparse_weight_convert_pass.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/mir/pass_manager.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// The fc of M x K inputs and a K x N weight, whose transpose, i.e. N x K, has
+// two non-zero 1x4 blocks.
+const int kM = 3;
+const int kK = 8;
+const int kN = 12;
+// The 1x1 conv2d of OC x IC x 1 x 1 filter, with a non-zero 4x4 block.
+const int kIC = 8;
+const int kOC = 8;
+const int kHW = 3;
+
+SparseWeightConvertPass* SparsePass() {
+  auto* pass = PassManager::Global().LookUp<SparseWeightConvertPass>(
+      "sparse_weight_convert_pass");
+  CHECK(pass);
+  return pass;
+}
+
+// Set the threshold of the pass and restore it on leaving the scope.
+class ThresholdGuard {
+ public:
+  explicit ThresholdGuard(float threshold)
+      : threshold_(SparsePass()->sparse_threshold()) {
+    SparsePass()->SetSparseThreshold(threshold);
+  }
+  ~ThresholdGuard() { SparsePass()->SetSparseThreshold(threshold_); }
+
+ private:
+  float threshold_;
+};
+
+void AddVar(cpp::BlockDesc* block, const std::string& name, bool persistable) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var->SetDataType(VarDescAPI::Type::FP32);
+  var->SetPersistable(persistable);
+}
+
+// feed -> op -> fetch, where `w` and `b` are the persistable weight and bias
+// of the op, which is set up by `set_op`.
+std::shared_ptr<cpp::ProgramDesc> BuildProgram(
+    const std::function<void(cpp::OpDesc*)>& set_op) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block = program_desc->AddBlock<cpp::BlockDesc>();
+  block->SetIdx(0);
+  block->SetParentIdx(-1);
+  AddVar(block, "x", false);
+  AddVar(block, "out", false);
+  AddVar(block, "w", true);
+  AddVar(block, "b", true);
+  auto* feed = block->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+  set_op(block->AddOp<cpp::OpDesc>());
+  auto* fetch = block->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int>("col", 0);
+  return program_desc;
+}
+
+std::shared_ptr<cpp::ProgramDesc> FcProgram(const std::string& act) {
+  return BuildProgram([&](cpp::OpDesc* op) {
+    op->SetType("fc");
+    op->SetInput("Input", {"x"});
+    op->SetInput("W", {"w"});
+    op->SetInput("Bias", {"b"});
+    op->SetOutput("Out", {"out"});
+    op->SetAttr<int>("in_num_col_dims", 1);
+    op->SetAttr<std::string>("activation_type", act);
+  });
+}
+
+std::shared_ptr<cpp::ProgramDesc> ConvProgram(int stride) {
+  return BuildProgram([&](cpp::OpDesc* op) {
+    op->SetType("conv2d");
+    op->SetInput("Input", {"x"});
+    op->SetInput("Filter", {"w"});
+    op->SetInput("Bias", {"b"});
+    op->SetOutput("Output", {"out"});
+    op->SetAttr<std::vector<int>>("strides", {stride, stride});
+    op->SetAttr<std::vector<int>>("paddings", {0, 0});
+    op->SetAttr<std::vector<int>>("dilations", {1, 1});
+    op->SetAttr<int>("groups", 1);
+  });
+}
+
+// The K x N weight of the fc, its transpose is non-zero at the row 0 and the
+// columns 0 to 3, and the row 5 and the columns 4 to 7. The 1x4 blocks are
+// picked for it, while the 4x1 ones would be picked if it were not
+// transposed.
+void FillFcParams(Scope* scope) {
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({kK, kN});
+  auto* w_data = w->mutable_data<float>();
+  for (int k = 0; k < kK; k++) {
+    for (int n = 0; n < kN; n++) {
+      bool non_zero = (n == 0 && k < 4) || (n == 5 && k >= 4);
+      w_data[k * kN + n] = non_zero ? 0.1f * (k + n % 3) + 0.2f : 0.f;
+    }
+  }
+  auto* b = scope->Var("b")->GetMutable<Tensor>();
+  b->Resize({kN});
+  auto* b_data = b->mutable_data<float>();
+  for (int n = 0; n < kN; n++) {
+    b_data[n] = 0.05f * (n % 4) - 0.1f;
+  }
+}
+
+// The OC x IC x 1 x 1 filter, which is non-zero at the output channels 4 to 7
+// and the input channels 0 to 3, so the 4x4 blocks are picked for it.
+void FillConvParams(Scope* scope) {
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({kOC, kIC, 1, 1});
+  auto* w_data = w->mutable_data<float>();
+  for (int o = 0; o < kOC; o++) {
+    for (int c = 0; c < kIC; c++) {
+      bool non_zero = o >= 4 && c < 4;
+      w_data[o * kIC + c] = non_zero ? 0.1f * ((o + c) % 5) - 0.15f : 0.f;
+    }
+  }
+  auto* b = scope->Var("b")->GetMutable<Tensor>();
+  b->Resize({kOC});
+  auto* b_data = b->mutable_data<float>();
+  for (int o = 0; o < kOC; o++) {
+    b_data[o] = 0.1f * (o % 3);
+  }
+}
+
+// The ops of the graph are attached to the scope, which should outlive it.
+std::unique_ptr<SSAGraph> BuildGraph(
+    const std::shared_ptr<cpp::ProgramDesc>& program_desc,
+    const std::function<void(Scope*)>& fill_params,
+    const std::shared_ptr<Scope>& scope) {
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)}};
+  fill_params(scope.get());
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  return graph;
+}
+
+std::vector<const Node*> FindStmts(const SSAGraph& graph,
+                                   const std::string& op_type) {
+  std::vector<const Node*> stmts;
+  for (auto& node : graph.nodes()) {
+    if (node.IsStmt() && node.stmt()->op_type() == op_type) {
+      stmts.push_back(&node);
+    }
+  }
+  return stmts;
+}
+
+bool HasArg(const SSAGraph& graph, const std::string& name) {
+  for (auto& node : graph.nodes()) {
+    if (node.IsArg() && node.arg()->name == name) return true;
+  }
+  return false;
+}
+
+// Run the program with the pass of the given threshold, return the output and
+// the types of the ops run.
+std::vector<float> RunProgram(
+    const std::shared_ptr<cpp::ProgramDesc>& program_desc,
+    const std::function<void(Scope*)>& fill_params,
+    float threshold,
+    const std::vector<int64_t>& input_shape,
+    std::vector<std::string>* op_types) {
+  ThresholdGuard guard(threshold);
+  Predictor predictor;
+  fill_params(predictor.scope());
+  predictor.Build(program_desc, {Place{TARGET(kX86), PRECISION(kFloat)}});
+  auto* input = predictor.GetInput(0);
+  input->Resize(input_shape);
+  auto* input_data = input->mutable_data<float>();
+  for (int64_t i = 0; i < input->numel(); i++) {
+    input_data[i] = static_cast<float>(i % 9) * 0.25f - 1.f;
+  }
+  predictor.Run();
+  op_types->clear();
+  for (auto& inst : predictor.runtime_program().instructions()) {
+    op_types->push_back(inst.op()->op_info()->Type());
+  }
+  auto* output = predictor.GetOutput(0);
+  return std::vector<float>(output->data<float>(),
+                            output->data<float>() + output->numel());
+}
+
+bool Contains(const std::vector<std::string>& op_types,
+              const std::string& op_type) {
+  return std::find(op_types.begin(), op_types.end(), op_type) !=
+         op_types.end();
+}
+
+void ExpectNear(const std::vector<float>& x, const std::vector<float>& y) {
+  ASSERT_EQ(x.size(), y.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_NEAR(x[i], y[i], 1e-5f * (1.f + std::fabs(y[i])));
+  }
+}
+
+}  // namespace
+
+TEST(sparse_weight_convert_pass, pick_block_shape) {
+  // An 8x8 matrix with a single non-zero 4x4 block.
+  std::vector<float> dense(64, 0.f);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      dense[i * 8 + j] = 1.f + i + j;
+    }
+  }
+  float sparsity = 0.f;
+  EXPECT_EQ(SparseWeightConvertPass::PickBlockShape(
+                dense.data(), 8, 8, 0.7f, &sparsity),
+            std::vector<int>({4, 4}));
+  EXPECT_FLOAT_EQ(sparsity, 0.75f);
+  // It's not sparse enough.
+  EXPECT_TRUE(SparseWeightConvertPass::PickBlockShape(
+                  dense.data(), 8, 8, 0.8f, &sparsity)
+                  .empty());
+
+  // A single non-zero element prefers the 1x1 blocks.
+  std::vector<float> single(64, 0.f);
+  single[9] = 2.f;
+  EXPECT_EQ(SparseWeightConvertPass::PickBlockShape(
+                single.data(), 8, 8, 0.7f, &sparsity),
+            std::vector<int>({1, 1}));
+  EXPECT_FLOAT_EQ(sparsity, 63.f / 64.f);
+
+  // An all-zero matrix is not converted.
+  std::vector<float> zeros(64, 0.f);
+  EXPECT_TRUE(SparseWeightConvertPass::PickBlockShape(
+                  zeros.data(), 8, 8, 0.f, &sparsity)
+                  .empty());
+}
+
+TEST(sparse_weight_convert_pass, to_block_sparse) {
+  // The 2x4 matrix in the 1x2 blocks.
+  std::vector<float> dense = {0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+  std::vector<float> values;
+  std::vector<int32_t> col_index;
+  std::vector<int32_t> row_offset;
+  SparseWeightConvertPass::ToBlockSparse(
+      dense.data(), 2, 4, 1, 2, &values, &col_index, &row_offset);
+  EXPECT_EQ(values, std::vector<float>({1.f, 0.f}));
+  EXPECT_EQ(col_index, std::vector<int32_t>({2}));
+  EXPECT_EQ(row_offset, std::vector<int32_t>({0, 1, 1}));
+}
+
+TEST(sparse_weight_convert_pass, convert_fc) {
+  ThresholdGuard guard(0.7f);
+  auto scope = std::make_shared<Scope>();
+  auto graph = BuildGraph(FcProgram("relu"), FillFcParams, scope);
+  SparsePass()->Apply(graph);
+  EXPECT_TRUE(FindStmts(*graph, "fc").empty());
+  auto stmts = FindStmts(*graph, "sparse_fc");
+  ASSERT_EQ(stmts.size(), 1u);
+  auto* op_info = stmts.front()->stmt()->op_info();
+  // The weight of K x N is converted as N x K.
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("sparse_shape"),
+            std::vector<int>({kN, kK}));
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("block_shape"),
+            std::vector<int>({1, 4}));
+  EXPECT_EQ(op_info->GetAttr<std::string>("activation_type"), "relu");
+  // The dense weight is replaced by the persistable sparse ones.
+  EXPECT_FALSE(HasArg(*graph, "w"));
+  for (auto& name :
+       {"w_sparse_values", "w_sparse_col_index", "w_sparse_row_offset"}) {
+    EXPECT_TRUE(HasArg(*graph, name));
+  }
+  EXPECT_TRUE(HasArg(*graph, "b"));
+}
+
+TEST(sparse_weight_convert_pass, convert_conv2d) {
+  ThresholdGuard guard(0.7f);
+  auto scope = std::make_shared<Scope>();
+  auto graph = BuildGraph(ConvProgram(1), FillConvParams, scope);
+  SparsePass()->Apply(graph);
+  EXPECT_TRUE(FindStmts(*graph, "conv2d").empty());
+  auto stmts = FindStmts(*graph, "sparse_conv2d");
+  ASSERT_EQ(stmts.size(), 1u);
+  auto* op_info = stmts.front()->stmt()->op_info();
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("sparse_shape"),
+            std::vector<int>({kOC, kIC}));
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("block_shape"),
+            std::vector<int>({4, 4}));
+  EXPECT_FALSE(HasArg(*graph, "w"));
+}
+
+TEST(sparse_weight_convert_pass, keep_unsupported_ops) {
+  // The ratio of the zero blocks is 11/12, which is below the threshold.
+  {
+    ThresholdGuard guard(0.95f);
+    auto scope = std::make_shared<Scope>();
+    auto graph = BuildGraph(FcProgram("relu"), FillFcParams, scope);
+    SparsePass()->Apply(graph);
+    EXPECT_EQ(FindStmts(*graph, "fc").size(), 1u);
+    EXPECT_TRUE(HasArg(*graph, "w"));
+  }
+  ThresholdGuard guard(0.7f);
+  // The activation isn't supported by sparse_fc.
+  auto fc_scope = std::make_shared<Scope>();
+  auto fc_graph = BuildGraph(FcProgram("sigmoid"), FillFcParams, fc_scope);
+  SparsePass()->Apply(fc_graph);
+  EXPECT_EQ(FindStmts(*fc_graph, "fc").size(), 1u);
+  EXPECT_TRUE(FindStmts(*fc_graph, "sparse_fc").empty());
+  // The strided conv2d isn't supported by sparse_conv2d.
+  auto conv_scope = std::make_shared<Scope>();
+  auto conv_graph = BuildGraph(ConvProgram(2), FillConvParams, conv_scope);
+  SparsePass()->Apply(conv_graph);
+  EXPECT_EQ(FindStmts(*conv_graph, "conv2d").size(), 1u);
+  EXPECT_TRUE(FindStmts(*conv_graph, "sparse_conv2d").empty());
+}
+
+TEST(sparse_weight_convert_pass, run_fc) {
+  std::vector<std::string> op_types;
+  // No op is converted if the threshold is greater than 1.
+  auto ref =
+      RunProgram(FcProgram("relu"), FillFcParams, 1.1f, {kM, kK}, &op_types);
+  EXPECT_TRUE(Contains(op_types, "fc"));
+  auto out =
+      RunProgram(FcProgram("relu"), FillFcParams, 0.7f, {kM, kK}, &op_types);
+  EXPECT_TRUE(Contains(op_types, "sparse_fc"));
+  EXPECT_FALSE(Contains(op_types, "fc"));
+  ExpectNear(out, ref);
+}
+
+TEST(sparse_weight_convert_pass, run_conv2d) {
+  std::vector<std::string> op_types;
+  const std::vector<int64_t> input_shape{1, kIC, kHW, kHW};
+  auto ref =
+      RunProgram(ConvProgram(1), FillConvParams, 1.1f, input_shape, &op_types);
+  EXPECT_TRUE(Contains(op_types, "conv2d"));
+  auto out =
+      RunProgram(ConvProgram(1), FillConvParams, 0.7f, input_shape, &op_types);
+  EXPECT_TRUE(Contains(op_types, "sparse_conv2d"));
+  EXPECT_FALSE(Contains(op_types, "conv2d"));
+  ExpectNear(out, ref);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -180,6 +180,22 @@ class KernelFactory {
     return ss.str();
   }
 
+  // The places and the numbers of the kernels of all of the ops, it tells
+  // apart the libraries built with different kernel sets.
+  std::string KernelsSignature() const {
+    STL::stringstream ss;
+    for (const auto& item : op_registry_) {
+      for (const auto& kernels : item.second) {
+        ss << item.first << ","
+           << static_cast<int>(std::get<0>(kernels.first)) << ","
+           << static_cast<int>(std::get<1>(kernels.first)) << ","
+           << static_cast<int>(std::get<2>(kernels.first)) << ":"
+           << kernels.second.size() << ";";
+      }
+    }
+    return ss.str();
+  }
+
  protected:
   // Outer map: op -> a map of kernel.
   // Inner map: kernel -> creator function.
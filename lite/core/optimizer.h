@@ -110,6 +110,7 @@ class Optimizer {
          "lite_sequence_reverse_embedding_fuse_pass",   //
          "elementwise_mul_constant_eliminate_pass",     //
          "lite_sequence_pool_concat_fuse_pass",         //
+         "lite_embedding_seq_pool_fuse_pass",           //
          "lite_scale_activation_fuse_pass",             //
          "lite_scaleacts_fuse_pass",                    //
          "lite_elementwise_scale_fuse_pass",            //
@@ -143,6 +144,9 @@ class Optimizer {
          "__xpu__generate_sequence_fuse_pass",
          "__xpu__logit_fuse_pass",
          "ssd_boxes_calc_offline_pass",
+         // Convert the fc, mul and conv2d with the pruned weights to the block
+         // sparse ops after all of the fusions.
+         "sparse_weight_convert_pass",
          // Only for fully quantized model, infer the output scale and fix the
          // attribute 'enable_int8' for all of the quantized ops.
          "quantized_op_attributes_inference_pass",
@@ -224,11 +228,12 @@ class Optimizer {
 
     // multi_stream_analysis_pass must be in the front of
     // runtime_context_assign_pass
-    // post_quant_dynamic_pass must be in the behind of
-    // lite_quant_dequant_fuse_pass
+    // post_quant_dynamic_pass and post_quant_static_pass must be in the
+    // behind of lite_quant_dequant_fuse_pass
     const std::string msa_pass{"multi_stream_analysis_pass"};
     const std::string msa_depend_pass{"runtime_context_assign_pass"};
     const std::string pqd_pass{"post_quant_dynamic_pass"};
+    const std::string pqs_pass{"post_quant_static_pass"};
     const std::string pqd_depend_pass{"lite_quant_dequant_fuse_pass"};
     const std::string fp16_pass{"fp16_attribute_pass"};
     for (const std::string& pass : passes) {
@@ -237,11 +242,11 @@ class Optimizer {
             passes_local.begin(), passes_local.end(), msa_depend_pass);
         CHECK(iter != passes_local.end()) << "No find " << msa_depend_pass;
         passes_local.insert(iter, msa_pass);
-      } else if (pass == pqd_pass) {
+      } else if (pass == pqd_pass || pass == pqs_pass) {
         auto iter = std::find(
             passes_local.begin(), passes_local.end(), pqd_depend_pass);
         CHECK(iter != passes_local.end()) << "No find " << pqd_depend_pass;
-        passes_local.insert(iter + 1, pqd_pass);
+        passes_local.insert(iter + 1, pass);
       } else {
         passes_local.push_back(pass);
       }
@@ -262,6 +267,14 @@ class Optimizer {
 
   const Scope* exec_scope() const { return exec_scope_; }
 
+  // Skip the given passes in the following runs.
+  void DisablePasses(const std::vector<std::string>& passes) {
+    disabled_passes_.insert(passes.begin(), passes.end());
+  }
+  bool IsPassDisabled(const std::string& pass) const {
+    return disabled_passes_.count(pass) > 0;
+  }
+
   // Generate a new program based on the mir graph.
   std::unique_ptr<RuntimeProgram> GenRuntimeProgram() {
     auto pass = mir::PassManager::Global().LookUp<mir::GenerateProgramPass>(
@@ -327,6 +340,10 @@ class Optimizer {
   // Specify the passes and run them.
   void RunPasses(const std::vector<std::string>& passes) {
     for (auto& x : passes) {
+      if (disabled_passes_.count(x)) {
+        LOG(INFO) << "   - Skip " << x << " because the pass is disabled.";
+        continue;
+      }
       LOG(INFO) << "== Running pass: " << x;
       mir::Pass* pass = mir::PassManager::Global().LookUp(x);
       if (!pass) {
@@ -361,6 +378,7 @@ class Optimizer {
   std::vector<Place> valid_places_;
   Scope* exec_scope_{};
   Program* program_{};
+  std::set<std::string> disabled_passes_;
 };
 
 }  // namespace lite
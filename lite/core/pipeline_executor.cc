@@ -0,0 +1,462 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/pipeline_executor.h"
+#include <algorithm>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstring>
+#include <map>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
+    !(defined __APPLE__)
+#include <omp.h>
+#endif
+#ifdef LITE_WITH_ARM
+#include "lite/core/device_info.h"
+#endif
+
+namespace paddle {
+namespace lite {
+
+namespace {
+// The cores the calling thread is allowed to run on, in ascending order.
+std::vector<int> AllowedCpuIds() {
+  std::vector<int> cpu_ids;
+#if defined(__linux__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+    for (int cpu_id = 0; cpu_id < CPU_SETSIZE; cpu_id++) {
+      if (CPU_ISSET(cpu_id, &mask)) cpu_ids.push_back(cpu_id);
+    }
+    return cpu_ids;
+  }
+#endif
+  int num_cores = static_cast<int>(std::thread::hardware_concurrency());
+  for (int cpu_id = 0; cpu_id < num_cores; cpu_id++) {
+    cpu_ids.push_back(cpu_id);
+  }
+  return cpu_ids;
+}
+}  // namespace
+
+// The progress of the requests of a Run call.
+struct PipelineExecutor::Batch {
+  std::vector<std::vector<Tensor>>* outputs;
+  std::mutex mutex;
+  std::condition_variable cond;
+  int in_flight{0};
+  int done{0};
+};
+
+PipelineExecutor::PipelineExecutor(
+    const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+    Scope* exec_scope,
+    const std::vector<std::string>& input_names,
+    const std::vector<std::string>& output_names,
+    const std::vector<double>& costs,
+    int num_stages,
+    int threads_per_stage,
+    bool bind_cores)
+    : exec_scope_(exec_scope), threads_per_stage_(threads_per_stage) {
+  CHECK(program_desc);
+  CHECK(exec_scope_);
+  CHECK_GE(num_stages, 1) << "The number of stages should be positive.";
+  CHECK_GE(threads_per_stage_, 1)
+      << "The number of threads should be positive.";
+  auto* block = program_desc->GetBlock<cpp::BlockDesc>(kRootBlockIdx);
+  int num_ops = static_cast<int>(block->OpsSize());
+  CHECK_EQ(costs.size(), static_cast<size_t>(num_ops))
+      << "The costs should be given for all of the instructions.";
+
+  // The variables which are not tensors, e.g. the tensor arrays, can't be
+  // handed over, so that the instructions from the first write to the last
+  // access of them are kept in the same stage.
+  std::vector<bool> no_cut(num_ops, false);
+  std::map<std::string, std::pair<int, int>> spans;
+  for (int idx = 0; idx < num_ops; idx++) {
+    auto* op = block->GetOp<cpp::OpDesc>(idx);
+    auto in_names = op->input_vars();
+    auto out_names = op->output_vars();
+    for (auto& name : out_names) {
+      auto* var = exec_scope_->FindVar(name);
+      if (var && !var->IsType<Tensor>() && !spans.count(name)) {
+        spans[name] = std::make_pair(idx, idx);
+      }
+    }
+    in_names.insert(in_names.end(), out_names.begin(), out_names.end());
+    for (auto& name : in_names) {
+      auto it = spans.find(name);
+      if (it != spans.end()) it->second.second = idx;
+    }
+  }
+  for (auto& span : spans) {
+    for (int idx = span.second.first; idx < span.second.second; idx++) {
+      no_cut[idx] = true;
+    }
+  }
+
+  auto ranges = Partition(costs, no_cut, num_stages);
+  num_slots_ = static_cast<int>(ranges.size()) + 1;
+  BuildStages(program_desc, ranges, input_names, output_names);
+
+  // Bind the stages to the disjoint groups of the cores allowed for the
+  // process, e.g. by taskset or the cgroups.
+  auto cpu_ids = AllowedCpuIds();
+  size_t num_bound = stages_.size() * threads_per_stage_;
+  if (bind_cores && num_bound <= cpu_ids.size()) {
+    for (size_t i = 0; i < stages_.size(); i++) {
+      for (int j = 0; j < threads_per_stage_; j++) {
+        stages_[i]->cpu_ids.push_back(cpu_ids[i * threads_per_stage_ + j]);
+      }
+    }
+  }
+  for (auto& stage : stages_) {
+    stage->thread.reset(new ThreadPool(1));
+  }
+}
+
+PipelineExecutor::~PipelineExecutor() {
+  // Join the threads before the programs are destroyed.
+  for (auto& stage : stages_) {
+    stage->thread.reset();
+  }
+}
+
+std::vector<std::pair<int, int>> PipelineExecutor::Partition(
+    const std::vector<double>& costs,
+    const std::vector<bool>& no_cut,
+    int num_stages) {
+  int num_insts = static_cast<int>(costs.size());
+  CHECK_GT(num_insts, 0);
+  CHECK_EQ(no_cut.size(), costs.size());
+  // Merge the instructions which can't be cut apart into units.
+  std::vector<int> unit_begins;
+  std::vector<double> unit_costs;
+  for (int idx = 0; idx < num_insts; idx++) {
+    if (idx == 0 || !no_cut[idx - 1]) {
+      unit_begins.push_back(idx);
+      unit_costs.push_back(0.);
+    }
+    unit_costs.back() += std::max(costs[idx], 0.);
+  }
+  int num_units = static_cast<int>(unit_costs.size());
+  // Return the first units of the ranges, whose costs are at most `limit`
+  // unless it's of a single unit.
+  auto split = [&](double limit) {
+    std::vector<int> firsts;
+    double sum = 0.;
+    for (int unit = 0; unit < num_units; unit++) {
+      if (firsts.empty() || (sum > 0. && sum + unit_costs[unit] > limit)) {
+        firsts.push_back(unit);
+        sum = 0.;
+      }
+      sum += unit_costs[unit];
+    }
+    return firsts;
+  };
+  // Binary search the minimal cost of the most expensive range.
+  double lo = *std::max_element(unit_costs.begin(), unit_costs.end());
+  double hi = 0.;
+  for (auto cost : unit_costs) hi += cost;
+  for (int iter = 0; iter < 64 && hi - lo > 1e-6 * hi; iter++) {
+    double mid = (lo + hi) / 2;
+    if (static_cast<int>(split(mid).size()) <= num_stages) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  auto firsts = split(hi);
+  std::vector<std::pair<int, int>> ranges;
+  for (size_t i = 0; i < firsts.size(); i++) {
+    int end = i + 1 < firsts.size() ? unit_begins[firsts[i + 1]] : num_insts;
+    ranges.emplace_back(unit_begins[firsts[i]], end);
+  }
+  return ranges;
+}
+
+std::vector<double> PipelineExecutor::ProfileCosts(RuntimeProgram* program,
+                                                   int repeats) {
+  CHECK(program);
+  auto* insts = program->mutable_instructions(kRootBlockIdx);
+  std::vector<double> costs(insts->size(), 0.);
+  for (int i = 0; i < repeats; i++) {
+    for (size_t idx = 0; idx < insts->size(); idx++) {
+      auto& inst = (*insts)[idx];
+      if (inst.is_feed_fetch_op()) continue;
+      auto start = std::chrono::steady_clock::now();
+      inst.Run();
+      auto end = std::chrono::steady_clock::now();
+      costs[idx] +=
+          std::chrono::duration<double, std::milli>(end - start).count();
+    }
+  }
+  return costs;
+}
+
+void PipelineExecutor::BuildStages(
+    const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+    const std::vector<std::pair<int, int>>& ranges,
+    const std::vector<std::string>& input_names,
+    const std::vector<std::string>& output_names) {
+  auto* block = program_desc->GetBlock<cpp::BlockDesc>(kRootBlockIdx);
+  auto is_feed_fetch = [](const cpp::OpDesc* op) {
+    return op->Type() == "feed" || op->Type() == "fetch";
+  };
+  std::map<std::pair<std::string, int>, int> boundary_ids;
+  auto boundary_of = [&](const std::string& name, int producer) {
+    auto key = std::make_pair(name, producer);
+    auto it = boundary_ids.find(key);
+    if (it != boundary_ids.end()) return it->second;
+    Boundary boundary;
+    boundary.name = name;
+    boundary.producer = producer;
+    boundary.slots.resize(num_slots_);
+    for (auto& slot : boundary.slots) {
+      slot.buffer = std::make_shared<Buffer>();
+    }
+    boundaries_.push_back(std::move(boundary));
+    int id = static_cast<int>(boundaries_.size()) - 1;
+    boundary_ids[key] = id;
+    return id;
+  };
+  auto add_unique = [](std::vector<int>* ids, int id) {
+    if (std::find(ids->begin(), ids->end(), id) == ids->end()) {
+      ids->push_back(id);
+    }
+  };
+
+  // A stage reads the value written by the last writer before it, which is
+  // handed over if it's another stage, -1 stands for the inputs.
+  std::map<std::string, int> last_writer;
+  for (auto& name : input_names) {
+    last_writer[name] = -1;
+    inputs_.push_back(boundary_of(name, -1));
+  }
+  for (size_t s = 0; s < ranges.size(); s++) {
+    std::unique_ptr<Stage> stage(new Stage);
+    stage->range = ranges[s];
+    stages_.push_back(std::move(stage));
+  }
+  for (size_t s = 0; s < ranges.size(); s++) {
+    for (int idx = ranges[s].first; idx < ranges[s].second; idx++) {
+      auto* op = block->GetOp<cpp::OpDesc>(idx);
+      if (is_feed_fetch(op)) continue;
+      for (auto& name : op->input_vars()) {
+        auto it = last_writer.find(name);
+        if (it == last_writer.end() || it->second >= static_cast<int>(s)) {
+          continue;
+        }
+        int id = boundary_of(name, it->second);
+        add_unique(&stages_[s]->inputs, id);
+        if (it->second >= 0) add_unique(&stages_[it->second]->outputs, id);
+      }
+      for (auto& name : op->output_vars()) {
+        last_writer[name] = s;
+      }
+    }
+  }
+  for (auto& name : output_names) {
+    auto it = last_writer.find(name);
+    CHECK(it != last_writer.end()) << "The output " << name
+                                   << " is not written by the program.";
+    int id = boundary_of(name, it->second);
+    outputs_.push_back(id);
+    if (it->second >= 0) add_unique(&stages_[it->second]->outputs, id);
+  }
+
+  for (auto& stage : stages_) {
+    // The variables written by the program are local to the stages, and the
+    // others, e.g. the weights, are shared.
+    stage->scope = &exec_scope_->NewScope();
+    for (auto& item : last_writer) {
+      auto* src = exec_scope_->FindVar(item.first);
+      auto* dst = stage->scope->LocalVar(item.first);
+      if (src && src->IsType<Tensor>()) {
+        auto& src_tensor = src->Get<Tensor>();
+        auto* dst_tensor = dst->GetMutable<Tensor>();
+        dst_tensor->Resize(src_tensor.dims());
+        dst_tensor->set_precision(src_tensor.precision());
+      } else if (src && src->IsType<std::vector<Tensor>>()) {
+        dst->GetMutable<std::vector<Tensor>>();
+      }
+    }
+    auto desc = std::make_shared<cpp::ProgramDesc>();
+    desc->CopyFrom(*program_desc);
+    auto* stage_block = desc->GetBlock<cpp::BlockDesc>(kRootBlockIdx);
+    stage_block->ClearOps();
+    for (int idx = stage->range.first; idx < stage->range.second; idx++) {
+      auto* op = block->GetOp<cpp::OpDesc>(idx);
+      if (is_feed_fetch(op)) continue;
+      *stage_block->AddOp<cpp::OpDesc>() = *op;
+    }
+    stage->program.reset(
+        new RuntimeProgram(desc, stage->scope, kRootBlockIdx));
+  }
+  VLOG(3) << "Split the program into " << stages_.size() << " stages with "
+          << boundaries_.size() << " boundary tensors.";
+}
+
+void PipelineExecutor::PrepareThread(Stage* stage) {
+#if defined(__linux__)
+  if (!stage->cpu_ids.empty()) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (auto cpu_id : stage->cpu_ids) {
+      CPU_SET(cpu_id, &mask);
+    }
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+      LOG(WARNING) << "Failed to bind the pipeline stage to the cores.";
+    }
+  }
+#endif
+#ifdef LITE_WITH_ARM
+  DeviceInfo::Init();
+  DeviceInfo::Global().SetRunMode(lite_api::LITE_POWER_NO_BIND,
+                                  threads_per_stage_);
+#endif
+#if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
+    !(defined __APPLE__)
+  omp_set_num_threads(threads_per_stage_);
+#endif
+}
+
+void PipelineExecutor::RunStage(int stage_idx, int request, Batch* batch) {
+  auto& stage = *stages_[stage_idx];
+  if (!stage.thread_prepared) {
+    PrepareThread(&stage);
+    stage.thread_prepared = true;
+  }
+  int slot_idx = request % num_slots_;
+  auto tensor_of = [&](const std::string& name) {
+    auto* var = stage.scope->FindLocalVar(name);
+    CHECK(var) << "No variable " << name << " in the stage scope.";
+    return var->GetMutable<Tensor>();
+  };
+  std::vector<std::string> in_names;
+  for (int id : stage.inputs) {
+    auto& boundary = boundaries_[id];
+    auto& slot = boundary.slots[slot_idx];
+    auto* tensor = tensor_of(boundary.name);
+    tensor->ShareExternalBuffer(slot.buffer);
+    tensor->Resize(slot.dims);
+    tensor->set_lod(slot.lod);
+    tensor->set_precision(slot.precision);
+    tensor->mutable_data(slot.memory_size);
+    in_names.push_back(boundary.name);
+  }
+  // Let the kernels write the outputs into the slots directly, unless they're
+  // read from the slots of the other boundaries.
+  for (int id : stage.outputs) {
+    auto& boundary = boundaries_[id];
+    if (std::find(in_names.begin(), in_names.end(), boundary.name) !=
+        in_names.end()) {
+      continue;
+    }
+    auto& slot = boundary.slots[slot_idx];
+    tensor_of(boundary.name)->ShareExternalBuffer(slot.buffer);
+  }
+
+  stage.program->Run();
+
+  for (int id : stage.outputs) {
+    auto& boundary = boundaries_[id];
+    auto& slot = boundary.slots[slot_idx];
+    auto* tensor = tensor_of(boundary.name);
+    slot.dims = tensor->dims();
+    slot.lod = tensor->lod();
+    slot.precision = tensor->precision();
+    slot.memory_size = tensor->memory_size();
+    if (slot.memory_size > 0 && tensor->raw_data() != slot.buffer->data()) {
+      slot.buffer->ResetLazy(TARGET(kHost), slot.memory_size);
+      memcpy(slot.buffer->data(), tensor->raw_data(), slot.memory_size);
+    }
+  }
+
+  if (stage_idx + 1 < num_stages()) {
+    stages_[stage_idx + 1]->thread->Enqueue([this, stage_idx, request, batch] {
+      RunStage(stage_idx + 1, request, batch);
+    });
+    return;
+  }
+  auto& outputs = (*batch->outputs)[request];
+  outputs.resize(outputs_.size());
+  for (size_t i = 0; i < outputs_.size(); i++) {
+    auto& slot = boundaries_[outputs_[i]].slots[slot_idx];
+    auto& output = outputs[i];
+    output.Resize(slot.dims);
+    output.set_lod(slot.lod);
+    output.set_precision(slot.precision);
+    if (slot.memory_size > 0) {
+      memcpy(output.mutable_data(TARGET(kHost), slot.memory_size),
+             slot.buffer->data(),
+             slot.memory_size);
+    }
+  }
+  std::lock_guard<std::mutex> lock(batch->mutex);
+  batch->in_flight--;
+  batch->done++;
+  batch->cond.notify_all();
+}
+
+void PipelineExecutor::Run(
+    const std::vector<std::vector<const Tensor*>>& inputs,
+    std::vector<std::vector<Tensor>>* outputs) {
+  CHECK(outputs);
+  int num_requests = static_cast<int>(inputs.size());
+  outputs->clear();
+  outputs->resize(num_requests);
+  Batch batch;
+  batch.outputs = outputs;
+  for (int request = 0; request < num_requests; request++) {
+    CHECK_EQ(inputs[request].size(), inputs_.size())
+        << "The request " << request << " should have " << inputs_.size()
+        << " inputs.";
+    {
+      // The slots of the request are free once the request num_slots_ ahead
+      // of it is done.
+      std::unique_lock<std::mutex> lock(batch.mutex);
+      batch.cond.wait(lock, [&] { return batch.in_flight < num_slots_; });
+      batch.in_flight++;
+    }
+    int slot_idx = request % num_slots_;
+    for (size_t i = 0; i < inputs_.size(); i++) {
+      const Tensor* input = inputs[request][i];
+      CHECK(input) << "The input " << i << " of request " << request
+                   << " is null.";
+      auto& slot = boundaries_[inputs_[i]].slots[slot_idx];
+      slot.dims = input->dims();
+      slot.lod = input->lod();
+      slot.precision = input->precision();
+      slot.memory_size = input->memory_size();
+      if (slot.memory_size > 0) {
+        slot.buffer->ResetLazy(TARGET(kHost), slot.memory_size);
+        memcpy(slot.buffer->data(), input->raw_data(), slot.memory_size);
+      }
+    }
+    stages_[0]->thread->Enqueue(
+        [this, request, &batch] { RunStage(0, request, &batch); });
+  }
+  std::unique_lock<std::mutex> lock(batch.mutex);
+  batch.cond.wait(lock, [&] { return batch.done == num_requests; });
+}
+
+}  // namespace lite
+}  // namespace paddle
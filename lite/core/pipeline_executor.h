@@ -0,0 +1,146 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/program.h"
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+#include "lite/core/thread_pool.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * PipelineExecutor streams the requests of a model through the stages of it,
+ * so that the throughput approaches the number of stages times the rate of the
+ * slowest stage.
+ *
+ * The instructions of the root block are partitioned into contiguous stages
+ * balanced by the profiled costs, each stage is a RuntimeProgram over its own
+ * child scope of the execution scope, and runs on its own thread, which is
+ * bound to a group of cores when possible, so that the weights of a stage stay
+ * in the caches of its cores.
+ *
+ * The tensors produced by a stage and consumed by the following ones are
+ * handed over through the slot buffers instead of the tensors of the scopes.
+ * The request r uses the slot r % (num_stages + 1) of every boundary tensor,
+ * i.e. a stage writes the slot of the next request while its consumers read
+ * the one of the previous request, and no more than num_stages + 1 requests
+ * are in flight.
+ *
+ * NOTE: the predictor the program comes from should not run while the pipeline
+ * is running, since the variables not written by the model, e.g. the ones
+ * computed at the optimization time, are shared with its execution scope.
+ */
+class PipelineExecutor {
+ public:
+  // `program_desc` is the optimized program with the kernels picked, e.g.
+  // saved by RuntimeProgram::SaveToProgram, and `exec_scope` is the execution
+  // scope of it. `costs` are the costs of the instructions of the root block,
+  // see ProfileCosts. Each stage runs with `threads_per_stage` intra-op
+  // threads, and the stages are bound to the disjoint groups of the cores
+  // allowed by the affinity mask if `bind_cores` is true and there are enough
+  // of them.
+  PipelineExecutor(const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+                   Scope* exec_scope,
+                   const std::vector<std::string>& input_names,
+                   const std::vector<std::string>& output_names,
+                   const std::vector<double>& costs,
+                   int num_stages,
+                   int threads_per_stage = 1,
+                   bool bind_cores = true);
+  ~PipelineExecutor();
+
+  // Run the requests through the pipeline, `inputs[i]` and `(*outputs)[i]`
+  // are the input and output tensors of the i-th request in the order of the
+  // feed and fetch ops.
+  void Run(const std::vector<std::vector<const Tensor*>>& inputs,
+           std::vector<std::vector<Tensor>>* outputs);
+
+  // The number of stages may be less than the requested one if there are not
+  // enough instructions.
+  int num_stages() const { return static_cast<int>(stages_.size()); }
+  // The range of the instructions of the root block run by the stage.
+  std::pair<int, int> stage_range(int stage) const {
+    return stages_[stage]->range;
+  }
+
+  // Time each instruction of the root block by running the program `repeats`
+  // times with its current inputs, the costs are in milliseconds.
+  static std::vector<double> ProfileCosts(RuntimeProgram* program,
+                                          int repeats = 1);
+
+  // Partition the instructions of the given costs into at most `num_stages`
+  // contiguous ranges, minimizing the cost of the most expensive one. The
+  // ranges are not cut right after the i-th instruction if `no_cut[i]`.
+  static std::vector<std::pair<int, int>> Partition(
+      const std::vector<double>& costs,
+      const std::vector<bool>& no_cut,
+      int num_stages);
+
+ private:
+  // The meta and the buffer of a boundary tensor for a request.
+  struct Slot {
+    std::shared_ptr<Buffer> buffer;
+    DDim dims;
+    LoD lod;
+    PrecisionType precision{PRECISION(kUnk)};
+    size_t memory_size{0};
+  };
+
+  // A tensor handed over from the `producer` stage, -1 for the inputs.
+  struct Boundary {
+    std::string name;
+    int producer;
+    std::vector<Slot> slots;
+  };
+
+  struct Stage {
+    std::pair<int, int> range;
+    Scope* scope{nullptr};
+    std::unique_ptr<RuntimeProgram> program;
+    std::vector<int> inputs;
+    std::vector<int> outputs;
+    std::vector<int> cpu_ids;
+    std::unique_ptr<ThreadPool> thread;
+    bool thread_prepared{false};
+  };
+
+  struct Batch;
+
+  void BuildStages(const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+                   const std::vector<std::pair<int, int>>& ranges,
+                   const std::vector<std::string>& input_names,
+                   const std::vector<std::string>& output_names);
+  void PrepareThread(Stage* stage);
+  void RunStage(int stage_idx, int request, Batch* batch);
+
+  Scope* exec_scope_{nullptr};
+  int threads_per_stage_{1};
+  int num_slots_{0};
+  std::vector<Boundary> boundaries_;
+  std::vector<int> inputs_;
+  std::vector<int> outputs_;
+  std::vector<std::unique_ptr<Stage>> stages_;
+
+  DISALLOW_COPY_AND_ASSIGN(PipelineExecutor);
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,57 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/pipeline_executor.h"
+#include <gtest/gtest.h>
+
+namespace paddle {
+namespace lite {
+
+TEST(pipeline_executor, partition) {
+  std::vector<double> costs = {0, 4, 1, 1, 2, 3, 1, 2, 2, 0};
+  std::vector<bool> no_cut(costs.size(), false);
+  auto ranges = PipelineExecutor::Partition(costs, no_cut, 3);
+  ASSERT_EQ(ranges.size(), 3u);
+  EXPECT_EQ(ranges.front().first, 0);
+  EXPECT_EQ(ranges.back().second, static_cast<int>(costs.size()));
+  double max_cost = 0;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    if (i > 0) EXPECT_EQ(ranges[i].first, ranges[i - 1].second);
+    double cost = 0;
+    for (int idx = ranges[i].first; idx < ranges[i].second; idx++) {
+      cost += costs[idx];
+    }
+    max_cost = std::max(max_cost, cost);
+  }
+  // The optimal split is {4, 1, 1}, {2, 3}, {1, 2, 2}.
+  EXPECT_NEAR(max_cost, 6, 1e-3);
+
+  // Fewer ranges if there are not enough instructions.
+  EXPECT_EQ(PipelineExecutor::Partition({1, 1}, {false, false}, 4).size(), 2u);
+}
+
+TEST(pipeline_executor, partition_no_cut) {
+  std::vector<double> costs = {1, 1, 1, 1, 1, 1};
+  // The instructions 1 to 4 access a tensor array.
+  std::vector<bool> no_cut = {false, true, true, true, false, false};
+  auto ranges = PipelineExecutor::Partition(costs, no_cut, 3);
+  for (auto& range : ranges) {
+    EXPECT_FALSE(range.first > 1 && range.first <= 4);
+  }
+  ASSERT_EQ(ranges.size(), 3u);
+  EXPECT_EQ(ranges[1], std::make_pair(1, 5));
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -15,7 +15,10 @@
 #include "lite/core/program.h"
 
 #include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <map>
+#include <mutex>  // NOLINT
 #include <set>
 
 #include "lite/model_parser/cpp_desc.h"
@@ -25,6 +28,10 @@
 #ifdef LITE_WITH_PRECISION_PROFILE
 #include "lite/core/profile/precision_profiler.h"
 #endif
+#if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
+    !(defined __APPLE__)
+#include <omp.h>
+#endif
 
 namespace paddle {
 namespace lite {
@@ -323,6 +330,25 @@ void RuntimeProgram::SaveOutput() {
 #endif
 
 void RuntimeProgram::Run() {
+#if !defined(LITE_WITH_PROFILE) && !defined(LITE_WITH_PRECISION_PROFILE) && \
+    !defined(LITE_WITH_NVTX) && !defined(LITE_WITH_METAL) &&              \
+    !defined(LITE_WITH_FPGA)
+  if (inter_op_threads_ > 1 && PrepareInterOp()) {
+    RunInterOp();
+    return;
+  }
+#endif
+  RunInstructions(false, true);
+}
+
+void RuntimeProgram::RunBody(bool first_iteration) {
+  if (body_steps_.size() != instructions_[kRootBlockIdx].size()) {
+    PrepareBody();
+  }
+  RunInstructions(true, first_iteration);
+}
+
+void RuntimeProgram::RunInstructions(bool as_body, bool first_iteration) {
 #ifdef LITE_WITH_PRECISION_PROFILE
   auto inst_precision_profiler = paddle::lite::profile::PrecisionProfiler();
   std::string precision_profiler_summary =
@@ -349,6 +375,7 @@ void RuntimeProgram::Run() {
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
     if (inst.is_feed_fetch_op()) continue;
 #endif
+    if (as_body && loop_invariant_[idx] && !first_iteration) continue;
 #ifdef LITE_WITH_NVTX
     NVTXRangeAnnotation annotation = annotator.AnnotateBlock();
     nvtxStringHandle_t registered_name = register_layer_names_[idx];
@@ -367,7 +394,11 @@ void RuntimeProgram::Run() {
     }
 #endif
 
-    inst.Run();
+    if (as_body) {
+      inst.Run(&body_steps_[idx]);
+    } else {
+      inst.Run(plan_ ? &plan_->steps[idx] : nullptr);
+    }
 
 #ifdef LITE_WITH_PRECISION_PROFILE
 #ifndef LITE_WITH_FPGA
@@ -393,6 +424,302 @@ void RuntimeProgram::Run() {
 #endif
 }
 
+void RuntimeProgram::PrepareBody() {
+  // The ops whose outputs may vary across the runs with the same inputs.
+  static const std::set<std::string> kVolatileOps = {
+      "uniform_random", "gaussian_random", "sampling_id", "randperm", "print"};
+  auto& insts = instructions_[kRootBlockIdx];
+  body_steps_.assign(insts.size(), PlanStep());
+  loop_invariant_.assign(insts.size(), false);
+  std::map<std::string, int> num_writers;
+  for (auto& inst : insts) {
+    for (auto& name : inst.op()->op_info()->output_names()) {
+      num_writers[name]++;
+    }
+  }
+  // The variables written by the preceding loop-invariant instructions.
+  std::set<std::string> invariant_vars;
+  for (size_t idx = 0; idx < insts.size(); idx++) {
+    body_steps_[idx].guarded = true;
+    auto& inst = insts[idx];
+    auto* op_info = inst.op()->op_info();
+    auto out_names = op_info->output_names();
+    bool invariant = !inst.is_feed_fetch_op() && !out_names.empty() &&
+                     !op_info->HasAttr("sub_block") &&
+                     !kVolatileOps.count(op_info->Type());
+    for (auto& name : op_info->input_names()) {
+      if (num_writers.count(name) && !invariant_vars.count(name)) {
+        invariant = false;
+      }
+    }
+    for (auto& name : out_names) {
+      if (num_writers[name] != 1) invariant = false;
+    }
+    if (invariant) {
+      invariant_vars.insert(out_names.begin(), out_names.end());
+      VLOG(4) << "Hoist the loop-invariant op " << op_info->Type();
+    }
+    loop_invariant_[idx] = invariant;
+  }
+}
+
+void RuntimeProgram::set_inter_op_threads(int threads) {
+  CHECK_GE(threads, 1) << "The number of inter-op threads should be positive.";
+  if (threads == inter_op_threads_) return;
+  inter_op_threads_ = threads;
+  inter_op_prepared_ = false;
+  inter_op_pool_.reset();
+  if (!lane_workspaces_.empty()) {
+    // Take the kernels back from the workspaces of the lanes.
+    for (auto& inst : instructions_[kRootBlockIdx]) {
+      inst.mutable_kernel()->SetWorkSpace(workspace_.get());
+    }
+    lane_workspaces_.clear();
+  }
+}
+
+bool RuntimeProgram::PrepareInterOp() {
+  if (inter_op_prepared_) return inter_op_enabled_;
+  inter_op_prepared_ = true;
+  inter_op_enabled_ = false;
+  // The kernels of the other targets may keep the thread-local states, e.g.
+  // the ARM device info and the GPU streams.
+  for (auto& block : instructions_) {
+    for (auto& inst : block) {
+      auto target = inst.kernel()->target();
+      if (target != TARGET(kHost) && target != TARGET(kX86)) return false;
+    }
+  }
+  // The outputs of the kernels aliasing the input `X` share its memory, so
+  // that they are treated as the same variable.
+  auto& insts = instructions_[kRootBlockIdx];
+  std::map<std::string, std::string> alias;
+  auto root_of = [&](const std::string& name) {
+    auto it = alias.find(name);
+    return it == alias.end() ? name : it->second;
+  };
+  for (auto& inst : insts) {
+    auto* op_info = inst.op()->op_info();
+    if (!inst.kernel()->AliasesInput() || !op_info->HasInput("X")) continue;
+    auto x_names = op_info->Input("X");
+    if (x_names.empty()) continue;
+    auto root = root_of(x_names.front());
+    for (auto& name : op_info->output_names()) {
+      alias[name] = root;
+    }
+  }
+
+  // Each instruction depends on the last writer of its inputs (RAW), and on
+  // the last writer and the readers since then of its outputs (WAW and WAR).
+  // The control flow ops run their sub-blocks, so they're barriers.
+  int num_insts = static_cast<int>(insts.size());
+  std::vector<std::set<int>> deps(num_insts);
+  std::map<std::string, int> last_writer;
+  std::map<std::string, std::vector<int>> readers;
+  int last_barrier = -1;
+  std::vector<int> since_barrier;
+  for (int idx = 0; idx < num_insts; idx++) {
+    auto* op_info = insts[idx].op()->op_info();
+    auto& dep = deps[idx];
+    if (op_info->HasAttr("sub_block")) {
+      dep.insert(since_barrier.begin(), since_barrier.end());
+      if (last_barrier >= 0) dep.insert(last_barrier);
+      last_barrier = idx;
+      since_barrier.clear();
+      last_writer.clear();
+      readers.clear();
+      continue;
+    }
+    if (last_barrier >= 0) dep.insert(last_barrier);
+    since_barrier.push_back(idx);
+    auto in_names = op_info->input_names();
+    auto out_names = op_info->output_names();
+    for (auto& name : in_names) {
+      auto it = last_writer.find(root_of(name));
+      if (it != last_writer.end()) dep.insert(it->second);
+    }
+    for (auto& name : out_names) {
+      auto root = root_of(name);
+      auto it = last_writer.find(root);
+      if (it != last_writer.end()) dep.insert(it->second);
+      auto& var_readers = readers[root];
+      dep.insert(var_readers.begin(), var_readers.end());
+      var_readers.clear();
+    }
+    for (auto& name : in_names) {
+      readers[root_of(name)].push_back(idx);
+    }
+    for (auto& name : out_names) {
+      last_writer[root_of(name)] = idx;
+    }
+    dep.erase(idx);
+  }
+
+  // Skip the blocks which are a chain of the instructions, i.e. no two
+  // instructions are of the same depth.
+  std::vector<int> depth(num_insts, 0);
+  std::vector<int> width(num_insts + 1, 0);
+  bool has_branches = false;
+  inter_op_successors_.assign(num_insts, std::vector<int>());
+  inter_op_num_deps_.assign(num_insts, 0);
+  for (int idx = 0; idx < num_insts; idx++) {
+    for (int pred : deps[idx]) {
+      depth[idx] = std::max(depth[idx], depth[pred] + 1);
+      inter_op_successors_[pred].push_back(idx);
+    }
+    inter_op_num_deps_[idx] = static_cast<int>(deps[idx].size());
+    if (++width[depth[idx]] > 1 && !insts[idx].is_feed_fetch_op()) {
+      has_branches = true;
+    }
+  }
+  if (!has_branches) {
+    VLOG(4) << "No independent instructions to run concurrently.";
+    return false;
+  }
+
+  int num_workers = inter_op_threads_ - 1;
+  inter_op_pool_.reset(new ThreadPool(num_workers));
+  lane_workspaces_.clear();
+  for (int i = 0; i < num_workers; i++) {
+    lane_workspaces_.emplace_back(new WorkSpace(TARGET(kHost)));
+  }
+  inter_op_enabled_ = true;
+  return true;
+}
+
+void RuntimeProgram::RunInterOp() {
+  auto& insts = instructions_[kRootBlockIdx];
+  int num_insts = static_cast<int>(insts.size());
+  std::vector<int> num_deps(inter_op_num_deps_);
+  std::deque<int> ready;
+  for (int idx = 0; idx < num_insts; idx++) {
+    if (num_deps[idx] == 0) ready.push_back(idx);
+  }
+  std::mutex mutex;
+  std::condition_variable cond;
+  int remaining = num_insts;
+  int num_workers = inter_op_pool_->num_threads();
+  int running_workers = num_workers;
+#if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
+    !(defined __APPLE__)
+  int intra_op_threads = omp_get_max_threads();
+#endif
+
+  // Run the ready instructions until all of them are done, the lane 0 is the
+  // calling thread.
+  auto run_lane = [&](int lane) {
+#if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
+    !(defined __APPLE__)
+    omp_set_num_threads(intra_op_threads);
+#endif
+    auto* workspace =
+        lane == 0 ? workspace_.get() : lane_workspaces_[lane - 1].get();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cond.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+      if (ready.empty()) break;
+      int idx = ready.front();
+      ready.pop_front();
+      lock.unlock();
+      auto& inst = insts[idx];
+      if (!inst.is_feed_fetch_op()) {
+        inst.mutable_kernel()->SetWorkSpace(workspace);
+        inst.Run(plan_ ? &plan_->steps[idx] : nullptr);
+      }
+      lock.lock();
+      int num_ready = 0;
+      for (int succ : inter_op_successors_[idx]) {
+        if (--num_deps[succ] == 0) {
+          ready.push_back(succ);
+          num_ready++;
+        }
+      }
+      if (--remaining == 0) {
+        cond.notify_all();
+      } else if (num_ready > 1) {
+        cond.notify_all();
+      } else if (num_ready == 1) {
+        cond.notify_one();
+      }
+    }
+    if (lane > 0 && --running_workers == 0) cond.notify_all();
+  };
+
+  for (int lane = 1; lane <= num_workers; lane++) {
+    inter_op_pool_->Enqueue([&run_lane, lane] { run_lane(lane); });
+  }
+  run_lane(0);
+  // The workers refer to the states on the stack.
+  std::unique_lock<std::mutex> lock(mutex);
+  cond.wait(lock, [&] { return running_workers == 0; });
+}
+
+void RuntimeProgram::BindWorkSpace() {
+  // The kernels of a program run one by one, so that they share the same
+  // workspace, which is owned by the program rather than the thread to keep
+  // the temporary memory of the predictors from interfering with each other.
+  workspace_.reset(new WorkSpace(TARGET(kHost)));
+  for (auto& insts : instructions_) {
+    for (auto& inst : insts) {
+      auto target = inst.kernel()->target();
+      if (target == TARGET(kHost) || target == TARGET(kX86) ||
+          target == TARGET(kARM)) {
+        inst.mutable_kernel()->SetWorkSpace(workspace_.get());
+      }
+    }
+  }
+}
+
+void RuntimeProgram::UsePlan(const std::string& key) {
+  if (key.empty()) {
+    plan_ = nullptr;
+    return;
+  }
+  auto it = plans_.find(key);
+  if (it == plans_.end()) {
+    if (plans_.size() >= kMaxPlans) {
+      auto lru = std::min_element(
+          plans_.begin(),
+          plans_.end(),
+          [](const std::pair<const std::string, ExecutionPlan>& a,
+             const std::pair<const std::string, ExecutionPlan>& b) {
+            return a.second.last_use < b.second.last_use;
+          });
+      plans_.erase(lru);
+    }
+    it = plans_.emplace(key, ExecutionPlan()).first;
+    it->second.steps.resize(instructions_[kRootBlockIdx].size());
+  }
+  plan_ = &it->second;
+  plan_->last_use = ++plan_clock_;
+}
+
+bool RuntimeProgram::BindOutput(const std::string& name,
+                                std::shared_ptr<Buffer> buffer) {
+  auto* var = exec_scope_->FindVar(name);
+  CHECK(var) << "no variable named with " << name << " in exec_scope";
+  auto* tensor = var->GetMutable<Tensor>();
+  Instruction* producer = nullptr;
+  int num_producers = 0;
+  for (auto& inst : instructions_[kRootBlockIdx]) {
+    inst.BindOutput(tensor, nullptr);
+    if (inst.is_feed_fetch_op()) continue;
+    auto out_names = inst.op()->op_info()->output_names();
+    if (std::find(out_names.begin(), out_names.end(), name) !=
+        out_names.end()) {
+      producer = &inst;
+      num_producers++;
+    }
+  }
+  if (!buffer || num_producers != 1) return false;
+  auto in_names = producer->op()->op_info()->input_names();
+  if (std::find(in_names.begin(), in_names.end(), name) != in_names.end()) {
+    return false;
+  }
+  producer->BindOutput(tensor, buffer);
+  return true;
+}
+
 void Program::Build(const std::shared_ptr<cpp::ProgramDesc>& program_desc) {
   CHECK(ops_.empty()) << "Executor duplicate Build found";
 
@@ -543,7 +870,120 @@ void Instruction::SaveOutput() {
 }
 #endif
 
-void Instruction::Run() {
+void Instruction::RecordPlanStep(PlanStep* step) {
+  auto* scope = op_->scope();
+  auto* op_info = op_->op_info();
+  // The ops with sub-blocks run a nested program whose shapes are not covered
+  // by the plan, and the ops taking integer activations may compute the
+  // output shapes from the input values, e.g. `fill_constant` with
+  // `ShapeTensor`, keep calling InferShape for them.
+  step->replayable = !op_info->HasAttr("sub_block");
+  for (auto& name : op_info->input_names()) {
+    auto* var = scope->FindVar(name);
+    if (!var || !var->IsType<Tensor>()) continue;
+    auto precision = var->Get<Tensor>().precision();
+    if (precision == PRECISION(kInt32) || precision == PRECISION(kInt64)) {
+      step->replayable = false;
+    }
+  }
+  step->outputs.clear();
+  step->dims.clear();
+  step->lods.clear();
+  step->growable_outputs.clear();
+  auto in_names = op_info->input_names();
+  for (auto& name : op_info->output_names()) {
+    auto* var = scope->FindVar(name);
+    if (!var) continue;
+    if (!var->IsType<Tensor>()) {
+      step->replayable = false;
+      continue;
+    }
+    auto* tensor = var->GetMutable<Tensor>();
+    step->outputs.push_back(tensor);
+    step->dims.push_back(tensor->dims());
+    step->lods.push_back(tensor->lod());
+    auto target = tensor->target();
+    if (step->guarded &&
+        std::find(in_names.begin(), in_names.end(), name) == in_names.end() &&
+        (target == TARGET(kHost) || target == TARGET(kX86) ||
+         target == TARGET(kARM))) {
+      step->growable_outputs.push_back(tensor);
+    }
+  }
+  step->recorded = true;
+}
+
+void Instruction::RecordPlanInputs(PlanStep* step) {
+  auto* scope = op_->scope();
+  step->inputs.clear();
+  step->input_dims.clear();
+  step->input_lods.clear();
+  for (auto& name : op_->op_info()->input_names()) {
+    auto* var = scope->FindVar(name);
+    if (!var) continue;
+    if (!var->IsType<Tensor>()) {
+      // The tensor arrays are not guarded.
+      step->replayable = false;
+      continue;
+    }
+    auto& tensor = var->Get<Tensor>();
+    step->inputs.push_back(&tensor);
+    step->input_dims.push_back(tensor.dims());
+    step->input_lods.push_back(tensor.lod());
+  }
+}
+
+void Instruction::ReserveOutputs(PlanStep* step) {
+  for (auto* tensor : step->growable_outputs) {
+    if (tensor->precision() == PRECISION(kUnk)) continue;
+    size_t size = tensor->numel() * PrecisionTypeLength(tensor->precision());
+    if (size > tensor->capacity()) {
+      tensor->Reserve(size + size / 2);
+    }
+  }
+}
+
+bool PlanStep::InputsUnchanged() const {
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (inputs[i]->dims() != input_dims[i] ||
+        inputs[i]->lod() != input_lods[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Instruction::BindOutput(Tensor* tensor, std::shared_ptr<Buffer> buffer) {
+  for (auto it = output_bindings_.begin(); it != output_bindings_.end(); ++it) {
+    if (it->first != tensor) continue;
+    if (tensor->raw_data() == it->second->data()) {
+      tensor->ShareExternalBuffer(std::make_shared<Buffer>());
+    }
+    output_bindings_.erase(it);
+    break;
+  }
+  if (buffer) {
+    output_bindings_.emplace_back(tensor, buffer);
+  }
+}
+
+void Instruction::PrepareOutputBindings() {
+  for (auto& binding : output_bindings_) {
+    auto* tensor = binding.first;
+    auto& buffer = binding.second;
+    bool is_bound = tensor->raw_data() == buffer->data();
+    size_t size = tensor->numel() * PrecisionTypeLength(tensor->precision());
+    if (tensor->precision() != PRECISION(kUnk) && size <= buffer->space()) {
+      if (!is_bound) tensor->ShareExternalBuffer(buffer);
+    } else if (is_bound) {
+      // Fall back to the internal memory, the output will be copied into the
+      // bound buffer by the predictor if it fits in.
+      tensor->ShareExternalBuffer(std::make_shared<Buffer>());
+    }
+  }
+}
+
+void Instruction::Run(PlanStep* step) {
 #ifdef LITE_WITH_PROFILE
   CHECK(profiler_) << "Profiler pointer of kernel can not be nullptr. "
                       "When LITE_WITH_PROFILE is defined, please set a "
@@ -556,6 +996,11 @@ void Instruction::Run() {
 
   if (first_epoch_) {
     first_epoch_ = false;
+    // The lazy params are read before they are used by the op for the first
+    // time, i.e. before its kernel is prepared.
+    for (auto& name : op_->op_info()->input_names()) {
+      op_->scope()->MaterializeParam(name);
+    }
     CHECK(op_->CheckShape());
   }
 
@@ -563,9 +1008,33 @@ void Instruction::Run() {
     return;
   }
 
-  op_->InferShape();
+  bool replay = step && step->recorded && step->replayable &&
+                (!step->guarded || step->InputsUnchanged());
+  // The guarded steps are recorded again once the input shapes change.
+  bool record = step && (!step->recorded ||
+                         (step->guarded && step->replayable && !replay));
+  if (replay) {
+    for (size_t i = 0; i < step->outputs.size(); i++) {
+      step->outputs[i]->Resize(step->dims[i]);
+      step->outputs[i]->set_lod(step->lods[i]);
+    }
+  } else {
+    if (record && step->guarded) {
+      RecordPlanInputs(step);
+    }
+    op_->InferShape();
+  }
+  if (step && step->guarded && step->recorded) {
+    ReserveOutputs(step);
+  }
+  if (!output_bindings_.empty()) {
+    PrepareOutputBindings();
+  }
   kernel_->Launch();
   has_run_ = true;
+  if (record) {
+    RecordPlanStep(step);
+  }
 
 #ifdef LITE_WITH_PROFILE
   if (first_epoch_for_profiler_) {
@@ -22,6 +22,7 @@
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/thread_pool.h"
 #include "lite/model_parser/cpp_desc.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/profiler.h"
@@ -106,6 +107,41 @@ struct Program {
   Scope* exec_scope_{};
 };
 
+// The output shapes of one instruction recorded by an execution plan.
+struct PlanStep {
+  bool recorded{false};
+  // Whether the recorded shapes can be restored instead of calling
+  // InferShape. It's false if the op may derive the output shapes from the
+  // values rather than the shapes of its inputs.
+  bool replayable{false};
+  std::vector<Tensor*> outputs;
+  std::vector<DDim> dims;
+  std::vector<LoD> lods;
+  // If it's guarded, the recorded shapes are restored only if the input
+  // shapes are the same as the recorded ones, otherwise they are inferred and
+  // recorded again. It's used by the loop bodies whose input shapes may change
+  // across the iterations.
+  bool guarded{false};
+  std::vector<const Tensor*> inputs;
+  std::vector<DDim> input_dims;
+  std::vector<LoD> input_lods;
+  // The guarded outputs which are not the inputs, their buffers are grown
+  // ahead of the kernel with some headroom once they are outgrown.
+  std::vector<Tensor*> growable_outputs;
+
+  bool InputsUnchanged() const;
+};
+
+// An execution plan caches the shape inference results of all of the
+// instructions for a given input shape signature, so that the runs hitting the
+// same signature skip InferShape and find their buffers already allocated.
+struct ExecutionPlan {
+  std::vector<PlanStep> steps;
+  // The logical time of the last use, the least recently used plan is evicted
+  // once there are too many of them.
+  uint64_t last_use{0};
+};
+
 struct Instruction {
   Instruction(const std::shared_ptr<OpLite>& op,
               std::unique_ptr<KernelBase>&& kernel)
@@ -116,8 +152,9 @@ struct Instruction {
     }
   }
 
-  // Run the instruction.
-  void Run();
+  // Run the instruction, `step` is recorded on the first run and restored on
+  // the following runs if it's given.
+  void Run(PlanStep* step = nullptr);
 #ifdef LITE_WITH_METAL
   void SaveOutput();
 #endif
@@ -130,6 +167,11 @@ struct Instruction {
 
   bool is_feed_fetch_op() const { return is_feed_fetch_op_; }
 
+  // Let the kernel write the output `tensor` into the caller-owned `buffer`
+  // directly, it falls back to the internal memory in the runs where the
+  // buffer is too small. A null buffer removes the binding.
+  void BindOutput(Tensor* tensor, std::shared_ptr<Buffer> buffer);
+
 #ifdef LITE_WITH_CUDA
   bool need_sync() const {
     if (kernel_->target() == TargetType::kCUDA) {
@@ -182,8 +224,14 @@ struct Instruction {
 #endif
 
  private:
+  void RecordPlanStep(PlanStep* step);
+  void RecordPlanInputs(PlanStep* step);
+  void ReserveOutputs(PlanStep* step);
+  void PrepareOutputBindings();
+
   std::shared_ptr<OpLite> op_;
   std::unique_ptr<KernelBase> kernel_;
+  std::vector<std::pair<Tensor*, std::shared_ptr<Buffer>>> output_bindings_;
   bool is_feed_fetch_op_{false};
   bool first_epoch_{true};
   bool has_run_{false};
@@ -219,6 +267,7 @@ class LITE_API RuntimeProgram {
     if (instructions_.empty()) {
       LOG(FATAL) << "no instructions";
     }
+    BindWorkSpace();
 #ifdef LITE_WITH_PROFILE
     set_profiler();
 #endif
@@ -238,9 +287,41 @@ class LITE_API RuntimeProgram {
   void SaveOutput();
 #endif
 
+  // Run the program as the sub-block of a control flow op, e.g. the body of
+  // `while`. The loop-invariant instructions, whose inputs are not written in
+  // the block or only by the preceding loop-invariant instructions, only run
+  // in the first iteration of a loop, and the other instructions reuse the
+  // shapes inferred by the previous iteration if their input shapes are
+  // unchanged.
+  void RunBody(bool first_iteration);
+
   void set_exec_scope(Scope* x) { exec_scope_ = x; }
   Scope* exec_scope() { return exec_scope_; }
 
+  // Switch to the execution plan named `key` for the following runs, the plan
+  // is created and recorded by the first run of it. An empty key disables the
+  // execution plan. At most `kMaxPlans` plans are kept, the least recently
+  // used one is dropped to make room for a new one.
+  void UsePlan(const std::string& key);
+  bool HasPlan(const std::string& key) const { return plans_.count(key) > 0; }
+
+  // The workspace shared by the host kernels of all of the blocks.
+  const WorkSpace* workspace() const { return workspace_.get(); }
+
+  // Run the independent instructions of the root block concurrently by
+  // `threads` lanes, i.e. the calling thread and `threads - 1` workers, and 1
+  // runs them one by one. The dependencies are derived from the variables read
+  // and written by the instructions, and each lane has its own workspace. It
+  // only takes effect if all of the kernels are host or x86 ones, and the
+  // intra-op threads of each lane are the OpenMP threads of the caller.
+  void set_inter_op_threads(int threads);
+  int inter_op_threads() const { return inter_op_threads_; }
+
+  // Bind the caller-owned buffer to the variable `name` in the root block,
+  // return false if no instruction can write it in place, e.g. it's produced
+  // by more than one instruction or by an inplace op.
+  bool BindOutput(const std::string& name, std::shared_ptr<Buffer> buffer);
+
   const std::vector<Instruction>& instructions(
       int block_idx = kRootBlockIdx) const {
     return instructions_[block_idx];
@@ -261,8 +342,36 @@ class LITE_API RuntimeProgram {
 
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
+  void BindWorkSpace();
+  void PrepareBody();
+  // Run the instructions of the root block one by one, with the guarded steps
+  // of RunBody if `as_body`, otherwise with the steps of the current plan.
+  void RunInstructions(bool as_body, bool first_iteration);
+  // Build the dependency graph of the root block, return false if it can't
+  // run concurrently or has no independent instructions.
+  bool PrepareInterOp();
+  void RunInterOp();
+
   std::vector<std::vector<Instruction>> instructions_;
   Scope* exec_scope_{};
+  std::unique_ptr<WorkSpace> workspace_;
+  static constexpr size_t kMaxPlans = 64;
+  std::map<std::string, ExecutionPlan> plans_;
+  ExecutionPlan* plan_{nullptr};
+  uint64_t plan_clock_{0};
+  // The guarded steps and the loop-invariant flags of the instructions of the
+  // root block used by RunBody.
+  std::vector<PlanStep> body_steps_;
+  std::vector<bool> loop_invariant_;
+  // The inter-op scheduling, the workspaces are of the lanes except the
+  // calling one, which uses `workspace_`.
+  int inter_op_threads_{1};
+  bool inter_op_prepared_{false};
+  bool inter_op_enabled_{false};
+  std::unique_ptr<ThreadPool> inter_op_pool_;
+  std::vector<std::vector<int>> inter_op_successors_;
+  std::vector<int> inter_op_num_deps_;
+  std::vector<std::unique_ptr<WorkSpace>> lane_workspaces_;
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler profiler_;
@@ -0,0 +1,156 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/program.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+cpp::OpDesc* AddOp(cpp::BlockDesc* block,
+                   const std::string& type,
+                   const std::string& alias,
+                   const Place& place) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType(type);
+  op->SetAttr<std::string>(
+      kKernelTypeAttr, KernelBase::SerializeKernelType(type, alias, place));
+  return op;
+}
+
+void AddScaleOp(cpp::BlockDesc* block,
+                const std::string& x,
+                const std::string& out,
+                float scale,
+                float bias) {
+  auto* op =
+      AddOp(block, "scale", "def", Place{TARGET(kX86), PRECISION(kFloat)});
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+  op->SetAttr<float>("scale", scale);
+  op->SetAttr<float>("bias", bias);
+  op->SetAttr<bool>("bias_after_scale", true);
+}
+
+void AddAssignOp(cpp::BlockDesc* block,
+                 const std::string& x,
+                 const std::string& out) {
+  auto* op = AddOp(block,
+                   "assign",
+                   "def",
+                   Place{TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny)});
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+}
+
+// The body of a loop:
+//   w2 = scale(w)          loop-invariant, w is not written in the body
+//   b = concat(a, w2)      the shape of a grows by each iteration
+//   c = scale(b)
+//   a = assign(c)
+//   t = elementwise_add(s, w2)   the shape of s is unchanged
+//   s = assign(t)
+std::shared_ptr<cpp::ProgramDesc> LoopBodyProgram() {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block = program_desc->AddBlock<cpp::BlockDesc>();
+  block->SetIdx(0);
+  block->SetParentIdx(-1);
+  const Place x86_place{TARGET(kX86), PRECISION(kFloat)};
+  AddScaleOp(block, "w", "w2", 2.f, 1.f);
+  auto* concat = AddOp(block, "concat", "def", x86_place);
+  concat->SetInput("X", {"a", "w2"});
+  concat->SetOutput("Out", {"b"});
+  concat->SetAttr<int>("axis", 0);
+  AddScaleOp(block, "b", "c", 0.5f, 0.f);
+  AddAssignOp(block, "c", "a");
+  auto* add = AddOp(block, "elementwise_add", "def", x86_place);
+  add->SetInput("X", {"s"});
+  add->SetInput("Y", {"w2"});
+  add->SetOutput("Out", {"t"});
+  add->SetAttr<int>("axis", -1);
+  AddAssignOp(block, "t", "s");
+  return program_desc;
+}
+
+void FillTensor(Tensor* tensor, const DDim& dims, float start) {
+  tensor->Resize(dims);
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = start + 0.25f * i;
+  }
+}
+
+// Set the loop-carried and the outer variables to their initial values.
+void ResetScope(Scope* scope) {
+  FillTensor(scope->Var("w")->GetMutable<Tensor>(), DDim({2, 3}), -1.f);
+  FillTensor(scope->Var("a")->GetMutable<Tensor>(), DDim({1, 3}), 0.5f);
+  FillTensor(scope->Var("s")->GetMutable<Tensor>(), DDim({2, 3}), 0.f);
+}
+
+void ExpectSameTensor(const Tensor& x, const Tensor& y) {
+  ASSERT_EQ(x.dims(), y.dims());
+  for (int64_t i = 0; i < x.numel(); i++) {
+    EXPECT_NEAR(x.data<float>()[i], y.data<float>()[i], 1e-5f);
+  }
+}
+
+}  // namespace
+
+TEST(RuntimeProgram, run_body) {
+  auto program_desc = LoopBodyProgram();
+  Scope scope;
+  Scope ref_scope;
+  for (auto* s : {&scope, &ref_scope}) {
+    for (auto& name : {"w", "w2", "a", "b", "c", "s", "t"}) {
+      s->Var(name)->GetMutable<Tensor>();
+    }
+  }
+  RuntimeProgram program(program_desc, &scope);
+  RuntimeProgram ref_program(program_desc, &ref_scope);
+
+  // Run the loop twice, the second one starts from the smaller shapes than the
+  // recorded ones of the first one.
+  for (int num_iterations : {4, 2}) {
+    ResetScope(&scope);
+    ResetScope(&ref_scope);
+    for (int iter = 0; iter < num_iterations; iter++) {
+      program.RunBody(iter == 0);
+      // Neither hoisted nor replayed.
+      ref_program.Run();
+      auto& a = scope.FindVar("a")->Get<Tensor>();
+      EXPECT_EQ(a.dims(), DDim({1 + 2 * (iter + 1), 3}));
+      ExpectSameTensor(a, ref_scope.FindVar("a")->Get<Tensor>());
+      ExpectSameTensor(scope.FindVar("s")->Get<Tensor>(),
+                       ref_scope.FindVar("s")->Get<Tensor>());
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(scale);
+USE_LITE_OP(concat);
+USE_LITE_OP(assign);
+USE_LITE_OP(elementwise_add);
+USE_LITE_KERNEL(scale, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(concat, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(assign, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW, def);
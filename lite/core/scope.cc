@@ -41,6 +41,16 @@ Scope &Scope::NewScope() const {
   return *kids_.back();
 }
 
+void Scope::MaterializeParam(const std::string &name) const {
+  const Scope *root = this;
+  while (root->parent()) {
+    root = root->parent();
+  }
+  if (root->lazy_param_loader_) {
+    root->lazy_param_loader_->Load(name);
+  }
+}
+
 Variable *Scope::Var(const std::string &name) {
   SCOPE_VARS_WRITER_LOCK
   auto *var = FindVar(name);
@@ -25,6 +25,16 @@
 namespace paddle {
 namespace lite {
 
+// Reads the data of the params which are registered in the scope without
+// their data by the model loader, see `fbs::ParamDeserializer::LazyRead`.
+class LazyParamLoader {
+ public:
+  virtual ~LazyParamLoader() = default;
+  // Fill the tensor of the param if it's not read yet, the names of the vars
+  // which are not lazy params are ignored. It's thread safe.
+  virtual void Load(const std::string& name) = 0;
+};
+
 class Scope final {
  public:
   Scope()
@@ -51,6 +61,13 @@ class Scope final {
 
   const Scope* parent() const { return parent_; }
 
+  // The loader is held by the root scope and shared by its kids.
+  void SetLazyParamLoader(std::shared_ptr<LazyParamLoader> loader) {
+    lazy_param_loader_ = std::move(loader);
+  }
+  // Read the data of the var if it's a lazy param which is not read yet.
+  void MaterializeParam(const std::string& name) const;
+
   // Get attribute params stored in parent scopes.
   std::vector<std::string> AttributeVarNames() const;
   // Following the legacy scope interface.
@@ -98,6 +115,7 @@ class Scope final {
   mutable std::list<Scope*> kids_;
   const Scope* parent_{nullptr};
   std::map<std::string, std::unique_ptr<Variable>> vars_;
+  std::shared_ptr<LazyParamLoader> lazy_param_loader_;
   std::unique_ptr<lite::fluid::RWLock> kids_lock_{nullptr};
   std::unique_ptr<lite::fluid::RWLock> vars_lock_{nullptr};
   std::unique_ptr<lite::fluid::RWLock> rwlock_{nullptr};
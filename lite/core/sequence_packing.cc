@@ -0,0 +1,143 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/sequence_packing.h"
+#include <cstring>
+#include <utility>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+size_t RowBytes(const Tensor& tensor) {
+  int64_t rows = tensor.dims().size() ? tensor.dims()[0] : 1;
+  int64_t row_size = rows ? tensor.numel() / rows : 0;
+  return row_size * lite_api::PrecisionTypeLength(tensor.precision());
+}
+}  // namespace
+
+void PackSequences(const std::vector<const Tensor*>& parts,
+                   Tensor* packed,
+                   SequencePacking* packing) {
+  CHECK(!parts.empty());
+  const Tensor& first = *parts.front();
+  CHECK_GT(first.dims().size(), 0UL);
+  size_t lod_levels = first.lod().size();
+  size_t row_bytes = RowBytes(first);
+
+  std::vector<int64_t> sequence_offsets{0};
+  std::vector<int64_t> row_offsets{0};
+  LoD lod(lod_levels, std::vector<uint64_t>{0});
+  for (auto* part : parts) {
+    CHECK_EQ(part->precision(), first.precision())
+        << "The inputs of the requests should be of the same precision.";
+    CHECK_EQ(part->dims().size(), first.dims().size());
+    for (size_t i = 1; i < first.dims().size(); i++) {
+      CHECK_EQ(part->dims()[i], first.dims()[i])
+          << "The inputs of the requests should be of the same dimensions "
+             "except the first one.";
+    }
+    CHECK_EQ(part->lod().size(), lod_levels)
+        << "The inputs of the requests should be of the same LoD levels.";
+    // The offsets of a level index the sequences of the next level, so they
+    // are shifted by the sequences of the next level packed before.
+    for (size_t level = 0; level < lod_levels; level++) {
+      auto& offsets = part->lod()[level];
+      CHECK(!offsets.empty());
+      uint64_t base = lod[level].back();
+      for (size_t i = 1; i < offsets.size(); i++) {
+        lod[level].push_back(base + offsets[i] - offsets[0]);
+      }
+    }
+    int64_t num_sequences =
+        lod_levels ? part->lod()[0].size() - 1 : part->dims()[0];
+    sequence_offsets.push_back(sequence_offsets.back() + num_sequences);
+    row_offsets.push_back(row_offsets.back() + part->dims()[0]);
+  }
+
+  auto dims = first.dims();
+  dims[0] = row_offsets.back();
+  packed->Resize(dims);
+  packed->set_lod(lod);
+  auto* dst = static_cast<char*>(
+      packed->mutable_data(TARGET(kHost), dims[0] * row_bytes));
+  packed->set_precision(first.precision());
+  for (size_t i = 0; i < parts.size(); i++) {
+    size_t bytes = parts[i]->dims()[0] * row_bytes;
+    if (bytes) {
+      std::memcpy(
+          dst + row_offsets[i] * row_bytes, parts[i]->raw_data(), bytes);
+    }
+  }
+  if (packing) {
+    packing->sequence_offsets = std::move(sequence_offsets);
+    packing->row_offsets = std::move(row_offsets);
+  }
+}
+
+void SplitSequences(const Tensor& packed,
+                    const SequencePacking& packing,
+                    const std::vector<Tensor*>& parts) {
+  CHECK_EQ(parts.size(), packing.num_requests());
+  CHECK_GT(packed.dims().size(), 0UL);
+  int64_t num_sequences = packing.sequence_offsets.back();
+  int64_t num_rows = packed.dims()[0];
+  size_t row_bytes = RowBytes(packed);
+  const auto& lod = packed.lod();
+  const auto* src = static_cast<const char*>(packed.raw_data());
+  if (!lod.empty()) {
+    CHECK_EQ(static_cast<int64_t>(lod[0].size()) - 1, num_sequences)
+        << "The output is not of the sequences of the packed inputs.";
+  } else if (num_rows != num_sequences) {
+    CHECK_EQ(num_rows, packing.row_offsets.back())
+        << "The output can't be split by the sequences or the rows of the "
+           "packed inputs.";
+  }
+
+  for (size_t r = 0; r < parts.size(); r++) {
+    int64_t begin = packing.sequence_offsets[r];
+    int64_t end = packing.sequence_offsets[r + 1];
+    LoD part_lod(lod.size());
+    if (lod.empty() && num_rows != num_sequences) {
+      begin = packing.row_offsets[r];
+      end = packing.row_offsets[r + 1];
+    }
+    // Walk down the levels, the range of a level indexes the next one.
+    for (size_t level = 0; level < lod.size(); level++) {
+      auto& offsets = lod[level];
+      for (int64_t i = begin; i <= end; i++) {
+        part_lod[level].push_back(offsets[i] - offsets[begin]);
+      }
+      int64_t next_begin = offsets[begin];
+      end = offsets[end];
+      begin = next_begin;
+    }
+
+    auto dims = packed.dims();
+    dims[0] = end - begin;
+    auto* part = parts[r];
+    part->Resize(dims);
+    part->set_lod(part_lod);
+    auto* dst = static_cast<char*>(
+        part->mutable_data(TARGET(kHost), dims[0] * row_bytes));
+    part->set_precision(packed.precision());
+    if (dims[0]) {
+      std::memcpy(dst, src + begin * row_bytes, dims[0] * row_bytes);
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
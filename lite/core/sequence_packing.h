@@ -0,0 +1,60 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * Packing the LoD tensors of many requests into a single batch, so that the
+ * sequence ops, e.g. search_fc, search_grnn, var_conv_2d and
+ * match_matrix_tensor, run over the sequences of all of the requests at once
+ * and their GEMMs get the rows of all of the requests, then splitting the
+ * outputs back to the requests.
+ */
+struct SequencePacking {
+  // The offsets of the top-level sequences and the rows of the requests in
+  // the packed batch, both are of size num_requests + 1.
+  std::vector<int64_t> sequence_offsets;
+  std::vector<int64_t> row_offsets;
+
+  size_t num_requests() const {
+    return row_offsets.empty() ? 0 : row_offsets.size() - 1;
+  }
+};
+
+// Concatenate the host tensors of the requests along the first dimension
+// into `packed`, the LoDs are merged level by level. The tensors should be of
+// the same precision, the same number of LoD levels and the same dimensions
+// except the first one. The offsets of the requests are recorded in
+// `packing` if it's not null.
+void PackSequences(const std::vector<const Tensor*>& parts,
+                   Tensor* packed,
+                   SequencePacking* packing = nullptr);
+
+// Split the output `packed` computed over the packed batch into the requests.
+// An output with LoD is split by its top-level sequences, whose number should
+// be the number of the packed sequences. An output without LoD is split by
+// the sequences if its first dimension is the number of the packed sequences,
+// e.g. the output of sequence_pool, or by the rows otherwise.
+void SplitSequences(const Tensor& packed,
+                    const SequencePacking& packing,
+                    const std::vector<Tensor*>& parts);
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,75 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/sequence_packing.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(sequence_packing, pack_and_split) {
+  // Two levels of LoD: the requests have 2 and 1 top-level sequences of 3
+  // and 2 sub-sequences, and the rows are of 2 columns.
+  Tensor a, b;
+  a.Resize({5, 2});
+  a.set_lod({{0, 1, 3}, {0, 2, 3, 5}});
+  b.Resize({4, 2});
+  b.set_lod({{0, 2}, {0, 1, 4}});
+  for (int i = 0; i < 10; i++) a.mutable_data<float>()[i] = i;
+  for (int i = 0; i < 8; i++) b.mutable_data<float>()[i] = 100 + i;
+
+  Tensor packed;
+  SequencePacking packing;
+  PackSequences({&a, &b}, &packed, &packing);
+  ASSERT_EQ(packed.dims(), DDim(std::vector<int64_t>({9, 2})));
+  LoD expected_lod{{0, 1, 3, 5}, {0, 2, 3, 5, 6, 9}};
+  ASSERT_EQ(packed.lod(), expected_lod);
+  ASSERT_EQ(packing.sequence_offsets, std::vector<int64_t>({0, 2, 3}));
+  ASSERT_EQ(packing.row_offsets, std::vector<int64_t>({0, 5, 9}));
+  for (int i = 0; i < 10; i++) EXPECT_EQ(packed.data<float>()[i], i);
+  for (int i = 0; i < 8; i++) EXPECT_EQ(packed.data<float>()[10 + i], 100 + i);
+
+  // The output of the same LoD is split back into the inputs.
+  Tensor c, d;
+  SplitSequences(packed, packing, {&c, &d});
+  ASSERT_EQ(c.dims(), a.dims());
+  ASSERT_EQ(c.lod(), a.lod());
+  ASSERT_EQ(d.dims(), b.dims());
+  ASSERT_EQ(d.lod(), b.lod());
+  for (int i = 0; i < 10; i++) EXPECT_EQ(c.data<float>()[i], i);
+  for (int i = 0; i < 8; i++) EXPECT_EQ(d.data<float>()[i], 100 + i);
+
+  // An output of a row per sequence is split by the sequences.
+  Tensor pooled;
+  pooled.Resize({3, 1});
+  for (int i = 0; i < 3; i++) pooled.mutable_data<int64_t>()[i] = i;
+  SplitSequences(pooled, packing, {&c, &d});
+  ASSERT_EQ(c.dims()[0], 2);
+  ASSERT_EQ(d.dims()[0], 1);
+  EXPECT_EQ(c.data<int64_t>()[1], 1);
+  EXPECT_EQ(d.data<int64_t>()[0], 2);
+
+  // An output without LoD of the rows of the inputs is split by the rows.
+  Tensor rows;
+  rows.Resize({9});
+  for (int i = 0; i < 9; i++) rows.mutable_data<int>()[i] = i;
+  SplitSequences(rows, packing, {&c, &d});
+  ASSERT_EQ(c.dims()[0], 5);
+  ASSERT_EQ(d.dims()[0], 4);
+  EXPECT_EQ(d.data<int>()[0], 5);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -67,6 +67,14 @@ void TensorLite::ResetBuffer(std::shared_ptr<Buffer> buffer,
   target_ = buffer->target();
 }
 
+bool TensorLite::Reserve(size_t memory_size) {
+  if (buffer_.use_count() != 1 || !buffer_->own_data() || offset_ != 0) {
+    return false;
+  }
+  buffer_->ResetLazy(target_, memory_size);
+  return true;
+}
+
 #ifdef LITE_WITH_OPENCL
 template <>
 const cl::Image2D *TensorLite::data<float, cl::Image2D>() const {
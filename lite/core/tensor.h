@@ -192,6 +192,24 @@ class TensorLite {
 
   void ResetBuffer(std::shared_ptr<Buffer> buffer, size_t memory_size);
 
+  // The bytes of the buffer available to this tensor.
+  size_t capacity() const { return buffer_->space() - offset_; }
+
+  // Grow the buffer to at least `memory_size` bytes ahead of the kernel, the
+  // data is not kept. Return false if the buffer is shared with the other
+  // tensors or not owned by the tensor, which is left as it is.
+  bool Reserve(size_t memory_size);
+
+  // Share the external buffer regardless of the size of the current data, it's
+  // used to bind the caller-owned memory to the inputs and outputs, the
+  // tensor should be resized to fit in the buffer before accessing the data.
+  void ShareExternalBuffer(std::shared_ptr<Buffer> buffer) {
+    buffer_ = buffer;
+    target_ = buffer->target();
+    memory_size_ = 0;
+    offset_ = 0;
+  }
+
   TargetType target() const { return target_; }
 
   template <typename T>
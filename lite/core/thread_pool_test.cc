@@ -0,0 +1,53 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+
+namespace paddle {
+namespace lite {
+
+TEST(thread_pool, run_all_tasks) {
+  std::atomic<int> sum{0};
+  {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.num_threads(), 4);
+    for (int i = 1; i <= 1000; i++) {
+      pool.Enqueue([&sum, i] { sum += i; });
+    }
+  }
+  // The pending tasks are done before the workers are joined.
+  EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST(thread_pool, wait_for_tasks) {
+  ThreadPool pool(2);
+  std::mutex mutex;
+  std::condition_variable cond;
+  int done = 0;
+  for (int i = 0; i < 8; i++) {
+    pool.Enqueue([&] {
+      std::lock_guard<std::mutex> lock(mutex);
+      done++;
+      cond.notify_one();
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cond.wait(lock, [&] { return done == 8; });
+  EXPECT_EQ(done, 8);
+}
+
+}  // namespace lite
+}  // namespace paddle
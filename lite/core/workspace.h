@@ -33,14 +33,32 @@ namespace lite {
  *
  * For kernel developers, one need to call the workspace as follows:
  *
- * - call `WorkSpace::Global().Alloc()` if needed to allocate some temporary
- * buffer.
+ * - call `workspace()->Alloc()` of the kernel if needed to allocate some
+ * temporary buffer, and report the total size by `WorkspaceSize()` so that the
+ * buffer is reserved before `Run()`.
+ *
+ * The RuntimeProgram owns a workspace for the host kernels, so that each
+ * predictor has its own scratch memory, which grows to the max requirement of
+ * its kernels in the first runs and is stable afterwards.
  */
 class WorkSpace {
  public:
+  explicit WorkSpace(TargetType x) : target_(x) {}
+
   // Reset the workspace, and treat the workspace as empty.
   void AllocReset() { cursor_ = 0; }
 
+  // Grow the buffer to hold `size` bytes, it should be called right after
+  // AllocReset since growing the buffer invalidates the memory allocated.
+  void Reserve(size_t size) {
+    CHECK_EQ(cursor_, 0u) << "The workspace should be reserved before Alloc.";
+    if (size > buffer_.space()) {
+      buffer_.ResetLazy(target_, size);
+    }
+  }
+
+  size_t capacity() const { return buffer_.space(); }
+
   // Allocate a memory buffer.
   core::byte_t* Alloc(size_t size) {
     buffer_.ResetLazy(target_, cursor_ + size);
@@ -87,11 +105,9 @@ class WorkSpace {
 #endif
 
  private:
-  explicit WorkSpace(TargetType x) : target_(x) {}
-
   TargetType target_;
   Buffer buffer_;
-  size_t cursor_;
+  size_t cursor_{0};
 
   DISALLOW_COPY_AND_ASSIGN(WorkSpace);
 };
@@ -13,10 +13,7 @@
 // limitations under the License.
 
 #pragma once
-#include <algorithm>
-#include <utility>
-#include <vector>
-
+#include "lite/backends/host/math/topk.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -47,37 +44,14 @@ class ArgsortCompute
     int outer_size = x_dims.count(0, axis);
     int axis_size = x_dims[axis];
     int inner_size = x_dims.count(axis + 1, dim_size);
-    int sort_size = axis_size * inner_size;
-#pragma omp parallel for
-    for (int n = 0; n < outer_size; n++) {
-      const DataType* in_data = x_data + n * sort_size;
-      DataType* out_data = out_val + n * sort_size;
-      int64_t* out_ind_data = out_ind + n * sort_size;
-      for (int i = 0; i < inner_size; i++) {
-        std::vector<std::pair<DataType, int>> vec;
-        vec.resize(axis_size);
-        for (int j = 0; j < axis_size; j++) {
-          vec[j] = std::make_pair(in_data[j * inner_size + i], j);
-        }
-        if (descending) {
-          std::sort(vec.begin(),
-                    vec.end(),
-                    [](std::pair<DataType, int> a, std::pair<DataType, int> b) {
-                      return a.first > b.first;
-                    });
-        } else {
-          std::sort(vec.begin(),
-                    vec.end(),
-                    [](std::pair<DataType, int> a, std::pair<DataType, int> b) {
-                      return a.first < b.first;
-                    });
-        }
-        for (int j = 0; j < axis_size; j++) {
-          out_data[j * inner_size + i] = vec[j].first;
-          out_ind_data[j * inner_size + i] = vec[j].second;
-        }
-      }
-    }
+    lite::host::math::topk(x_data,
+                           out_val,
+                           out_ind,
+                           outer_size,
+                           axis_size,
+                           inner_size,
+                           axis_size,
+                           descending);
   }
 
   virtual ~ArgsortCompute() = default;
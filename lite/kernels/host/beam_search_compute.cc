@@ -13,7 +13,6 @@
 // limitations under the License.
 
 #include "lite/kernels/host/beam_search_compute.h"
-#include "lite/backends/host/math/beam_search.h"
 
 namespace paddle {
 namespace lite {
@@ -32,7 +31,8 @@ void BeamSearchCompute::Run() {
                                 param.level,
                                 param.beam_size,
                                 param.end_id,
-                                param.is_accumulated);
+                                param.is_accumulated,
+                                &scratch_);
 }
 
 }  // namespace host
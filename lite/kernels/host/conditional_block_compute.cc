@@ -44,7 +44,9 @@ void ConditionalBlockCompute::Run() {
     }
   }
   if (need_run) {
-    program_->Run();
+    // The sub-block runs once per call, so nothing is hoisted, but the shapes
+    // are reused by the following calls if the input shapes are unchanged.
+    program_->RunBody(true);
   }
 }
 
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/kernels/host/gather_tree_compute.h"
+#include "lite/backends/host/math/beam_search.h"
 
 namespace paddle {
 namespace lite {
@@ -26,23 +27,8 @@ void GatherTreeCompute<T>::Run() {
   const auto* parents_data = param.parents->template data<T>();
   auto* out_data = param.out->template mutable_data<T>();
   auto& ids_dims = param.ids->dims();
-  int max_length = ids_dims[0];
-  int batch_size = ids_dims[1];
-  int beam_size = ids_dims[2];
-
-  for (int batch = 0; batch < batch_size; batch++) {
-    for (int beam = 0; beam < beam_size; beam++) {
-      auto idx =
-          (max_length - 1) * batch_size * beam_size + batch * beam_size + beam;
-      out_data[idx] = ids_data[idx];
-      auto parent = parents_data[idx];
-      for (int step = max_length - 2; step >= 0; step--) {
-        idx = step * batch_size * beam_size + batch * beam_size;
-        out_data[idx + beam] = ids_data[idx + parent];
-        parent = parents_data[idx + parent];
-      }
-    }
-  }
+  lite::host::math::gather_tree(
+      ids_data, parents_data, out_data, ids_dims[0], ids_dims[1], ids_dims[2]);
   return;
 }
 
@@ -13,207 +13,41 @@
 // limitations under the License.
 
 #include "lite/kernels/host/matrix_nms_compute.h"
-#include <cmath>
-#include <map>
+#include <algorithm>
+#include <numeric>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
-template <class T>
-T PolyIoU(const T* box1,
-          const T* box2,
-          const size_t box_size,
-          const bool normalized) {
-  LOG(FATAL) << "PolyIoU not implement.";
-  return *box1;
-}
-
-template <typename T, bool gaussian>
-struct decay_score;
-
-template <typename T>
-struct decay_score<T, true> {
-  T operator()(T iou, T max_iou, T sigma) {
-    return std::exp((max_iou * max_iou - iou * iou) * sigma);
-  }
-};
-
-template <typename T>
-struct decay_score<T, false> {
-  T operator()(T iou, T max_iou, T sigma) {
-    return (1. - iou) / (1. - max_iou);
-  }
-};
-
-template <typename T, bool gaussian>
-void NMSMatrix(const Tensor& bbox,
-               const Tensor& scores,
-               const T score_threshold,
-               const T post_threshold,
-               const float sigma,
-               const int64_t top_k,
-               const bool normalized,
-               std::vector<int>* selected_indices,
-               std::vector<T>* decayed_scores) {
-  int64_t num_boxes = bbox.dims()[0];
-  int64_t box_size = bbox.dims()[1];
-
-  auto score_ptr = scores.data<T>();
-  auto bbox_ptr = bbox.data<T>();
-
-  std::vector<int32_t> perm(num_boxes);
-  std::iota(perm.begin(), perm.end(), 0);
-  auto end = std::remove_if(
-      perm.begin(), perm.end(), [&score_ptr, score_threshold](int32_t idx) {
-        return score_ptr[idx] <= score_threshold;
-      });
-  auto sort_fn = [&score_ptr](int32_t lhs, int32_t rhs) {
-    return score_ptr[lhs] > score_ptr[rhs];
-  };
-
-  int64_t num_pre = std::distance(perm.begin(), end);
-  if (num_pre <= 0) {
-    return;
-  }
-  if (top_k > -1 && num_pre > top_k) {
-    num_pre = top_k;
-  }
-  std::partial_sort(perm.begin(), perm.begin() + num_pre, end, sort_fn);
-
-  std::vector<T> iou_matrix((num_pre * (num_pre - 1)) >> 1);
-  std::vector<T> iou_max(num_pre);
-
-  iou_max[0] = 0.;
-  for (int64_t i = 1; i < num_pre; i++) {
-    T max_iou = 0.;
-    auto idx_a = perm[i];
-    for (int64_t j = 0; j < i; j++) {
-      auto idx_b = perm[j];
-      auto iou = JaccardOverlap<T>(
-          bbox_ptr + idx_a * box_size, bbox_ptr + idx_b * box_size, normalized);
-      max_iou = (std::max)(max_iou, iou);
-      iou_matrix[i * (i - 1) / 2 + j] = iou;
-    }
-    iou_max[i] = max_iou;
-  }
-
-  if (score_ptr[perm[0]] > post_threshold) {
-    selected_indices->push_back(perm[0]);
-    decayed_scores->push_back(score_ptr[perm[0]]);
-  }
-
-  decay_score<T, gaussian> decay_fn;
-  for (int64_t i = 1; i < num_pre; i++) {
-    T min_decay = 1.;
-    for (int64_t j = 0; j < i; j++) {
-      auto max_iou = iou_max[j];
-      auto iou = iou_matrix[i * (i - 1) / 2 + j];
-      auto decay = decay_fn(iou, max_iou, sigma);
-      min_decay = (std::min)(min_decay, decay);
-    }
-    auto ds = min_decay * score_ptr[perm[i]];
-    if (ds <= post_threshold) continue;
-    selected_indices->push_back(perm[i]);
-    decayed_scores->push_back(ds);
-  }
-}
-
+// Merge the detections of all of the classes of an instance, and keep the
+// top keep_top_k ones in the descending order of the decayed scores.
 template <typename T>
-size_t MultiClassMatrixNMS(const Tensor& scores,
-                           const Tensor& bboxes,
+size_t MultiClassMatrixNMS(const std::vector<int>* class_indices,
+                           const std::vector<T>* class_scores,
+                           const int64_t class_num,
+                           const T* bboxes,
+                           const int64_t box_size,
                            std::vector<T>* out,
                            std::vector<int>* indices,
                            int start,
-                           int64_t background_label,
-                           int64_t nms_top_k,
-                           int64_t keep_top_k,
-                           bool normalized,
-                           T score_threshold,
-                           T post_threshold,
-                           bool use_gaussian,
-                           float gaussian_sigma) {
+                           int64_t keep_top_k) {
   std::vector<int> all_indices;
   std::vector<T> all_scores;
   std::vector<T> all_classes;
-  all_indices.reserve(scores.numel());
-  all_scores.reserve(scores.numel());
-  all_classes.reserve(scores.numel());
-
-  size_t num_det = 0;
-  auto class_num = scores.dims()[0];
-  Tensor score_slice;
   for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    score_slice = scores.Slice<float>(c, c + 1);
-    if (use_gaussian) {
-      NMSMatrix<T, true>(bboxes,
-                         score_slice,
-                         score_threshold,
-                         post_threshold,
-                         gaussian_sigma,
-                         nms_top_k,
-                         normalized,
-                         &all_indices,
-                         &all_scores);
-    } else {
-      NMSMatrix<T, false>(bboxes,
-                          score_slice,
-                          score_threshold,
-                          post_threshold,
-                          gaussian_sigma,
-                          nms_top_k,
-                          normalized,
-                          &all_indices,
-                          &all_scores);
-    }
-    for (size_t i = 0; i < all_indices.size() - num_det; i++) {
-      all_classes.push_back(static_cast<T>(c));
-    }
-    num_det = all_indices.size();
+    all_indices.insert(
+        all_indices.end(), class_indices[c].begin(), class_indices[c].end());
+    all_scores.insert(
+        all_scores.end(), class_scores[c].begin(), class_scores[c].end());
+    all_classes.resize(all_indices.size(), static_cast<T>(c));
   }
 
+  size_t num_det = all_indices.size();
   if (num_det <= 0) {
     return num_det;
   }
@@ -238,11 +72,11 @@ size_t MultiClassMatrixNMS(const Tensor& scores,
     auto idx = all_indices[p];
     auto cls = all_classes[p];
     auto score = all_scores[p];
-    auto bbox = bboxes.data<T>() + idx * bboxes.dims()[1];
+    auto bbox = bboxes + idx * box_size;
     (*indices).push_back(start + idx);
     (*out).push_back(cls);
     (*out).push_back(score);
-    for (int j = 0; j < bboxes.dims()[1]; j++) {
+    for (int j = 0; j < box_size; j++) {
       (*out).push_back(bbox[j]);
     }
   }
@@ -272,7 +106,33 @@ void MatrixNmsCompute::Run() {
   auto box_dim = boxes->dims()[2];
   auto out_dim = box_dim + 2;
 
-  Tensor boxes_slice, scores_slice;
+  auto class_num = score_dims[1];
+  auto* boxes_data = boxes->data<float>();
+  auto* scores_data = scores->data<float>();
+
+  // The classes of all of the instances are suppressed in parallel.
+  int num_tasks = batch_size * class_num;
+  std::vector<std::vector<int>> class_indices(num_tasks);
+  std::vector<std::vector<float>> class_scores(num_tasks);
+#pragma omp parallel for
+  for (int t = 0; t < num_tasks; ++t) {
+    int i = t / class_num;
+    int c = t % class_num;
+    if (c == background_label) continue;
+    lite::host::math::NMSMatrix(boxes_data + i * num_boxes * box_dim,
+                                box_dim,
+                                scores_data + t * num_boxes,
+                                num_boxes,
+                                score_threshold,
+                                post_threshold,
+                                gaussian_sigma,
+                                nms_top_k,
+                                normalized,
+                                use_gaussian,
+                                &class_indices[t],
+                                &class_scores[t]);
+  }
+
   int64_t num_out = 0;
   std::vector<int64_t> offsets = {0};
   std::vector<float> detections;
@@ -282,24 +142,16 @@ void MatrixNmsCompute::Run() {
   indices.reserve(num_boxes * batch_size);
   num_per_batch.reserve(batch_size);
   for (int i = 0; i < batch_size; ++i) {
-    scores_slice = scores->Slice<float>(i, i + 1);
-    scores_slice.Resize({score_dims[1], score_dims[2]});
-    boxes_slice = boxes->Slice<float>(i, i + 1);
-    boxes_slice.Resize({score_dims[2], box_dim});
-    int start = i * score_dims[2];
-    num_out = MultiClassMatrixNMS(scores_slice,
-                                  boxes_slice,
+    int start = i * num_boxes;
+    num_out = MultiClassMatrixNMS(class_indices.data() + i * class_num,
+                                  class_scores.data() + i * class_num,
+                                  class_num,
+                                  boxes_data + i * num_boxes * box_dim,
+                                  box_dim,
                                   &detections,
                                   &indices,
                                   start,
-                                  background_label,
-                                  nms_top_k,
-                                  keep_top_k,
-                                  normalized,
-                                  score_threshold,
-                                  post_threshold,
-                                  use_gaussian,
-                                  gaussian_sigma);
+                                  keep_top_k);
     offsets.push_back(offsets.back() + num_out);
     num_per_batch.emplace_back(num_out);
   }
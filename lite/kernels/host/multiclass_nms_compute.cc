@@ -16,6 +16,7 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 #include "lite/backends/host/math/nms_util.h"
 
 namespace paddle {
@@ -34,231 +35,133 @@ inline std::vector<uint64_t> GetNmsLodFromRoisNum(const Tensor* rois_num) {
   return rois_lod;
 }
 
-template <class T>
-void SliceOneClass(const Tensor& items,
-                   const int class_id,
-                   Tensor* one_class_item) {
-  T* item_data = one_class_item->mutable_data<T>();
-  const T* items_data = items.data<T>();
-  const int64_t num_item = items.dims()[0];
-  const int64_t class_num = items.dims()[1];
-  if (items.dims().size() == 3) {
-    int64_t item_size = items.dims()[2];
-    for (int i = 0; i < num_item; ++i) {
-      std::memcpy(item_data + i * item_size,
-                  items_data + i * class_num * item_size + class_id * item_size,
-                  sizeof(T) * item_size);
-    }
-  } else {
-    for (int i = 0; i < num_item; ++i) {
-      item_data[i] = items_data[i * class_num + class_id];
-    }
-  }
-}
-
-template <typename T>
-void NMSFast(const Tensor& bbox,
-             const Tensor& scores,
-             const T score_threshold,
-             const T nms_threshold,
-             const T eta,
-             const int64_t top_k,
-             std::vector<int>* selected_indices,
-             const bool normalized) {
-  // The total boxes for each instance.
-  int64_t num_boxes = bbox.dims()[0];
-  // 4: [xmin ymin xmax ymax]
-  // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
-  // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
-  int64_t box_size = bbox.dims()[1];
-
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  lite::host::math::GetMaxScoreIndex(
-      scores_data, score_threshold, top_k, &sorted_indices);
-
-  selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox.data<T>();
+// The scores and boxes of an instance. If the scores are 3-D, the instance
+// has the scores of [class_num, num_boxes] and the boxes of
+// [num_boxes, box_size], otherwise the scores are [num_boxes, class_num] and
+// the boxes are [num_boxes, class_num, box_size].
+struct NmsInstance {
+  const float* scores;
+  const float* boxes;
+  int64_t num_boxes;
+  // The offset of the scores of the instance in the batch for the Index.
+  int64_t offset;
+};
 
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = lite::host::math::JaccardOverlap<T>(
-              bbox_data + idx * box_size,
-              bbox_data + kept_idx * box_size,
-              normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap =
-              lite::host::math::PolyIoU<T>(bbox_data + idx * box_size,
-                                           bbox_data + kept_idx * box_size,
-                                           box_size,
-                                           normalized);
-        }
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
+void NMSOneClass(const operators::MulticlassNmsParam& param,
+                 const NmsInstance& instance,
+                 const int64_t class_num,
+                 const int64_t box_size,
+                 const int scores_size,
+                 const int c,
+                 std::vector<int>* selected_indices) {
+  // The classes interleaved in the 2-D scores are accessed by strides.
+  const float* scores = instance.scores + c * instance.num_boxes;
+  int64_t score_stride = 1;
+  const float* boxes = instance.boxes;
+  int64_t box_stride = box_size;
+  if (scores_size == 2) {
+    scores = instance.scores + c;
+    score_stride = class_num;
+    boxes = instance.boxes + c * box_size;
+    box_stride = class_num * box_size;
+  }
+  lite::host::math::NMSFast(boxes,
+                            box_size,
+                            box_stride,
+                            scores,
+                            score_stride,
+                            instance.num_boxes,
+                            param.score_threshold,
+                            param.nms_threshold,
+                            param.nms_eta,
+                            param.nms_top_k,
+                            param.normalized,
+                            selected_indices);
+  if (scores_size == 2) {
+    std::stable_sort(selected_indices->begin(), selected_indices->end());
   }
 }
 
-template <typename T>
-void MultiClassNMS(const operators::MulticlassNmsParam& param,
-                   const Tensor& scores,
-                   const Tensor& bboxes,
-                   const int scores_size,
-                   std::map<int, std::vector<int>>* indices,
-                   int* num_nmsed_out) {
-  int64_t background_label = param.background_label;
-  int64_t nms_top_k = param.nms_top_k;
+// Keep the top keep_top_k detections of all of the classes of an instance,
+// and return the number of the detections kept.
+int KeepTopK(const operators::MulticlassNmsParam& param,
+             const NmsInstance& instance,
+             const int64_t class_num,
+             const int scores_size,
+             std::map<int, std::vector<int>>* indices) {
   int64_t keep_top_k = param.keep_top_k;
-  bool normalized = param.normalized;
-  T nms_threshold = static_cast<T>(param.nms_threshold);
-  T nms_eta = static_cast<T>(param.nms_eta);
-  T score_threshold = static_cast<T>(param.score_threshold);
-
   int num_det = 0;
-
-  int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
-  for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
-    } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
-      SliceOneClass<T>(scores, c, &score_slice);
-      SliceOneClass<T>(bboxes, c, &bbox_slice);
-    }
-    NMSFast(bbox_slice,
-            score_slice,
-            score_threshold,
-            nms_threshold,
-            nms_eta,
-            nms_top_k,
-            &((*indices)[c]),
-            normalized);
-    if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
-    }
-    num_det += (*indices)[c].size();
+  for (const auto& it : *indices) {
+    num_det += it.second.size();
   }
-
-  *num_nmsed_out = num_det;
-  const T* scores_data = scores.data<T>();
-  if (keep_top_k > -1 && num_det > keep_top_k) {
-    const T* sdata;
-    std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
-    for (const auto& it : *indices) {
-      int label = it.first;
-      if (scores_size == 3) {
-        sdata = scores_data + label * scores.dims()[1];
-      } else {
-        score_slice.Resize({scores.dims()[0], 1});
-        SliceOneClass<T>(scores, label, &score_slice);
-        sdata = score_slice.data<T>();
-      }
-      const std::vector<int>& label_indices = it.second;
-      for (size_t j = 0; j < label_indices.size(); ++j) {
-        int idx = label_indices[j];
-        score_index_pairs.push_back(
-            std::make_pair(sdata[idx], std::make_pair(label, idx)));
-      }
+  if (keep_top_k <= -1 || num_det <= keep_top_k) {
+    return num_det;
+  }
+  std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
+  score_index_pairs.reserve(num_det);
+  for (const auto& it : *indices) {
+    int label = it.first;
+    for (int idx : it.second) {
+      float score = scores_size == 3
+                        ? instance.scores[label * instance.num_boxes + idx]
+                        : instance.scores[idx * class_num + label];
+      score_index_pairs.push_back(
+          std::make_pair(score, std::make_pair(label, idx)));
     }
-    // Keep top k results per image.
-    std::stable_sort(
-        score_index_pairs.begin(),
-        score_index_pairs.end(),
-        lite::host::math::SortScorePairDescend<std::pair<int, int>>);
-    score_index_pairs.resize(keep_top_k);
+  }
+  // Keep top k results per image.
+  std::stable_sort(
+      score_index_pairs.begin(),
+      score_index_pairs.end(),
+      lite::host::math::SortScorePairDescend<std::pair<int, int>>);
+  score_index_pairs.resize(keep_top_k);
 
-    // Store the new indices.
-    std::map<int, std::vector<int>> new_indices;
-    for (size_t j = 0; j < score_index_pairs.size(); ++j) {
-      int label = score_index_pairs[j].second.first;
-      int idx = score_index_pairs[j].second.second;
-      new_indices[label].push_back(idx);
-    }
-    if (scores_size == 2) {
-      for (const auto& it : new_indices) {
-        int label = it.first;
-        std::stable_sort(new_indices[label].begin(), new_indices[label].end());
-      }
+  // Store the new indices.
+  std::map<int, std::vector<int>> new_indices;
+  for (size_t j = 0; j < score_index_pairs.size(); ++j) {
+    int label = score_index_pairs[j].second.first;
+    int idx = score_index_pairs[j].second.second;
+    new_indices[label].push_back(idx);
+  }
+  if (scores_size == 2) {
+    for (auto& it : new_indices) {
+      std::stable_sort(it.second.begin(), it.second.end());
     }
-    new_indices.swap(*indices);
-    *num_nmsed_out = keep_top_k;
   }
+  new_indices.swap(*indices);
+  return keep_top_k;
 }
 
-template <typename T>
-void MultiClassOutput(const Tensor& scores,
-                      const Tensor& bboxes,
+void MultiClassOutput(const NmsInstance& instance,
                       const std::map<int, std::vector<int>>& selected_indices,
+                      const int64_t class_num,
+                      const int64_t box_size,
                       const int scores_size,
-                      Tensor* outs,
-                      int* oindices = nullptr,
-                      const int offset = 0) {
-  int64_t class_num = scores.dims()[1];
-  int64_t predict_dim = scores.dims()[1];
-  int64_t box_size = bboxes.dims()[1];
-  if (scores_size == 2) {
-    box_size = bboxes.dims()[2];
-  }
+                      float* odata,
+                      int* oindices) {
   int64_t out_dim = box_size + 2;
-  auto* scores_data = scores.data<T>();
-  auto* bboxes_data = bboxes.data<T>();
-  auto* odata = outs->mutable_data<T>();
-  const T* sdata;
-  Tensor bbox;
-  bbox.Resize({scores.dims()[0], box_size});
   int count = 0;
   for (const auto& it : selected_indices) {
     int label = it.first;
-    const std::vector<int>& indices = it.second;
-    if (scores_size == 2) {
-      SliceOneClass<T>(bboxes, label, &bbox);
-    } else {
-      sdata = scores_data + label * predict_dim;
-    }
-    for (size_t j = 0; j < indices.size(); ++j) {
-      int idx = indices[j];
+    for (int idx : it.second) {
+      const float* bdata;
       odata[count * out_dim] = label;  // label
-      const T* bdata;
       if (scores_size == 3) {
-        bdata = bboxes_data + idx * box_size;
-        odata[count * out_dim + 1] = sdata[idx];  // score
+        bdata = instance.boxes + idx * box_size;
+        odata[count * out_dim + 1] =
+            instance.scores[label * instance.num_boxes + idx];  // score
         if (oindices != nullptr) {
-          oindices[count] = offset + idx;
+          oindices[count] = instance.offset + idx;
         }
       } else {
-        bdata = bbox.data<T>() + idx * box_size;
-        odata[count * out_dim + 1] = *(scores_data + idx * class_num + label);
+        bdata = instance.boxes + (idx * class_num + label) * box_size;
+        odata[count * out_dim + 1] = instance.scores[idx * class_num + label];
         if (oindices != nullptr) {
-          oindices[count] = offset + idx * class_num + label;
+          oindices[count] = instance.offset + idx * class_num + label;
         }
       }
       // xmin, ymin, xmax, ymax or multi-points coordinates
-      std::memcpy(odata + count * out_dim + 2, bdata, box_size * sizeof(T));
+      std::memcpy(odata + count * out_dim + 2, bdata, box_size * sizeof(float));
       count++;
     }
   }
@@ -277,39 +180,63 @@ void MulticlassNmsCompute::Run() {
   auto return_rois_num = param.nms_rois_num != nullptr;
   auto rois_num = param.rois_num;
 
-  std::vector<std::map<int, std::vector<int>>> all_indices;
-  std::vector<uint64_t> batch_starts = {0};
   int64_t batch_size = score_dims[0];
+  int64_t class_num = score_dims[1];
   int64_t box_dim = boxes->dims()[2];
   int64_t out_dim = box_dim + 2;
-  int num_nmsed_out = 0;
-  Tensor boxes_slice, scores_slice;
+  std::vector<uint64_t> boxes_lod;
   int n;
-  if (has_roissum) {
-    n = score_size == 3 ? batch_size : rois_num->numel();
+  if (score_size == 3) {
+    n = batch_size;
+  } else if (has_roissum) {
+    boxes_lod = GetNmsLodFromRoisNum(rois_num);
+    n = rois_num->numel();
   } else {
-    n = score_size == 3 ? batch_size : boxes->lod().back().size() - 1;
+    boxes_lod = boxes->lod().back();
+    n = boxes_lod.size() - 1;
   }
+  std::vector<NmsInstance> instances(n);
   for (int i = 0; i < n; ++i) {
     if (score_size == 3) {
-      scores_slice = scores->Slice<float>(i, i + 1);
-      scores_slice.Resize({score_dims[1], score_dims[2]});
-      boxes_slice = boxes->Slice<float>(i, i + 1);
-      boxes_slice.Resize({score_dims[2], box_dim});
+      int64_t num_boxes = score_dims[2];
+      instances[i].scores = scores->data<float>() + i * class_num * num_boxes;
+      instances[i].boxes = boxes->data<float>() + i * num_boxes * box_dim;
+      instances[i].num_boxes = num_boxes;
+      instances[i].offset = i * num_boxes;
     } else {
-      std::vector<uint64_t> boxes_lod;
-      if (has_roissum) {
-        boxes_lod = GetNmsLodFromRoisNum(rois_num);
-      } else {
-        boxes_lod = boxes->lod().back();
-      }
-      scores_slice = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-      boxes_slice = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
+      instances[i].scores = scores->data<float>() + boxes_lod[i] * class_num;
+      instances[i].boxes =
+          boxes->data<float>() + boxes_lod[i] * class_num * box_dim;
+      instances[i].num_boxes = boxes_lod[i + 1] - boxes_lod[i];
+      instances[i].offset = boxes_lod[i] * class_num;
     }
-    std::map<int, std::vector<int>> indices;
-    MultiClassNMS<float>(
-        param, scores_slice, boxes_slice, score_size, &indices, &num_nmsed_out);
-    all_indices.push_back(indices);
+  }
+
+  // The classes of all of the instances are suppressed in parallel.
+  int num_tasks = n * class_num;
+  std::vector<std::vector<int>> class_indices(num_tasks);
+#pragma omp parallel for
+  for (int t = 0; t < num_tasks; ++t) {
+    int c = t % class_num;
+    if (c == param.background_label) continue;
+    NMSOneClass(param,
+                instances[t / class_num],
+                class_num,
+                box_dim,
+                score_size,
+                c,
+                &class_indices[t]);
+  }
+
+  std::vector<std::map<int, std::vector<int>>> all_indices(n);
+  std::vector<uint64_t> batch_starts = {0};
+  for (int i = 0; i < n; ++i) {
+    for (int c = 0; c < class_num; ++c) {
+      if (c == param.background_label) continue;
+      all_indices[i][c].swap(class_indices[i * class_num + c]);
+    }
+    int num_nmsed_out = KeepTopK(
+        param, instances[i], class_num, score_size, &all_indices[i]);
     batch_starts.push_back(batch_starts.back() + num_nmsed_out);
   }
 
@@ -326,59 +253,34 @@ void MulticlassNmsCompute::Run() {
     }
   } else {
     outs->Resize({static_cast<int64_t>(num_kept), out_dim});
-    outs->mutable_data<float>();
-    int offset = 0;
+    float* odata = outs->mutable_data<float>();
     int* oindices = nullptr;
+    if (return_index) {
+      index->Resize({static_cast<int64_t>(num_kept), 1});
+      oindices = index->mutable_data<int>();
+    }
     for (int i = 0; i < n; ++i) {
-      if (score_size == 3) {
-        scores_slice = scores->Slice<float>(i, i + 1);
-        boxes_slice = boxes->Slice<float>(i, i + 1);
-        scores_slice.Resize({score_dims[1], score_dims[2]});
-        boxes_slice.Resize({score_dims[2], box_dim});
-        if (return_index) {
-          offset = i * score_dims[2];
-        }
-      } else {
-        std::vector<uint64_t> boxes_lod;
-        if (has_roissum) {
-          boxes_lod = GetNmsLodFromRoisNum(rois_num);
-        } else {
-          boxes_lod = boxes->lod().back();
-        }
-        scores_slice = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-        boxes_slice = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-        if (return_index) {
-          offset = boxes_lod[i] * score_dims[1];
-        }
-      }
       int64_t s = static_cast<int64_t>(batch_starts[i]);
       int64_t e = static_cast<int64_t>(batch_starts[i + 1]);
       if (e > s) {
-        Tensor out = outs->Slice<float>(s, e);
-        if (return_index) {
-          index->Resize({static_cast<int64_t>(num_kept), 1});
-          int* output_idx = index->mutable_data<int>();
-          oindices = output_idx + s;
-        }
-        MultiClassOutput<float>(scores_slice,
-                                boxes_slice,
-                                all_indices[i],
-                                score_dims.size(),
-                                &out,
-                                oindices,
-                                offset);
+        MultiClassOutput(instances[i],
+                         all_indices[i],
+                         class_num,
+                         box_dim,
+                         score_size,
+                         odata + s * out_dim,
+                         oindices ? oindices + s : nullptr);
       }
     }
   }
 
   if (return_rois_num) {
     auto* nms_rois_num = param.nms_rois_num;
-    nms_rois_num->mutable_data<int>();
+    nms_rois_num->Resize({n});
     int* num_data = nms_rois_num->mutable_data<int>();
     for (int i = 1; i <= n; i++) {
       num_data[i - 1] = batch_starts[i] - batch_starts[i - 1];
     }
-    nms_rois_num->Resize({n});
   }
 
   LoD lod;
@@ -21,6 +21,10 @@ namespace lite {
 namespace kernels {
 namespace host {
 
+bool ReshapeCompute::AliasesInput() const {
+  return Param<operators::ReshapeParam>().inplace;
+}
+
 void ReshapeCompute::Run() {
   auto& param = Param<operators::ReshapeParam>();
   auto x = param.x;
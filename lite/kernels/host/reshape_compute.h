@@ -27,6 +27,8 @@ class ReshapeCompute
  public:
   void Run() override;
 
+  bool AliasesInput() const override;
+
   virtual ~ReshapeCompute() = default;
 };
 
@@ -20,6 +20,10 @@ namespace lite {
 namespace kernels {
 namespace host {
 
+bool SqueezeCompute::AliasesInput() const {
+  return Param<operators::SqueezeParam>().inplace;
+}
+
 void SqueezeCompute::Run() {
   auto& param = Param<operators::SqueezeParam>();
   auto x = param.X;
@@ -27,6 +27,8 @@ class SqueezeCompute
  public:
   void Run() override;
 
+  bool AliasesInput() const override;
+
   virtual ~SqueezeCompute() = default;
 };
 
@@ -13,16 +13,12 @@
 // limitations under the License.
 
 #include "lite/kernels/host/topk_v2_compute.h"
-#include <utility>
-#include <vector>
+#include "lite/backends/host/math/topk.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
-bool comp_func(std::pair<float, int> a, std::pair<float, int> b) {
-  return (a.first > b.first);
-}
 
 void TopkV2Compute::Run() {
   auto& param = Param<operators::TopkParam>();
@@ -42,24 +38,8 @@ void TopkV2Compute::Run() {
   int outer_size = x_dims.count(0, axis);
   int axis_size = x_dims[axis];
   int inner_size = x_dims.count(axis + 1, dim_size);
-  int sum_size = axis_size * inner_size;
-  int out_sum_size = k * inner_size;
-  for (int n = 0; n < outer_size; n++) {
-    const float* in_data = x_data + n * sum_size;
-    float* out_data = out_val + n * out_sum_size;
-    int64_t* out_ind_data = out_ind + n * out_sum_size;
-    for (int i = 0; i < inner_size; i++) {
-      std::vector<std::pair<float, int>> vec;
-      for (int j = 0; j < axis_size; j++) {
-        vec.push_back(std::make_pair(in_data[j * inner_size + i], j));
-      }
-      std::partial_sort(vec.begin(), vec.begin() + k, vec.end(), comp_func);
-      for (int j = 0; j < k; j++) {
-        out_data[j * inner_size + i] = vec[j].first;
-        out_ind_data[j * inner_size + i] = vec[j].second;
-      }
-    }
-  }
+  lite::host::math::topk(
+      x_data, out_val, out_ind, outer_size, axis_size, inner_size, k);
 }
 
 }  // namespace host
@@ -21,6 +21,10 @@ namespace lite {
 namespace kernels {
 namespace host {
 
+bool UnsqueezeCompute::AliasesInput() const {
+  return Param<operators::UnsqueezeParam>().inplace;
+}
+
 void UnsqueezeCompute::Run() {
   auto& param = Param<operators::UnsqueezeParam>();
   auto x = param.X;
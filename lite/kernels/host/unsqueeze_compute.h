@@ -27,6 +27,8 @@ class UnsqueezeCompute
  public:
   void Run() override;
 
+  bool AliasesInput() const override;
+
   virtual ~UnsqueezeCompute() = default;
 };
 
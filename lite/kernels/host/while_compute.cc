@@ -30,8 +30,10 @@ void WhileCompute::PrepareForRun() {
 }
 void WhileCompute::Run() {
   auto &param = this->Param<param_t>();
+  bool first_iteration = true;
   while (param.cond->data<bool>()[0]) {
-    program_->Run();
+    program_->RunBody(first_iteration);
+    first_iteration = false;
   }
 }
 
@@ -37,6 +37,10 @@ class ConcatCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::ConcatParam;
 
+  bool AliasesInput() const override {
+    return Param<param_t>().x.size() == 1;
+  }
+
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
     if (param.x.size() == 1) {
@@ -36,8 +36,14 @@ void Conv2dCompute<float>::PrepareForRun() {
   const int stride_h = param.strides[0];
   const int stride_w = param.strides[1];
 
-  if (input_channel == groups && output_channel == groups &&
+  // The depthwise kernels take the fp32 filter only, the quantized filter is
+  // run by the weight-only gemm instead.
+  bool weight_only = lite::x86::math::is_weight_only_quantized(
+      *param.filter, param.weight_quant_scale);
+  if (!weight_only && input_channel == groups && output_channel == groups &&
       (groups & 3) == 0) {
+#if !defined(LITE_X86_CONV_TAILORED) || defined(LITE_TAILORED_CONV_DW3X3S1) || \
+    defined(LITE_TAILORED_CONV_DW3X3S2) || defined(LITE_TAILORED_CONV_DW)
     if (kernel_h == 3 && kernel_w == 3 && stride_h == 1 && stride_w == 1) {
       impl_ = new DepthwiseConv<float>;
       VLOG(3) << "invoking conv_depthwise_3x3s1";
@@ -46,6 +52,7 @@ void Conv2dCompute<float>::PrepareForRun() {
       impl_ = new DepthwiseConv<float>;
       VLOG(3) << "invoking conv_depthwise_3x3s2";
     }
+#endif
   }
 
   if (impl_) {
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <memory>
 #include <string>
 #include <vector>
 #include "lite/backends/x86/math/blas.h"
@@ -23,9 +24,11 @@
 #endif
 #include "lite/backends/x86/math/im2col.h"
 #include "lite/backends/x86/math/vol2col.h"
+#include "lite/backends/x86/math/weight_only_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
+#include "lite/kernels/x86/conv_depthwise.h"
 #include "lite/operators/conv_op.h"
 
 namespace paddle {
@@ -47,6 +50,20 @@ inline bool IsExpand(const std::vector<int64_t>& filter_dim,
   return !(filter_1 && strides_1 && padding_0 && dilation_1);
 }
 
+// The shape of the im2col or vol2col buffer of a group.
+inline lite::DDim ColShape(const operators::ConvParam& param) {
+  std::vector<int64_t> filter_shape_vec(param.filter->dims().Vectorize());
+  std::vector<int64_t> output_shape_vec(param.output->dims().Vectorize());
+  size_t data_dim = filter_shape_vec.size() - 2;
+  std::vector<int64_t> col_shape_vec(1 + 2 * data_dim);
+  col_shape_vec[0] = param.x->dims()[1] / param.groups;
+  for (size_t j = 0; j < data_dim; ++j) {
+    col_shape_vec[j + 1] = filter_shape_vec[j + 2];
+    col_shape_vec[j + 1 + data_dim] = output_shape_vec[j + 2];
+  }
+  return lite::DDim(col_shape_vec);
+}
+
 template <typename T>
 class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -58,6 +75,28 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     }
   }
 
+  virtual size_t WorkspaceSize() {
+    if (impl_) {
+      return 0;
+    }
+    auto& param = *param_.get_mutable<operators::ConvParam>();
+    size_t size = 0;
+    if (lite::x86::math::is_weight_only_quantized(*param.filter,
+                                                  param.weight_quant_scale)) {
+      auto& filter_dims = param.filter->dims();
+      size = lite::x86::math::weight_only_gemm_workspace_size(
+          filter_dims[0] / param.groups,
+          filter_dims.production() / filter_dims[0]);
+    }
+    if (!IsExpand(param.filter->dims().Vectorize(),
+                  param.strides,
+                  *param.paddings,
+                  *param.dilations)) {
+      return size;
+    }
+    return size + ColShape(param).production() * sizeof(T);
+  }
+
   virtual void Run() {
     if (impl_) {
       return impl_->Run();
@@ -88,21 +127,39 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     }
 
     std::vector<int64_t> filter_shape_vec(filter.dims().Vectorize());
-    std::vector<int64_t> output_shape_vec(param.output->dims().Vectorize());
     size_t data_dim = filter_shape_vec.size() - 2;
-    std::vector<int64_t> col_shape_vec(1 + 2 * data_dim);
-    col_shape_vec[0] = param.x->dims()[1] / param.groups;
-    for (size_t j = 0; j < data_dim; ++j) {
-      col_shape_vec[j + 1] = filter_shape_vec[j + 2];
-      col_shape_vec[j + 1 + data_dim] = output_shape_vec[j + 2];
-    }
-    lite::DDim col_shape(col_shape_vec);
+    lite::DDim col_shape = ColShape(param);
     lite::DDim col_matrix_shape = col_shape.Flatten2D(data_dim + 1);
     bool is_expand = IsExpand(
         filter_shape_vec, param.strides, *param.paddings, *param.dilations);
+    // The filter quantized by post_quant_dynamic_pass is kept in
+    // int8/int16/fp16/bf16, and dequantized tile by tile in the workspace.
+    bool weight_only = lite::x86::math::is_weight_only_quantized(
+        filter, param.weight_quant_scale);
+    void* weight_only_workspace = nullptr;
+    if (weight_only) {
+      CHECK_EQ(param.weight_quant_scale.size(),
+               static_cast<size_t>(filter.dims()[0]));
+      weight_only_workspace = this->workspace()->Alloc(
+          lite::x86::math::weight_only_gemm_workspace_size(
+              filter.dims()[0] / param.groups,
+              filter.dims().production() / filter.dims()[0]));
+    }
+#if defined(LITE_X86_CONV_TAILORED) && !defined(LITE_TAILORED_CONV_1X1)
+    CHECK(is_expand) << "The 1x1 conv is tailored out of the library.";
+#endif
+#if defined(LITE_X86_CONV_TAILORED) && !defined(LITE_TAILORED_CONV_IM2COL)
+    CHECK(!is_expand) << "The im2col conv is tailored out of the library.";
+#endif
     lite::Tensor col;
     lite::Tensor col_matrix;
     if (is_expand) {
+      // The col buffer is reserved in the workspace by WorkspaceSize.
+      size_t col_size = col_shape.production() * sizeof(T);
+      auto* col_data = this->workspace()->Alloc(col_size);
+      col.ResetBuffer(
+          std::make_shared<Buffer>(col_data, TARGET(kX86), col_size),
+          col_size);
       col.Resize(col_shape);
       col.mutable_data<T>();
       col_matrix.ShareDataWith(col);
@@ -141,6 +198,7 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
           col_matrix.ShareDataWith(col);
           col_matrix.Resize(col_matrix_shape);
         } else if (data_dim == 2U && !flag_1x1gemm) {
+#if !defined(LITE_X86_CONV_TAILORED) || defined(LITE_TAILORED_CONV_IM2COL)
           // im2col
           im2col(context,
                  in_slice,
@@ -149,6 +207,7 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
                  std::vector<int>{
                      paddings[0], paddings[2], paddings[0], paddings[2]},
                  &(col));
+#endif
         } else if (data_dim == 3U) {
           // vol2col
           vol2col(context,
@@ -164,6 +223,16 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
         out_slice =
             out_batch.Slice<T>(static_cast<int64_t>(g * out_step),
                                static_cast<int64_t>((g + 1) * out_step));
+        if (weight_only) {
+          RunWeightOnlyGemm(context,
+                            filter,
+                            g * out_step,
+                            out_step,
+                            col_matrix,
+                            &out_slice,
+                            weight_only_workspace);
+          continue;
+        }
         lite::Tensor filter_slice;
         filter_slice =
             filter.Slice<T>(static_cast<int64_t>(g * out_step),
@@ -231,6 +300,35 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
  private:
   using param_t = operators::ConvParam;
+
+  // out = filter[row_begin : row_begin + rows] * col, the filter matrix is in
+  // int8/int16/fp16/bf16 and each row has its own scale.
+  void RunWeightOnlyGemm(const X86Context& context,
+                         const lite::Tensor& filter,
+                         const int row_begin,
+                         const int rows,
+                         const lite::Tensor& col,
+                         lite::Tensor* out,
+                         void* workspace) {
+    auto& param = *param_.get_mutable<operators::ConvParam>();
+    const int K = filter.dims()[1];
+    const int N = col.dims()[1];
+    const float* scale = param.weight_quant_scale.data() + row_begin;
+    const int64_t offset = static_cast<int64_t>(row_begin) * K;
+    lite::x86::math::weight_only_gemm_row_scale(
+        context,
+        rows,
+        N,
+        K,
+        filter,
+        lite::x86::math::get_weight_only_type(filter, param.weight_quant_type),
+        offset,
+        scale,
+        col.data<float>(),
+        out->template mutable_data<float>(),
+        workspace);
+  }
+
   KernelLite<TARGET(kX86), PRECISION(kFloat)>* impl_{nullptr};
 };
 
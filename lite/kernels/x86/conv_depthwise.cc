@@ -91,6 +91,7 @@ void DepthwiseConv<float>::Run() {
   if (pack_size == 8) {
     if (kernel_h == 3 && kernel_w == 3 && stride_h == 1 && stride_w == 1 &&
         dilation_h == 1 && dilation_w == 1) {
+#if !defined(LITE_X86_CONV_TAILORED) || defined(LITE_TAILORED_CONV_DW3X3S1)
       lite::x86::math::conv_depthwise_3x3s1_m256(&input_padding_,
                                                  &output_pack_,
                                                  &filter_pack_,
@@ -99,9 +100,13 @@ void DepthwiseConv<float>::Run() {
                                                  act_type);
 #ifdef LITE_WITH_PROFILE
       kernel_func_name_ = "conv_depthwise_3x3s1_m256";
+#endif
+#else
+      LOG(FATAL) << "The depthwise conv 3x3s1 is tailored out of the library.";
 #endif
     } else if (kernel_h == 3 && kernel_w == 3 && stride_h == 2 &&
                stride_w == 2 && dilation_h == 1 && dilation_w == 1) {
+#if !defined(LITE_X86_CONV_TAILORED) || defined(LITE_TAILORED_CONV_DW3X3S2)
       lite::x86::math::conv_depthwise_3x3s2_m256(&input_padding_,
                                                  &output_pack_,
                                                  &filter_pack_,
@@ -110,8 +115,12 @@ void DepthwiseConv<float>::Run() {
                                                  act_type);
 #ifdef LITE_WITH_PROFILE
       kernel_func_name_ = "conv_depthwise_3x3s2_m256";
+#endif
+#else
+      LOG(FATAL) << "The depthwise conv 3x3s2 is tailored out of the library.";
 #endif
     } else {
+#if !defined(LITE_X86_CONV_TAILORED) || defined(LITE_TAILORED_CONV_DW)
       lite::x86::math::conv_depthwise_m256(&input_padding_,
                                            &output_pack_,
                                            &filter_pack_,
@@ -124,9 +133,13 @@ void DepthwiseConv<float>::Run() {
                                            act_type);
 #ifdef LITE_WITH_PROFILE
       kernel_func_name_ = "conv_depthwise_m256";
+#endif
+#else
+      LOG(FATAL) << "The depthwise conv is tailored out of the library.";
 #endif
     }
   } else if (pack_size == 4) {
+#if !defined(LITE_X86_CONV_TAILORED) || defined(LITE_TAILORED_CONV_DW)
     lite::x86::math::conv_depthwise_m128(&input_padding_,
                                          &output_pack_,
                                          &filter_pack_,
@@ -139,6 +152,9 @@ void DepthwiseConv<float>::Run() {
                                          act_type);
 #ifdef LITE_WITH_PROFILE
     kernel_func_name_ = "conv_depthwise_m128";
+#endif
+#else
+    LOG(FATAL) << "The depthwise conv is tailored out of the library.";
 #endif
   }
 
@@ -19,6 +19,13 @@
 #include "lite/core/kernel.h"
 #include "lite/core/target_wrapper.h"
 
+// The library tailored by a model set keeps only the conv paths recorded by
+// opt into .tailored_kernels_attrs_list, e.g. LITE_TAILORED_CONV_1X1, and the
+// other paths are compiled out. The paths are recorded for the AVX build.
+#if defined(LITE_WITH_TAILORED_ATTRS) && defined(LITE_WITH_AVX)
+#define LITE_X86_CONV_TAILORED
+#endif
+
 namespace paddle {
 namespace lite {
 namespace kernels {
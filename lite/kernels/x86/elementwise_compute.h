@@ -75,151 +75,178 @@ struct MinFunctor {
   inline HOSTDEVICE T operator()(T a, T b) const { return a < b ? a : b; }
 };
 
-template <typename T>
-class ElementwiseAddCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
-  void Run() override {
-    auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<AddFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, AddFunctor<T>(), param.Out);
-  }
+#ifdef __AVX__
+template <>
+struct ElementwiseAVXFunctor<AddFunctor<float>> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+};
 
-  virtual ~ElementwiseAddCompute() = default;
+template <>
+struct ElementwiseAVXFunctor<SubFunctor<float>> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
 };
 
-template <typename T>
-class ElementwiseSubCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
+template <>
+struct ElementwiseAVXFunctor<MulFunctor<float>> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+};
 
-  void Run() override {
-    auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
+template <>
+struct ElementwiseAVXFunctor<DivFunctor<float>> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+};
 
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<SubFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, SubFunctor<T>(), param.Out);
-  }
+template <>
+struct ElementwiseAVXFunctor<MaxFunctor<float>> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+};
 
-  virtual ~ElementwiseSubCompute() = default;
+template <>
+struct ElementwiseAVXFunctor<MinFunctor<float>> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
 };
+#endif
 
-template <typename T>
-class ElementwiseMulCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+inline lite_api::ActivationType GetElementwiseActType(
+    const operators::ElementwiseParam& param) {
+  return lite_api::ActivationType::kIndentity;
+}
+
+inline lite_api::ActivationType GetElementwiseActType(
+    const operators::FusionElementwiseActivationParam& param) {
+  if (param.act_type == "relu") {
+    return lite_api::ActivationType::kRelu;
+  } else if (param.act_type == "abs") {
+    return lite_api::ActivationType::kAbs;
+  } else if (param.act_type == "tanh") {
+    return lite_api::ActivationType::kTanh;
+  }
+  LOG(FATAL) << "unsupported Activation type: " << param.act_type;
+  return lite_api::ActivationType::kIndentity;
+}
+
+// Out = act(Functor(X, Y)). The broadcast of Y is decided in PrepareForRun,
+// and decided again if the dims are changed. The same-shape, scalar,
+// per-channel and row broadcasts run the specialized loops, the others run
+// ElementwiseComputeEx.
+template <typename T,
+          typename Functor,
+          typename ParamType = operators::ElementwiseParam>
+class ElementwiseCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
-  using param_t = operators::ElementwiseParam;
-  void Run() override {
+  using param_t = ParamType;
+
+  void PrepareForRun() override {
     auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<MulFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, MulFunctor<T>(), param.Out);
+    act_type_ = GetElementwiseActType(param);
+    UpdateBroadcast(param);
   }
 
-  virtual ~ElementwiseMulCompute() = default;
-};
-
-template <typename T>
-class ElementwiseDivCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
+    UpdateBroadcast(param);
     param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<DivFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, DivFunctor<T>(), param.Out);
+    switch (act_type_) {
+      case lite_api::ActivationType::kRelu:
+        RunWithAct<lite_api::ActivationType::kRelu>(param);
+        break;
+      case lite_api::ActivationType::kAbs:
+        RunWithAct<lite_api::ActivationType::kAbs>(param);
+        break;
+      case lite_api::ActivationType::kTanh:
+        RunWithAct<lite_api::ActivationType::kTanh>(param);
+        break;
+      default:
+        RunWithAct<lite_api::ActivationType::kIndentity>(param);
+        break;
+    }
   }
 
-  virtual ~ElementwiseDivCompute() = default;
-};
+  virtual ~ElementwiseCompute() = default;
 
-template <typename T>
-class ElementwiseFloorDivCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
-  void Run() override {
-    auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<FloorDivFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, FloorDivFunctor<T>(), param.Out);
+ private:
+  void UpdateBroadcast(const param_t& param) {
+    if (param.X->dims() == x_dims_ && param.Y->dims() == y_dims_) {
+      return;
+    }
+    x_dims_ = param.X->dims();
+    y_dims_ = param.Y->dims();
+    broadcast_ = GetBroadcastInfo(x_dims_, y_dims_, param.axis);
+  }
+
+  template <lite_api::ActivationType Act>
+  void RunWithAct(const param_t& param) {
+    auto* out_data = param.Out->template mutable_data<T>();
+    if (broadcast_.type == BroadcastType::kGeneric) {
+      auto& context = ctx_->As<X86Context>();
+      ElementwiseComputeEx<Functor, lite::TargetType::kX86, T>(
+          context, param.X, param.Y, param.axis, Functor(), param.Out);
+      ElementwiseActivate<T, Act>(out_data, param.Out->numel());
+      return;
+    }
+    ElementwiseBroadcastCompute<T, Functor, Act>(param.X->template data<T>(),
+                                                 param.Y->template data<T>(),
+                                                 out_data,
+                                                 broadcast_,
+                                                 Functor());
   }
 
-  virtual ~ElementwiseFloorDivCompute() = default;
+  lite_api::ActivationType act_type_{lite_api::ActivationType::kIndentity};
+  lite::DDim x_dims_;
+  lite::DDim y_dims_;
+  BroadcastInfo broadcast_;
 };
 
 template <typename T>
-class ElementwisePowCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
-  void Run() override {
-    auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<PowFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, PowFunctor<T>(), param.Out);
-  }
+using ElementwiseAddCompute = ElementwiseCompute<T, AddFunctor<T>>;
 
-  virtual ~ElementwisePowCompute() = default;
-};
+template <typename T>
+using ElementwiseSubCompute = ElementwiseCompute<T, SubFunctor<T>>;
 
 template <typename T>
-class ElementwiseModCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
-  void Run() override {
-    auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<ModFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, ModFunctor<T>(), param.Out);
-  }
+using ElementwiseMulCompute = ElementwiseCompute<T, MulFunctor<T>>;
 
-  virtual ~ElementwiseModCompute() = default;
-};
+template <typename T>
+using ElementwiseDivCompute = ElementwiseCompute<T, DivFunctor<T>>;
 
 template <typename T>
-class ElementwiseMaxCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
-  void Run() override {
-    auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<MaxFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, MaxFunctor<T>(), param.Out);
-  }
+using ElementwiseFloorDivCompute = ElementwiseCompute<T, FloorDivFunctor<T>>;
 
-  virtual ~ElementwiseMaxCompute() = default;
-};
+template <typename T>
+using ElementwisePowCompute = ElementwiseCompute<T, PowFunctor<T>>;
 
 template <typename T>
-class ElementwiseMinCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
- public:
-  using param_t = operators::ElementwiseParam;
-  void Run() override {
-    auto& param = *param_.get_mutable<param_t>();
-    auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    ElementwiseComputeEx<MinFunctor<T>, lite::TargetType::kX86, T>(
-        context, param.X, param.Y, param.axis, MinFunctor<T>(), param.Out);
-  }
+using ElementwiseModCompute = ElementwiseCompute<T, ModFunctor<T>>;
 
-  virtual ~ElementwiseMinCompute() = default;
-};
+template <typename T>
+using ElementwiseMaxCompute = ElementwiseCompute<T, MaxFunctor<T>>;
+
+template <typename T>
+using ElementwiseMinCompute = ElementwiseCompute<T, MinFunctor<T>>;
+
+template <typename T>
+using ElementwiseAddActivationCompute =
+    ElementwiseCompute<T,
+                       AddFunctor<T>,
+                       operators::FusionElementwiseActivationParam>;
+
+template <typename T>
+using ElementwiseSubActivationCompute =
+    ElementwiseCompute<T,
+                       SubFunctor<T>,
+                       operators::FusionElementwiseActivationParam>;
+
+template <typename T>
+using ElementwiseMulActivationCompute =
+    ElementwiseCompute<T,
+                       MulFunctor<T>,
+                       operators::FusionElementwiseActivationParam>;
 
 }  // namespace x86
 }  // namespace kernels
@@ -14,10 +14,17 @@ limitations under the License. */
 
 #pragma once
 
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
 #include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <type_traits>
 #include <vector>
+#include "lite/api/paddle_place.h"
 #include "lite/backends/x86/math/math_function.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/fluid/eigen.h"
 #include "lite/fluid/for_range.h"
 #include "lite/fluid/transform.h"
@@ -338,6 +345,248 @@ void ElementwiseComputeEx(const lite::Context<Target> &ctx,
   }
 }
 
+// The broadcasts of Y which are run by the fast paths below instead of
+// ElementwiseComputeEx.
+enum class BroadcastType {
+  kGeneric,  // the others, e.g. X(2, 3, 4) and Y(2, 1, 4)
+  kSame,     // X and Y have the same number of elements
+  kScalar,   // Y has one element
+  kChannel,  // X(pre, n, post) and Y(n), e.g. the per-channel Y of NCHW
+  kRow,      // X(pre, n) and Y(n), Y is broadcast along the leading dims
+};
+
+struct BroadcastInfo {
+  BroadcastType type{BroadcastType::kGeneric};
+  int pre{1};
+  int n{1};
+  int post{1};
+};
+
+inline BroadcastInfo GetBroadcastInfo(const lite::DDim &x_dims,
+                                      const lite::DDim &y_dims,
+                                      int axis) {
+  BroadcastInfo info;
+  if (x_dims == y_dims) {
+    info.type = BroadcastType::kSame;
+    info.n = x_dims.production();
+    return info;
+  }
+  if (x_dims.size() < y_dims.size()) {
+    return info;
+  }
+  if (y_dims.production() == 1) {
+    info.type = BroadcastType::kScalar;
+    info.n = x_dims.production();
+    return info;
+  }
+  axis = (axis == -1 ? x_dims.size() - y_dims.size() : axis);
+  if (axis < 0 || axis >= static_cast<int>(x_dims.size())) {
+    return info;
+  }
+  int mid_flag = 0;
+  get_mid_dims(x_dims,
+               trim_trailing_singular_dims(y_dims),
+               axis,
+               &info.pre,
+               &info.n,
+               &info.post,
+               &mid_flag);
+  if (mid_flag) {
+    return info;
+  }
+  if (info.pre == 1 && info.post == 1) {
+    info.type = BroadcastType::kSame;
+  } else {
+    info.type = info.post == 1 ? BroadcastType::kRow : BroadcastType::kChannel;
+  }
+  return info;
+}
+
+// The activation fused into the elementwise kernels.
+template <typename T, lite_api::ActivationType Act>
+struct ElementwiseActFunctor {
+  static inline T Apply(T v) { return v; }
+};
+
+template <typename T>
+struct ElementwiseActFunctor<T, lite_api::ActivationType::kRelu> {
+  static inline T Apply(T v) { return v > static_cast<T>(0) ? v : 0; }
+};
+
+template <typename T>
+struct ElementwiseActFunctor<T, lite_api::ActivationType::kAbs> {
+  static inline T Apply(T v) { return v < static_cast<T>(0) ? -v : v; }
+};
+
+template <typename T>
+struct ElementwiseActFunctor<T, lite_api::ActivationType::kTanh> {
+  static inline T Apply(T v) { return static_cast<T>(std::tanh(v)); }
+};
+
+template <typename T, lite_api::ActivationType Act>
+void ElementwiseActivate(T *out, int64_t size) {
+  if (Act == lite_api::ActivationType::kIndentity) {
+    return;
+  }
+  for (int64_t i = 0; i < size; i++) {
+    out[i] = ElementwiseActFunctor<T, Act>::Apply(out[i]);
+  }
+}
+
+#ifdef __AVX__
+// The AVX version of the binary functor, it's specialized along with the
+// functors in elementwise_compute.h. The functors without it, e.g. pow, run
+// the scalar loops.
+template <typename Functor>
+struct ElementwiseAVXFunctor {
+  static const bool kValid = false;
+  static inline __m256 Apply(__m256 a, __m256 b) { return a; }
+};
+
+// The AVX version of the activation, tanh runs the scalar loops.
+template <lite_api::ActivationType Act>
+struct ElementwiseAVXActFunctor {
+  static const bool kValid = false;
+  static inline __m256 Apply(__m256 v) { return v; }
+};
+
+template <>
+struct ElementwiseAVXActFunctor<lite_api::ActivationType::kIndentity> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 v) { return v; }
+};
+
+template <>
+struct ElementwiseAVXActFunctor<lite_api::ActivationType::kRelu> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 v) {
+    return _mm256_max_ps(v, _mm256_setzero_ps());
+  }
+};
+
+template <>
+struct ElementwiseAVXActFunctor<lite_api::ActivationType::kAbs> {
+  static const bool kValid = true;
+  static inline __m256 Apply(__m256 v) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.f), v);
+  }
+};
+#endif
+
+// out[i] = act(func(x[i], y[i])) of a row of `size` elements, or
+// out[i] = act(func(x[i], *y)) if YScalar.
+template <typename T,
+          typename Functor,
+          lite_api::ActivationType Act,
+          bool YScalar,
+          bool AVX = false>
+struct ElementwiseRow {
+  static inline void Run(
+      const T *x, const T *y, T *out, int64_t size, Functor func) {
+    if (YScalar) {
+      const T y_val = *y;
+      for (int64_t i = 0; i < size; i++) {
+        out[i] = ElementwiseActFunctor<T, Act>::Apply(func(x[i], y_val));
+      }
+    } else {
+      for (int64_t i = 0; i < size; i++) {
+        out[i] = ElementwiseActFunctor<T, Act>::Apply(func(x[i], y[i]));
+      }
+    }
+  }
+};
+
+#ifdef __AVX__
+template <typename Functor, lite_api::ActivationType Act, bool YScalar>
+struct ElementwiseRow<float, Functor, Act, YScalar, true> {
+  static inline void Run(const float *x,
+                         const float *y,
+                         float *out,
+                         int64_t size,
+                         Functor func) {
+    int64_t i = 0;
+    const __m256 y_vec = _mm256_set1_ps(*y);
+    for (; i + 8 <= size; i += 8) {
+      __m256 y_val = YScalar ? y_vec : _mm256_loadu_ps(y + i);
+      __m256 out_val = ElementwiseAVXFunctor<Functor>::Apply(
+          _mm256_loadu_ps(x + i), y_val);
+      _mm256_storeu_ps(out + i,
+                       ElementwiseAVXActFunctor<Act>::Apply(out_val));
+    }
+    ElementwiseRow<float, Functor, Act, YScalar>::Run(
+        x + i, YScalar ? y : y + i, out + i, size - i, func);
+  }
+};
+#endif
+
+// Run the broadcast of `info` which isn't kGeneric. The rows, or the blocks of
+// the flat kSame and kScalar data, are split among the threads.
+template <typename T, typename Functor, lite_api::ActivationType Act>
+void ElementwiseBroadcastCompute(const T *x,
+                                 const T *y,
+                                 T *out,
+                                 const BroadcastInfo &info,
+                                 Functor func) {
+#ifdef __AVX__
+  const bool kAVX = std::is_same<T, float>::value &&
+                    ElementwiseAVXFunctor<Functor>::kValid &&
+                    ElementwiseAVXActFunctor<Act>::kValid;
+#else
+  const bool kAVX = false;
+#endif
+  typedef ElementwiseRow<T, Functor, Act, false, kAVX> VectorRow;
+  typedef ElementwiseRow<T, Functor, Act, true, kAVX> ScalarRow;
+  const int64_t kBlockSize = 4096;
+  int64_t rows = 0;
+  int64_t row_size = 0;
+  if (info.type == BroadcastType::kSame ||
+      info.type == BroadcastType::kScalar) {
+    rows = (info.n + kBlockSize - 1) / kBlockSize;
+    row_size = kBlockSize;
+  } else if (info.type == BroadcastType::kChannel) {
+    rows = static_cast<int64_t>(info.pre) * info.n;
+    row_size = info.post;
+  } else {
+    CHECK(info.type == BroadcastType::kRow);
+    rows = info.pre;
+    row_size = info.n;
+  }
+  auto run_rows = [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      int64_t offset = r * row_size;
+      switch (info.type) {
+        case BroadcastType::kSame:
+          VectorRow::Run(x + offset,
+                         y + offset,
+                         out + offset,
+                         (std::min)(row_size, info.n - offset),
+                         func);
+          break;
+        case BroadcastType::kScalar:
+          ScalarRow::Run(x + offset,
+                         y,
+                         out + offset,
+                         (std::min)(row_size, info.n - offset),
+                         func);
+          break;
+        case BroadcastType::kChannel:
+          ScalarRow::Run(
+              x + offset, y + r % info.n, out + offset, row_size, func);
+          break;
+        default:
+          VectorRow::Run(x + offset, y, out + offset, row_size, func);
+          break;
+      }
+    }
+  };
+  // The small data isn't worth the threads.
+  if (rows * row_size < 16 * kBlockSize) {
+    run_rows(0, rows);
+  } else {
+    lite::x86::RunParallelFor(0, rows, run_rows);
+  }
+}
+
 // FusedElemwiseAndAct
 // --- forward
 template <typename T, typename CompoundFunctor, bool KeepIntermediateOut>
@@ -19,6 +19,7 @@
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/weight_only_gemm.h"
 #include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
@@ -125,6 +126,16 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::FcParam;
 
+  size_t WorkspaceSize() override {
+    auto& param = *param_.get_mutable<param_t>();
+    if (!lite::x86::math::is_weight_only_quantized(*param.w,
+                                                   param.weight_quant_scale)) {
+      return 0;
+    }
+    return lite::x86::math::weight_only_gemm_workspace_size(param.w->dims()[0],
+                                                            param.w->dims()[1]);
+  }
+
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
     auto* input = param.input;
@@ -145,6 +156,11 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     T* output_data = output->template mutable_data<T>();
 
     auto& context = ctx_->As<X86Context>();
+    if (lite::x86::math::is_weight_only_quantized(*w,
+                                                  param.weight_quant_scale)) {
+      RunWeightOnly(context, M, w_dims1, w_dims0, input_data, output_data);
+      return;
+    }
     FCFunctor<lite::TargetType::kX86, T> fc;
     fc(context,
        M,
@@ -159,6 +175,50 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~FcCompute() = default;
+
+ private:
+  // The weight is kept in int8/int16/fp16/bf16 and dequantized tile by tile
+  // in GEMM.
+  void RunWeightOnly(const X86Context& context,
+                     const int M,
+                     const int N,
+                     const int K,
+                     const T* input_data,
+                     T* output_data) {
+    auto& param = *param_.get_mutable<param_t>();
+    auto* w = param.w;
+    const int ldw = w->dims()[1];
+    CHECK_GE(param.weight_quant_scale.size(), static_cast<size_t>(N));
+    void* workspace = this->workspace()->Alloc(WorkspaceSize());
+    lite::x86::math::weight_only_gemm(
+        context,
+        M,
+        N,
+        K,
+        input_data,
+        K,
+        *w,
+        lite::x86::math::get_weight_only_type(*w, param.weight_quant_type),
+        ldw,
+        param.weight_quant_scale.data(),
+        output_data,
+        N,
+        workspace);
+    if (!param.bias && param.activation_type != "relu") {
+      return;
+    }
+    const T* bias = param.bias ? param.bias->template data<T>() : nullptr;
+    bool with_relu = param.activation_type == "relu";
+    lite::x86::RunParallelFor(0, M, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        T* y = output_data + i * N;
+        for (int j = 0; j < N; j++) {
+          T v = bias ? y[j] + bias[j] : y[j];
+          y[j] = with_relu && v < 0 ? 0 : v;
+        }
+      }
+    });
+  }
 };
 
 }  // namespace x86
@@ -0,0 +1,56 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "lite/backends/x86/math/embedding.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+class FusedEmbeddingSeqPoolCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedEmbeddingSeqPoolParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto* ids_t = param.Ids;
+    auto* table_t = param.W;
+    auto& lod = ids_t->lod()[0];
+    int64_t seq_num = lod.size() - 1;
+    int64_t ids_per_pos = ids_t->numel() / ids_t->dims()[0];
+
+    lite::x86::math::embedding_seq_pool(table_t->data<float>(),
+                                        table_t->dims()[0],
+                                        table_t->dims()[1],
+                                        ids_t->data<int64_t>(),
+                                        ids_per_pos,
+                                        lod.data(),
+                                        seq_num,
+                                        param.padding_idx,
+                                        param.pool_type,
+                                        param.Out->mutable_data<float>());
+  }
+
+  virtual ~FusedEmbeddingSeqPoolCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
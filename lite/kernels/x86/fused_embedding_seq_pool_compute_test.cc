@@ -0,0 +1,131 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void embedding_seq_pool_ref(const lite::Tensor& w,
+                            const lite::Tensor& ids,
+                            int64_t padding_idx,
+                            const std::string& pool_type,
+                            lite::Tensor* out) {
+  auto& lod = ids.lod()[0];
+  int64_t emb_size = w.dims()[1];
+  int64_t ids_per_pos = ids.numel() / ids.dims()[0];
+  int64_t out_width = ids_per_pos * emb_size;
+  auto* w_data = w.data<float>();
+  auto* ids_data = ids.data<int64_t>();
+  auto* out_data = out->mutable_data<float>();
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    float* dst = out_data + s * out_width;
+    std::vector<float> rows;
+    for (uint64_t p = lod[s]; p < lod[s + 1]; p++) {
+      for (int64_t k = 0; k < ids_per_pos; k++) {
+        int64_t id = ids_data[p * ids_per_pos + k];
+        for (int64_t j = 0; j < emb_size; j++) {
+          rows.push_back(id == padding_idx ? 0.f : w_data[id * emb_size + j]);
+        }
+      }
+    }
+    int64_t len = lod[s + 1] - lod[s];
+    for (int64_t j = 0; j < out_width; j++) {
+      float v = 0.f;
+      if (len > 0 && pool_type == "FIRST") {
+        v = rows[j];
+      } else if (len > 0 && pool_type == "LAST") {
+        v = rows[(len - 1) * out_width + j];
+      } else {
+        for (int64_t p = 0; p < len; p++) {
+          v += rows[p * out_width + j];
+        }
+        if (len > 0 && pool_type == "AVERAGE") {
+          v /= len;
+        } else if (len > 0 && pool_type == "SQRT") {
+          v /= std::sqrt(static_cast<float>(len));
+        }
+      }
+      dst[j] = v;
+    }
+  }
+}
+
+TEST(fused_embedding_seq_pool_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("fused_embedding_seq_pool");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(fused_embedding_seq_pool_x86, compute) {
+  int vocab_size = 1000;
+  int emb_size = 37;
+  int64_t padding_idx = 5;
+  lite::Tensor w;
+  w.Resize({vocab_size, emb_size});
+  auto* w_data = w.mutable_data<float>();
+  for (int i = 0; i < vocab_size * emb_size; i++) {
+    w_data[i] = static_cast<float>(i % 113) / 113 - 0.5f;
+  }
+
+  for (int ids_per_pos : {1, 2}) {
+    for (std::string pool_type : {"SUM", "AVERAGE", "SQRT", "FIRST", "LAST"}) {
+      // The second sequence is empty.
+      LoD lod{{0, 4, 4, 11, 12}};
+      int pos_num = lod[0].back();
+      lite::Tensor ids, out, out_ref;
+      ids.Resize({pos_num, ids_per_pos});
+      ids.set_lod(lod);
+      auto* ids_data = ids.mutable_data<int64_t>();
+      for (int i = 0; i < pos_num * ids_per_pos; i++) {
+        ids_data[i] = (i * 131) % vocab_size;
+      }
+      ids_data[2] = padding_idx;
+      int seq_num = lod[0].size() - 1;
+      out.Resize({seq_num, ids_per_pos * emb_size});
+      out_ref.Resize({seq_num, ids_per_pos * emb_size});
+
+      FusedEmbeddingSeqPoolCompute kernel;
+      operators::FusedEmbeddingSeqPoolParam param;
+      param.W = &w;
+      param.Ids = &ids;
+      param.Out = &out;
+      param.padding_idx = padding_idx;
+      param.pool_type = pool_type;
+      kernel.SetParam(param);
+      kernel.Run();
+
+      embedding_seq_pool_ref(w, ids, padding_idx, pool_type, &out_ref);
+      auto* out_data = out.data<float>();
+      auto* out_ref_data = out_ref.data<float>();
+      for (int i = 0; i < out.numel(); i++) {
+        EXPECT_NEAR(out_data[i], out_ref_data[i], 1e-5) << pool_type;
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_embedding_seq_pool, kX86, kFloat, kNCHW, def);
@@ -14,6 +14,8 @@
 #pragma once
 
 #include <vector>
+#include "lite/backends/x86/math/embedding.h"
+#include "lite/backends/x86/math/weight_only_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/fluid/eigen.h"
@@ -28,6 +30,16 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::LookupTableParam;
 
+  size_t WorkspaceSize() override {
+    auto &param = *param_.get_mutable<operators::LookupTableParam>();
+    if (lite::x86::math::is_weight_only_quantized(*param.W,
+                                                  param.weight_quant_scale)) {
+      return 0;
+    }
+    return lite::x86::math::lookup_table_workspace_size(
+        param.W->dims()[0], param.W->dims()[1], param.Ids->numel());
+  }
+
   void Run() override {
     auto &param = *param_.get_mutable<operators::LookupTableParam>();
     auto *ids_t = param.Ids;
@@ -40,20 +52,40 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     int64_t row_number = table_t->dims()[0];
     int64_t row_width = table_t->dims()[1];
 
-    const T *table = table_t->template data<T>();
     T *output = output_t->template mutable_data<T>();
-    memset(output, 0, output_t->dims().production() * sizeof(T));
-    for (int64_t i = 0; i < ids_numel; ++i) {
-      if (padding_idx != -1 && ids[i] == padding_idx) {
-        memset(output + i * row_width, 0, row_width * sizeof(T));
-      } else {
-        CHECK_LT(ids[i], row_number);
-        CHECK_GE(ids[i], 0);
-        memcpy(output + i * row_width,
-               table + ids[i] * row_width,
-               row_width * sizeof(T));
-      }
+    if (lite::x86::math::is_weight_only_quantized(*table_t,
+                                                  param.weight_quant_scale)) {
+      // The table quantized by post_quant_dynamic_pass is kept in
+      // int8/int16/fp16/bf16, only the rows looked up are dequantized.
+      CHECK_EQ(param.weight_quant_scale.size(),
+               static_cast<size_t>(row_width));
+      lite::x86::math::weight_only_lookup_table(
+          *table_t,
+          lite::x86::math::get_weight_only_type(*table_t,
+                                                param.weight_quant_type),
+          param.weight_quant_scale.data(),
+          row_number,
+          row_width,
+          ids,
+          ids_numel,
+          padding_idx,
+          output);
+      return;
     }
+    const T *table = table_t->template data<T>();
+    // The ids are sorted in the workspace for the large tables.
+    size_t workspace_size = WorkspaceSize();
+    void *workspace = workspace_size > 0
+                          ? this->workspace()->Alloc(workspace_size)
+                          : nullptr;
+    lite::x86::math::lookup_table(table,
+                                  row_number,
+                                  row_width,
+                                  ids,
+                                  ids_numel,
+                                  padding_idx,
+                                  output,
+                                  workspace);
   }
 
   virtual ~LookupTableCompute() = default;
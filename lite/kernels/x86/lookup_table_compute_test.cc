@@ -74,6 +74,48 @@ TEST(lookup_table_x86, compute) {
   }
 }
 
+TEST(lookup_table_x86, compute_large_table) {
+  LookupTableCompute<float> lookup_table;
+  operators::LookupTableParam param;
+  lite::Tensor w, ids, out;
+  int64_t padding_idx = 7;
+
+  // The table is large enough to sort and deduplicate the ids.
+  int vocab_size = 40000;
+  int emb_size = 64;
+  int ids_num = 500;
+
+  w.Resize({vocab_size, emb_size});
+  ids.Resize({ids_num, 1});
+  out.Resize({ids_num, emb_size});
+  auto* w_data = w.mutable_data<float>();
+  auto* ids_data = ids.mutable_data<int64_t>();
+  auto* out_data = out.mutable_data<float>();
+  for (int i = 0; i < vocab_size * emb_size; i++) {
+    w_data[i] = static_cast<float>(i % 997) / 997;
+  }
+  for (int i = 0; i < ids_num; i++) {
+    ids_data[i] = (i * 7919) % 300 * 131;
+  }
+  ids_data[3] = padding_idx;
+
+  param.W = &w;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = padding_idx;
+  lookup_table.SetParam(param);
+  ASSERT_GT(lookup_table.WorkspaceSize(), 0u);
+  lookup_table.Run();
+  for (int i = 0; i < ids_num; i++) {
+    for (int j = 0; j < emb_size; j++) {
+      float ref = ids_data[i] == padding_idx
+                      ? 0.f
+                      : w_data[ids_data[i] * emb_size + j];
+      EXPECT_NEAR(out_data[i * emb_size + j], ref, 1e-5);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
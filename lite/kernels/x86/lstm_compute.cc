@@ -0,0 +1,111 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/lstm_compute.h"
+#include <cstring>
+#include "lite/backends/x86/math/fused_rnn.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+lite::x86::math::detail::ActivationType ToActivationType(
+    lite_api::ActivationType act) {
+  switch (act) {
+    case lite_api::ActivationType::kSigmoid:
+      return lite::x86::math::detail::ActivationType::kSigmoid;
+    case lite_api::ActivationType::kRelu:
+      return lite::x86::math::detail::ActivationType::kReLU;
+    case lite_api::ActivationType::kTanh:
+      return lite::x86::math::detail::ActivationType::kTanh;
+    case lite_api::ActivationType::kIndentity:
+      return lite::x86::math::detail::ActivationType::kIdentity;
+    default:
+      LOG(FATAL) << "Unsupported activation type of lstm: "
+                 << static_cast<int>(act);
+  }
+  return lite::x86::math::detail::ActivationType::kIdentity;
+}
+}  // namespace
+
+void LstmCompute::Run() {
+  auto& param = this->Param<operators::LstmParam>();
+  auto* input = param.Input;
+  auto* bias = param.Bias;
+  auto* batch_gate = param.BatchGate;
+  int frame_size = param.Hidden->dims()[1];
+  int64_t num_rows = input->dims()[0];
+  int64_t gate_width = 4 * frame_size;
+
+  // The sequences are computed in place, so the gates and the cell
+  // pre-activations are in the order of the input sequences.
+  const float* input_data = input->data<float>();
+  float* gate_data = batch_gate->mutable_data<float>();
+  const float* check = nullptr;
+  if (bias) {
+    const float* bias_data = bias->data<float>();
+    for (int64_t i = 0; i < num_rows; i++) {
+      for (int64_t j = 0; j < gate_width; j++) {
+        gate_data[i * gate_width + j] =
+            input_data[i * gate_width + j] + bias_data[j];
+      }
+    }
+    if (param.use_peepholes) {
+      check = bias_data + gate_width;
+    }
+  } else {
+    std::memcpy(gate_data, input_data, num_rows * gate_width * sizeof(float));
+  }
+  batch_gate->set_lod(input->lod());
+  param.BatchCellPreAct->set_lod(input->lod());
+
+  lite::x86::math::FusedLSTM(input->lod()[0],
+                             param.H0 ? param.H0->data<float>() : nullptr,
+                             param.C0 ? param.C0->data<float>() : nullptr,
+                             param.Weight->data<float>(),
+                             check,
+                             frame_size,
+                             param.is_reverse,
+                             ToActivationType(param.gate_activation),
+                             ToActivationType(param.cell_activation),
+                             ToActivationType(param.candidate_activation),
+                             gate_data,
+                             param.BatchCellPreAct->mutable_data<float>(),
+                             param.Hidden->mutable_data<float>(),
+                             param.Cell->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(lstm,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::LstmCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Weight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("C0", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("H0", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Hidden", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Cell", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("BatchGate", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("BatchCellPreAct", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,153 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/lstm_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+float Sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+// The step by step reference of the lstm with the peepholes, the gates are
+// in the order of the candidate, input, forget and output gates.
+void LstmRef(const std::vector<uint64_t>& lod,
+             const float* input,
+             const float* weight,
+             const float* bias,
+             const float* h0,
+             const float* c0,
+             int d,
+             bool is_reverse,
+             float* hidden,
+             float* cell) {
+  const float* check = bias + 4 * d;
+  std::vector<float> gate(4 * d);
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    int begin = lod[s];
+    int len = lod[s + 1] - lod[s];
+    const float* h_prev = h0 + s * d;
+    const float* c_prev = c0 + s * d;
+    for (int t = 0; t < len; t++) {
+      int row = begin + (is_reverse ? len - 1 - t : t);
+      for (int j = 0; j < 4 * d; j++) {
+        float sum = input[row * 4 * d + j] + bias[j];
+        for (int k = 0; k < d; k++) {
+          sum += h_prev[k] * weight[k * 4 * d + j];
+        }
+        gate[j] = sum;
+      }
+      for (int j = 0; j < d; j++) {
+        float cand = std::tanh(gate[j]);
+        float ig = Sigmoid(gate[d + j] + c_prev[j] * check[j]);
+        float fg = Sigmoid(gate[2 * d + j] + c_prev[j] * check[d + j]);
+        float c = cand * ig + c_prev[j] * fg;
+        float og = Sigmoid(gate[3 * d + j] + c * check[2 * d + j]);
+        cell[row * d + j] = c;
+        hidden[row * d + j] = og * std::tanh(c);
+      }
+      h_prev = hidden + row * d;
+      c_prev = cell + row * d;
+    }
+  }
+}
+}  // namespace
+
+TEST(lstm_x86, retrive_op) {
+  auto lstm = KernelRegistry::Global().Create("lstm");
+  ASSERT_FALSE(lstm.empty());
+  ASSERT_TRUE(lstm.front());
+}
+
+TEST(lstm_x86, run_test) {
+  const int d = 13;
+  const std::vector<uint64_t> lod{0, 3, 10, 11, 19};
+  const int num_rows = lod.back();
+  const int num_seqs = lod.size() - 1;
+  for (bool is_reverse : {false, true}) {
+    lite::Tensor input, weight, bias, h0, c0;
+    lite::Tensor hidden, cell, batch_gate, batch_cell_pre_act;
+    input.Resize({num_rows, 4 * d});
+    input.set_lod({lod});
+    weight.Resize({d, 4 * d});
+    bias.Resize({1, 7 * d});
+    h0.Resize({num_seqs, d});
+    c0.Resize({num_seqs, d});
+    hidden.Resize({num_rows, d});
+    cell.Resize({num_rows, d});
+    batch_gate.Resize({num_rows, 4 * d});
+    batch_cell_pre_act.Resize({num_rows, d});
+    for (auto* t : {&input, &weight, &bias, &h0, &c0}) {
+      auto* data = t->mutable_data<float>();
+      for (int64_t i = 0; i < t->numel(); i++) {
+        data[i] = std::sin(0.37f * i + t->numel()) * 0.5f;
+      }
+    }
+
+    LstmCompute lstm;
+    operators::LstmParam param;
+    param.Input = &input;
+    param.Weight = &weight;
+    param.Bias = &bias;
+    param.H0 = &h0;
+    param.C0 = &c0;
+    param.Hidden = &hidden;
+    param.Cell = &cell;
+    param.BatchGate = &batch_gate;
+    param.BatchCellPreAct = &batch_cell_pre_act;
+    param.use_peepholes = true;
+    param.is_reverse = is_reverse;
+    param.gate_activation = lite_api::ActivationType::kSigmoid;
+    param.cell_activation = lite_api::ActivationType::kTanh;
+    param.candidate_activation = lite_api::ActivationType::kTanh;
+
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    lstm.SetContext(std::move(ctx));
+    lstm.SetParam(param);
+    lstm.Run();
+
+    std::vector<float> hidden_ref(num_rows * d);
+    std::vector<float> cell_ref(num_rows * d);
+    LstmRef(lod,
+            input.data<float>(),
+            weight.data<float>(),
+            bias.data<float>(),
+            h0.data<float>(),
+            c0.data<float>(),
+            d,
+            is_reverse,
+            hidden_ref.data(),
+            cell_ref.data());
+    for (int i = 0; i < num_rows * d; i++) {
+      EXPECT_NEAR(hidden.data<float>()[i], hidden_ref[i], 1e-5);
+      EXPECT_NEAR(cell.data<float>()[i], cell_ref[i], 1e-5);
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(lstm, kX86, kFloat, kNCHW, def);
@@ -14,6 +14,7 @@
 #pragma once
 
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/weight_only_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -39,6 +40,17 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MulParam;
 
+  size_t WorkspaceSize() override {
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    if (!lite::x86::math::is_weight_only_quantized(*param.y,
+                                                   param.weight_quant_scale)) {
+      return 0;
+    }
+    auto y_dims = param.y->dims().Flatten2D(param.y_num_col_dims);
+    return lite::x86::math::weight_only_gemm_workspace_size(y_dims[0],
+                                                            y_dims[1]);
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::MulParam>();
@@ -70,9 +82,34 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       z->Resize({x_matrix.dims()[0], y_matrix.dims()[1]});
     }
 
-    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
-
-    blas.MatMul(x_matrix, y_matrix, z);
+    if (lite::x86::math::is_weight_only_quantized(*y,
+                                                  param.weight_quant_scale)) {
+      // The weight is kept in int8/int16/fp16/bf16 and dequantized tile by
+      // tile.
+      const int M = x_matrix.dims()[0];
+      const int K = x_matrix.dims()[1];
+      const int N = y_matrix.dims()[1];
+      CHECK_EQ(param.weight_quant_scale.size(), static_cast<size_t>(N));
+      void* workspace = this->workspace()->Alloc(WorkspaceSize());
+      lite::x86::math::weight_only_gemm(
+          context,
+          M,
+          N,
+          K,
+          x_matrix.data<float>(),
+          K,
+          *y,
+          lite::x86::math::get_weight_only_type(*y, param.weight_quant_type),
+          N,
+          param.weight_quant_scale.data(),
+          z->template mutable_data<float>(),
+          N,
+          workspace);
+    } else {
+      auto blas =
+          lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+      blas.MatMul(x_matrix, y_matrix, z);
+    }
     if (z_dim.size() != 2) {
       z->Resize(z_dim);
     }
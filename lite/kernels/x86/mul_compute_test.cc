@@ -14,13 +14,17 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/mul_compute.h"
+#include "lite/utils/bfloat16.h"
+#include "lite/utils/float16.h"
 
 namespace paddle {
 namespace lite {
@@ -80,6 +84,71 @@ TEST(mul_x86, run_test) {
   }
 }
 
+template <typename QuantType>
+void TestMulWeightOnly(int m,
+                       int k,
+                       int n,
+                       PrecisionType precision,
+                       const std::string& quant_type) {
+  lite::Tensor x, y, out;
+  x.Resize({m, k});
+  y.Resize({k, n});
+  out.Resize({m, n});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  std::vector<float> scale(n);
+  for (int j = 0; j < n; j++) {
+    scale[j] = 0.01f * (j % 5 + 1);
+  }
+  auto* y_data = y.mutable_data<QuantType>();
+  for (int64_t i = 0; i < y.numel(); i++) {
+    y_data[i] = QuantType(static_cast<float>(i % 255 - 127));
+  }
+  y.set_precision(precision);
+
+  MulCompute<float> mul;
+  operators::MulParam param;
+  param.x = &x;
+  param.y = &y;
+  param.output = &out;
+  param.weight_quant_scale = scale;
+  param.weight_quant_type = quant_type;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  mul.SetContext(std::move(ctx));
+  mul.SetParam(param);
+  mul.Run();
+
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      float ref = 0.f;
+      for (int l = 0; l < k; l++) {
+        ref += x_data[i * k + l] * static_cast<float>(y_data[l * n + j]) *
+               scale[j];
+      }
+      EXPECT_NEAR(out_data[i * n + j], ref, 1e-3 * (1.f + std::fabs(ref)));
+    }
+  }
+}
+
+TEST(mul_x86, run_weight_only) {
+  // The few rows stream the weight, the others multiply dequantized tiles.
+  for (int m : {1, 3, 17}) {
+    TestMulWeightOnly<int8_t>(
+        m, 300, 270, PRECISION(kInt8), "post_weight_channel_wise_abs_max");
+    TestMulWeightOnly<int16_t>(
+        m, 300, 270, PRECISION(kInt16), "post_weight_channel_wise_abs_max");
+    TestMulWeightOnly<float16>(
+        m, 300, 270, PRECISION(kFP16), "post_weight_fp16");
+    // The bf16 weight is held by the int16 tensor.
+    TestMulWeightOnly<bfloat16>(
+        m, 300, 270, PRECISION(kInt16), "post_weight_bf16");
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,123 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include "lite/backends/x86/math/sparse_gemm.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The weight of the param in the block sparse format.
+template <typename Param>
+lite::x86::math::BlockSparseMatrix GetBlockSparseMatrix(const Param& param) {
+  lite::x86::math::BlockSparseMatrix matrix;
+  matrix.rows = param.sparse_shape[0];
+  matrix.cols = param.sparse_shape[1];
+  matrix.block_rows = param.block_shape[0];
+  matrix.block_cols = param.block_shape[1];
+  matrix.values = param.sparse_values->template data<float>();
+  matrix.col_index = param.sparse_col_index->template data<int32_t>();
+  matrix.row_offset = param.sparse_row_offset->template data<int32_t>();
+  return matrix;
+}
+
+inline lite_api::ActivationType GetSparseActivation(
+    const std::string& activation_type) {
+  if (activation_type == "relu") {
+    return lite_api::ActivationType::kRelu;
+  } else if (activation_type == "relu6") {
+    return lite_api::ActivationType::kRelu6;
+  }
+  CHECK(activation_type.empty()) << "Unsupported activation "
+                                 << activation_type;
+  return lite_api::ActivationType::kIndentity;
+}
+
+// Out = act(Input * W + Bias), W is held by its transpose in the block sparse
+// format.
+class SparseFcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::SparseFcParam;
+
+  size_t WorkspaceSize() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto in_mat_dims = param.input->dims().Flatten2D(param.in_num_col_dims);
+    return lite::x86::math::block_sparse_gemm_trans_workspace_size(
+        in_mat_dims[0], in_mat_dims[1]);
+  }
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    const int M = param.input->dims().count(0, param.in_num_col_dims);
+    size_t workspace_size = WorkspaceSize();
+    void* workspace =
+        workspace_size ? this->workspace()->Alloc(workspace_size) : nullptr;
+    lite::x86::math::block_sparse_gemm_trans(
+        M,
+        param.input->data<float>(),
+        GetBlockSparseMatrix(param),
+        param.bias ? param.bias->data<float>() : nullptr,
+        GetSparseActivation(param.activation_type),
+        param.output->mutable_data<float>(),
+        workspace);
+  }
+
+  virtual ~SparseFcCompute() = default;
+};
+
+// The 1x1 conv2d in NCHW, Output[n] = act(Filter * Input[n] + Bias), the
+// filter of output channels x input channels is in the block sparse format.
+class SparseConvCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::SparseConvParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    const auto& in_dims = param.input->dims();
+    const int batch_size = static_cast<int>(in_dims[0]);
+    const int spatial = static_cast<int>(in_dims[2] * in_dims[3]);
+    const int64_t in_size = in_dims[1] * spatial;
+    const int64_t out_size =
+        static_cast<int64_t>(param.sparse_shape[0]) * spatial;
+    auto matrix = GetBlockSparseMatrix(param);
+    auto act = GetSparseActivation(param.activation_type);
+    const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+    const float* input = param.input->data<float>();
+    float* output = param.output->mutable_data<float>();
+    for (int n = 0; n < batch_size; n++) {
+      lite::x86::math::block_sparse_gemm(matrix,
+                                         spatial,
+                                         input + n * in_size,
+                                         spatial,
+                                         bias,
+                                         act,
+                                         output + n * out_size,
+                                         spatial);
+    }
+  }
+
+  virtual ~SparseConvCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,230 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/core/mir/sparse_weight_convert_pass.h"
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/sparse_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The rows x cols matrix with about 80% of the zero blocks.
+std::vector<float> GenPrunedWeight(int rows,
+                                   int cols,
+                                   int block_rows,
+                                   int block_cols) {
+  std::vector<float> dense(rows * cols, 0.f);
+  for (int i = 0; i < rows; i += block_rows) {
+    for (int j = 0; j < cols; j += block_cols) {
+      if ((i * 7 + j * 13) % 5 != 0) continue;
+      for (int r = 0; r < block_rows; r++) {
+        for (int c = 0; c < block_cols; c++) {
+          dense[(i + r) * cols + j + c] =
+              static_cast<float>((i + r + j + c) % 11) * 0.1f - 0.5f;
+        }
+      }
+    }
+  }
+  return dense;
+}
+
+// Convert the rows x cols matrix by sparse_weight_convert_pass to the tensors
+// of the sparse kernels.
+void ToSparseTensors(const std::vector<float>& dense,
+                     int rows,
+                     int cols,
+                     int block_rows,
+                     int block_cols,
+                     Tensor* values,
+                     Tensor* col_index,
+                     Tensor* row_offset) {
+  float sparsity = 0.f;
+  // The generated weight is pruned enough to be converted by the pass.
+  EXPECT_FALSE(mir::SparseWeightConvertPass::PickBlockShape(
+                   dense.data(), rows, cols, 0.7f, &sparsity)
+                   .empty());
+  std::vector<float> values_data;
+  std::vector<int32_t> col_index_data;
+  std::vector<int32_t> row_offset_data;
+  mir::SparseWeightConvertPass::ToBlockSparse(dense.data(),
+                                              rows,
+                                              cols,
+                                              block_rows,
+                                              block_cols,
+                                              &values_data,
+                                              &col_index_data,
+                                              &row_offset_data);
+  values->Resize({static_cast<int64_t>(values_data.size())});
+  std::copy(values_data.begin(),
+            values_data.end(),
+            values->mutable_data<float>());
+  col_index->Resize({static_cast<int64_t>(col_index_data.size())});
+  std::copy(col_index_data.begin(),
+            col_index_data.end(),
+            col_index->mutable_data<int32_t>());
+  row_offset->Resize({static_cast<int64_t>(row_offset_data.size())});
+  std::copy(row_offset_data.begin(),
+            row_offset_data.end(),
+            row_offset->mutable_data<int32_t>());
+}
+
+TEST(sparse_fc_x86, retrive_op) {
+  auto sparse_fc = KernelRegistry::Global().Create("sparse_fc");
+  ASSERT_FALSE(sparse_fc.empty());
+  ASSERT_TRUE(sparse_fc.front());
+  auto sparse_conv = KernelRegistry::Global().Create("sparse_conv2d");
+  ASSERT_FALSE(sparse_conv.empty());
+  ASSERT_TRUE(sparse_conv.front());
+}
+
+void TestSparseFc(int m, int k, int n, int block_rows, int block_cols) {
+  // The weight of the fc is held by its transpose, i.e. n x k.
+  auto dense = GenPrunedWeight(n, k, block_rows, block_cols);
+  lite::Tensor x, values, col_index, row_offset, bias, out;
+  ToSparseTensors(
+      dense, n, k, block_rows, block_cols, &values, &col_index, &row_offset);
+  x.Resize({m, k});
+  bias.Resize({n});
+  out.Resize({m, n});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  auto* bias_data = bias.mutable_data<float>();
+  for (int j = 0; j < n; j++) {
+    bias_data[j] = 0.1f * (j % 3) - 0.1f;
+  }
+
+  SparseFcCompute sparse_fc;
+  operators::SparseFcParam param;
+  param.input = &x;
+  param.bias = &bias;
+  param.output = &out;
+  param.in_num_col_dims = 1;
+  param.activation_type = "relu";
+  param.sparse_values = &values;
+  param.sparse_col_index = &col_index;
+  param.sparse_row_offset = &row_offset;
+  param.sparse_shape = {n, k};
+  param.block_shape = {block_rows, block_cols};
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  sparse_fc.SetContext(std::move(ctx));
+  sparse_fc.SetParam(param);
+  sparse_fc.Run();
+
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      float ref = bias_data[j];
+      for (int l = 0; l < k; l++) {
+        ref += x_data[i * k + l] * dense[j * k + l];
+      }
+      ref = std::max(ref, 0.f);
+      EXPECT_NEAR(out_data[i * n + j], ref, 1e-4 * (1.f + std::fabs(ref)));
+    }
+  }
+}
+
+TEST(sparse_fc_x86, run_test) {
+  // The few rows are multiplied in place, the others are transposed first.
+  for (int m : {1, 3, 17}) {
+    TestSparseFc(m, 64, 40, 1, 1);
+    TestSparseFc(m, 64, 40, 1, 4);
+    TestSparseFc(m, 64, 40, 4, 1);
+    TestSparseFc(m, 64, 40, 4, 4);
+  }
+}
+
+void TestSparseConv(
+    int batch, int ic, int oc, int hw, int block_rows, int block_cols) {
+  auto dense = GenPrunedWeight(oc, ic, block_rows, block_cols);
+  lite::Tensor x, values, col_index, row_offset, bias, out;
+  ToSparseTensors(
+      dense, oc, ic, block_rows, block_cols, &values, &col_index, &row_offset);
+  x.Resize({batch, ic, hw, hw});
+  bias.Resize({oc});
+  out.Resize({batch, oc, hw, hw});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 13) * 0.5f - 3.f;
+  }
+  auto* bias_data = bias.mutable_data<float>();
+  for (int j = 0; j < oc; j++) {
+    bias_data[j] = 0.2f * (j % 4);
+  }
+
+  SparseConvCompute sparse_conv;
+  operators::SparseConvParam param;
+  param.input = &x;
+  param.bias = &bias;
+  param.output = &out;
+  param.activation_type = "relu6";
+  param.sparse_values = &values;
+  param.sparse_col_index = &col_index;
+  param.sparse_row_offset = &row_offset;
+  param.sparse_shape = {oc, ic};
+  param.block_shape = {block_rows, block_cols};
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  sparse_conv.SetContext(std::move(ctx));
+  sparse_conv.SetParam(param);
+  sparse_conv.Run();
+
+  const int spatial = hw * hw;
+  auto* out_data = out.data<float>();
+  for (int b = 0; b < batch; b++) {
+    for (int o = 0; o < oc; o++) {
+      for (int s = 0; s < spatial; s++) {
+        float ref = bias_data[o];
+        for (int c = 0; c < ic; c++) {
+          ref += dense[o * ic + c] * x_data[(b * ic + c) * spatial + s];
+        }
+        ref = std::min(std::max(ref, 0.f), 6.f);
+        EXPECT_NEAR(out_data[(b * oc + o) * spatial + s],
+                    ref,
+                    1e-4 * (1.f + std::fabs(ref)));
+      }
+    }
+  }
+}
+
+TEST(sparse_conv2d_x86, run_test) {
+  // 5x5 and 7x7 leave the tails of the vectors.
+  for (int hw : {5, 7, 8}) {
+    TestSparseConv(2, 32, 24, hw, 1, 1);
+    TestSparseConv(2, 32, 24, hw, 1, 4);
+    TestSparseConv(2, 32, 24, hw, 4, 1);
+    TestSparseConv(2, 32, 24, hw, 4, 4);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(sparse_fc, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(sparse_conv2d, kX86, kFloat, kNCHW, def);
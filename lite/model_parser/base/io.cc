@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "lite/model_parser/base/io.h"
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace paddle {
 namespace lite {
@@ -41,7 +44,8 @@ std::string ByteReader::ReadToString(size_t size) const {
   return tmp;
 }
 
-BinaryFileReader::BinaryFileReader(const std::string& path, size_t offset) {
+BinaryFileReader::BinaryFileReader(const std::string& path, size_t offset)
+    : path_(path), offset_(offset) {
   file_ = fopen(path.c_str(), "rb");
   CHECK(file_) << "Unable to open file: " << path;
   fseek(file_, 0L, SEEK_END);
@@ -56,6 +60,30 @@ void BinaryFileReader::Read(void* dst, size_t size) const {
   cur_ += size;
 }
 
+void BinaryFileReader::ReadAt(size_t pos, void* dst, size_t size) const {
+  CHECK(dst);
+  CHECK_LE(pos + size, length_) << "Failed to read " << size
+                                << " bytes at the position " << pos << ".";
+#ifdef _WIN32
+  // There is no pread, so the file position is restored after reading.
+  std::lock_guard<std::mutex> lock(mutex_);
+  fseek(file_, offset_ + pos, SEEK_SET);
+  size_t read_size = fread(dst, 1, size, file_);
+  fseek(file_, offset_ + cur_, SEEK_SET);
+  CHECK_EQ(read_size, size) << "Failed to read " << size << " bytes.";
+#else
+  char* ptr = static_cast<char*>(dst);
+  size_t read_size = 0;
+  while (read_size < size) {
+    ssize_t ret = pread(
+        fileno(file_), ptr + read_size, size - read_size, offset_ + pos);
+    CHECK_GT(ret, 0) << "Failed to read " << size << " bytes.";
+    read_size += ret;
+    pos += ret;
+  }
+#endif
+}
+
 void BinaryFileWriter::Write(const void* src, size_t size) const {
   CHECK(src);
   CHECK_EQ(fwrite(src, 1, size, file_), size) << "Failed to read " << size
@@ -69,6 +97,13 @@ void StringBufferReader::Read(void* dst, size_t size) const {
   cur_ += size;
 }
 
+void StringBufferReader::ReadAt(size_t pos, void* dst, size_t size) const {
+  CHECK(dst);
+  CHECK_LE(pos + size, length_) << "Failed to read " << size
+                                << " bytes at the position " << pos << ".";
+  lite::TargetCopy(TargetType::kHost, dst, buf_ + pos, size);
+}
+
 }  // namespace model_parser
 }  // namespace lite
 }  // namespace paddle
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <utility>
 #include "lite/core/memory.h"
@@ -79,6 +80,9 @@ class ByteReader {
  public:
   ByteReader() = default;
   virtual void Read(void* dst, size_t size) const = 0;
+  // Read the bytes at the position `pos` without moving the current position,
+  // it's safe to be called by multiple threads concurrently.
+  virtual void ReadAt(size_t pos, void* dst, size_t size) const = 0;
   virtual std::string ReadToString(size_t size) const;
   virtual size_t length() const = 0;
   virtual size_t current() const = 0;
@@ -135,21 +139,35 @@ class BinaryFileReader : public ByteReader {
     }
   }
   void Read(void* dst, size_t size) const override;
+  void ReadAt(size_t pos, void* dst, size_t size) const override;
   bool ReachEnd() const override { return cur_ >= length_; }
   size_t length() const override { return length_; }
   size_t current() const override { return cur_; }
+  const std::string& path() const { return path_; }
+  size_t offset() const { return offset_; }
 
  private:
   FILE* file_{};
+  std::string path_;
+  size_t offset_{0};
   size_t length_{0};
   mutable size_t cur_{0};
+#ifdef _WIN32
+  mutable std::mutex mutex_;
+#endif
 };
 
 class BinaryFileWriter : public ByteWriter {
  public:
-  explicit BinaryFileWriter(const std::string& path) {
-    file_ = fopen(path.c_str(), "wb");
+  // Append to the end of the file if `append` is true, the written bytes are
+  // aligned relative to the beginning of the file.
+  explicit BinaryFileWriter(const std::string& path, bool append = false) {
+    file_ = fopen(path.c_str(), append ? "ab" : "wb");
     CHECK(file_) << "Unable to open file: " << path;
+    if (append) {
+      fseek(file_, 0L, SEEK_END);
+      cur_ = ftell(file_);
+    }
   }
   ~BinaryFileWriter() {
     if (file_) {
@@ -187,6 +205,7 @@ class StringBufferReader : public ByteReader {
   }
   ~StringBufferReader() = default;
   void Read(void* dst, size_t size) const override;
+  void ReadAt(size_t pos, void* dst, size_t size) const override;
   bool ReachEnd() const override { return cur_ >= length_; }
   size_t length() const override { return length_; }
   size_t current() const override { return cur_; }
@@ -13,17 +13,39 @@
 // limitations under the License.
 
 #include "lite/model_parser/flatbuffers/io.h"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
+#include "lite/core/thread_pool.h"
 #include "lite/model_parser/base/io.h"
 #include "lite/model_parser/flatbuffers/traits.h"
 
 namespace paddle {
 namespace lite {
 namespace fbs {
+namespace {
+// Read the ParamDesc of the record at the position of the reader into the
+// buffer.
+void ReadParamRecord(const model_parser::ByteReader& reader,
+                     size_t position,
+                     model_parser::Buffer* buf) {
+  uint32_t header[2];
+  reader.ReadAt(position, header, sizeof(header));
+  const uint32_t total_size = header[0];
+  const uint32_t offset = header[1];
+  CHECK(offset >= sizeof(offset) && total_size >= offset)
+      << "File format error: The header of param record is invalid.";
+  const uint32_t param_bytes = total_size - offset;
+  buf->ResetLazy(param_bytes);
+  reader.ReadAt(
+      position + sizeof(total_size) + offset, buf->data(), param_bytes);
+}
+}  // namespace
+
 namespace deprecated {
 void SetCombinedParamsWithScope(const lite::Scope& scope,
                                 const std::set<std::string>& param_names,
@@ -87,35 +109,92 @@ void ParamSerializer::ForwardWrite(const lite::Scope& scope,
   CHECK_LT(max_tensor_size, (std::numeric_limits<uint32_t>::max)())
       << "The size of param is out of range.";
 
-  writer_->Write<uint16_t>(header_size);
-  writer_->Write<uint16_t>(params_size);
-  writer_->Write<uint32_t>(max_tensor_size);
+  Write<uint16_t>(header_size);
+  Write<uint16_t>(params_size);
+  Write<uint32_t>(max_tensor_size);
 
+  // Reserve the largest param with the room of its name and dims up front,
+  // the memory is reused by the following params without reallocating.
+  constexpr size_t kParamMetaSize = 1024;
+  fbb_.reset(new flatbuffers::FlatBufferBuilder(max_tensor_size +
+                                                kParamMetaSize));
   for (const auto& name : param_names) {
-    fbs::ParamDesc param;
     auto& tensor = scope.FindVar(name)->Get<lite::Tensor>();
-    FillParam(name, tensor, &param);
-    param.CopyDataToBuffer(buf_.get());
-
-    const size_t param_bytes = buf_->size();
-    CHECK(param_bytes) << "The bytes size of param can not be zero";
-    constexpr uint32_t offset = sizeof(uint32_t);
-    const uint32_t total_size = param_bytes + offset;
-    writer_->Write<uint32_t>(total_size);
-    writer_->Write<uint32_t>(offset);
-    writer_->Write(buf_->data(), param_bytes);
+    WriteParam(name, tensor);
+  }
+  fbb_.reset();
+  WriteIndex();
+}
+
+void ParamSerializer::WriteParam(const std::string& name,
+                                 const lite::Tensor& tensor) {
+  CHECK(fbb_);
+  fbb_->Clear();
+  // The same layout as proto::ParamDesc::Pack of the ParamDesc filled by
+  // FillParam.
+  auto name_offset = fbb_->CreateString(name);
+  auto lod_offset = fbb_->CreateVector(std::vector<int64_t>());
+  auto dim_offset = fbb_->CreateVector(tensor.dims().Vectorize());
+  int8_t* data = nullptr;
+  const size_t byte_size = tensor.memory_size();
+  auto data_offset = fbb_->CreateUninitializedVector(byte_size, &data);
+  if (byte_size) {
+    model_parser::memcpy(data, tensor.raw_data(), byte_size);
   }
+  auto tensor_offset = proto::ParamDesc_::CreateLoDTensorDesc(
+      *fbb_,
+      0,
+      lod_offset,
+      dim_offset,
+      ConvertVarType(lite::ConvertPrecisionType(tensor.precision())),
+      data_offset);
+  auto param_offset = proto::CreateParamDesc(
+      *fbb_,
+      0,
+      name_offset,
+      proto::ParamDesc_::VariableDesc_LoDTensorDesc,
+      tensor_offset.Union());
+  fbb_->Finish(param_offset);
+
+  const size_t param_bytes = fbb_->GetSize();
+  CHECK(param_bytes) << "The bytes size of param can not be zero";
+  constexpr uint32_t offset = sizeof(uint32_t);
+  const uint32_t total_size = param_bytes + offset;
+  ParamRecord record;
+  record.name = name;
+  record.position = position_;
+  record.total_size = total_size;
+  records_.push_back(std::move(record));
+  Write<uint32_t>(total_size);
+  Write<uint32_t>(offset);
+  Write(fbb_->GetBufferPointer(), param_bytes);
+}
+
+void ParamSerializer::WriteIndex() {
+  const uint64_t index_position = position_;
+  for (const auto& record : records_) {
+    CHECK_LE(record.name.size(), (std::numeric_limits<uint16_t>::max)())
+        << "The name of param is too long: " << record.name;
+    Write<uint16_t>(record.name.size());
+    Write(record.name.data(), record.name.size());
+    Write<uint64_t>(record.position);
+    Write<uint32_t>(record.total_size);
+  }
+  Write<uint64_t>(index_position);
+  records_.clear();
 }
 
 void ParamSerializer::WriteHeader() {
   // 1. version id
-  writer_->Write<uint16_t>(version_);
-  // 2. size of meta information (reserved)
-  writer_->Write<uint16_t>(0U);
+  Write<uint16_t>(version_);
+  // 2. size of meta information
+  Write<uint16_t>(sizeof(uint32_t));
+  // 3. meta information: the flags
+  Write<uint32_t>(kParamsIndexed);
 }
 #endif
 
-void ParamDeserializer::ForwardRead(lite::Scope* scope) {
+void ParamDeserializer::ForwardRead(lite::Scope* scope, int threads) {
   CHECK(scope) << "The pointer of scope is nullptr";
   uint16_t header_size = reader_->Read<uint16_t>();
   ReadBytesToBuffer(header_size);
@@ -124,6 +203,37 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
   uint32_t max_tensor_size =
       *reinterpret_cast<uint32_t const*>(data + sizeof(uint16_t));
 
+  if (threads > 1 && params_size > 1) {
+    std::vector<ParamRecord> records = (flags_ & kParamsIndexed)
+                                           ? ReadIndex()
+                                           : ScanRecords(params_size);
+    CHECK_EQ(records.size(), params_size)
+        << "File format error: The index of params is inconsistent.";
+    // The records are taken by the workers one by one, each worker reads them
+    // into its own buffer.
+    std::atomic<size_t> next{0};
+    std::mutex scope_mutex;
+    auto decode = [&]() {
+      model_parser::Buffer buf;
+      for (size_t i = next++; i < records.size(); i = next++) {
+        ReadParamRecord(*reader_, base_ + records[i].position, &buf);
+        fbs::ParamDescView param(&buf);
+        lite::Tensor* tensor = nullptr;
+        {
+          std::lock_guard<std::mutex> lock(scope_mutex);
+          tensor = scope->Var(param.Name())->GetMutable<lite::Tensor>();
+        }
+        FillTensor(tensor, param);
+      }
+    };
+    ThreadPool pool(std::min<int>(threads, params_size));
+    for (int i = 0; i < pool.num_threads(); ++i) {
+      pool.Enqueue(decode);
+    }
+    // The pool waits for the workers when it's destroyed.
+    return;
+  }
+
   buf_->ResetLazy(max_tensor_size);
   for (size_t i = 0; i < params_size; ++i) {
     uint32_t total_size = reader_->Read<uint32_t>();
@@ -136,14 +246,99 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
   }
 }
 
+bool ParamDeserializer::LazyRead(
+    lite::Scope* scope, std::unique_ptr<model_parser::ByteReader> reader) {
+  CHECK(scope) << "The pointer of scope is nullptr";
+  if (!(flags_ & kParamsIndexed)) {
+    return false;
+  }
+  std::shared_ptr<LazyParamDeserializer> loader(
+      new LazyParamDeserializer(std::move(reader), base_));
+  for (const auto& record : ReadIndex()) {
+    auto* tensor = scope->Var(record.name)->GetMutable<lite::Tensor>();
+    tensor->set_persistable(true);
+    loader->Add(record, tensor);
+  }
+  scope->SetLazyParamLoader(loader);
+  return true;
+}
+
+std::vector<ParamRecord> ParamDeserializer::ReadIndex() const {
+  // The param section is the last one of the model, so the position of the
+  // index is found at the end of the reader.
+  const size_t end = reader_->length();
+  CHECK_GE(end, base_ + sizeof(uint64_t));
+  uint64_t index_position = 0;
+  reader_->ReadAt(end - sizeof(uint64_t), &index_position, sizeof(uint64_t));
+  CHECK_LE(base_ + index_position, end - sizeof(uint64_t))
+      << "File format error: The index of params is out of range.";
+  std::string index(end - sizeof(uint64_t) - base_ - index_position, '\0');
+  reader_->ReadAt(base_ + index_position, &index[0], index.size());
+
+  size_t cur = 0;
+  auto read = [&](void* dst, size_t size) {
+    CHECK_LE(cur + size, index.size())
+        << "File format error: The index of params is truncated.";
+    std::memcpy(dst, index.data() + cur, size);
+    cur += size;
+  };
+  std::vector<ParamRecord> records;
+  while (cur < index.size()) {
+    ParamRecord record;
+    uint16_t name_size = 0;
+    read(&name_size, sizeof(name_size));
+    record.name.resize(name_size);
+    read(&record.name[0], name_size);
+    read(&record.position, sizeof(record.position));
+    read(&record.total_size, sizeof(record.total_size));
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+std::vector<ParamRecord> ParamDeserializer::ScanRecords(
+    size_t params_size) const {
+  std::vector<ParamRecord> records(params_size);
+  uint64_t position = reader_->current() - base_;
+  for (auto& record : records) {
+    record.position = position;
+    reader_->ReadAt(
+        base_ + position, &record.total_size, sizeof(record.total_size));
+    position += sizeof(record.total_size) + record.total_size;
+  }
+  return records;
+}
+
 void ParamDeserializer::ReadHeader() {
   // 1. version id
   uint16_t version = reader_->Read<uint16_t>();
   CHECK_EQ(version, 0U)
       << "File format error: The version of params must be zero.";
-  // 2. meta version
+  // 2. meta information, whose leading four bytes are the flags if present.
   uint16_t meta_size = reader_->Read<uint16_t>();
   ReadBytesToBuffer(meta_size);
+  if (meta_size >= sizeof(flags_)) {
+    std::memcpy(&flags_, buf_->data(), sizeof(flags_));
+  }
+}
+
+void LazyParamDeserializer::Load(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pending_.find(name);
+  if (it == pending_.end()) {
+    return;
+  }
+  ReadParamRecord(*reader_, base_ + it->second.first.position, &buf_);
+  fbs::ParamDescView param(&buf_);
+  CHECK_EQ(param.Name(), name)
+      << "File format error: The index of params is inconsistent.";
+  FillTensor(it->second.second, param);
+  pending_.erase(it);
+  if (pending_.empty()) {
+    // Release the buffer and close the file once all of the params are read.
+    buf_ = model_parser::Buffer();
+    reader_.reset();
+  }
 }
 
 }  // namespace fbs
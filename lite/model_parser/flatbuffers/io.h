@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include "lite/core/scope.h"
 #include "lite/core/variable.h"
@@ -33,36 +36,87 @@ void FillParam(const std::string& name,
 
 void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param);
 
+// The param section is laid out as follows, where the positions are relative
+// to the beginning of the section:
+//
+//   [u16 version][u16 meta_size][u32 flags]
+//   [u16 header_size][u16 params_size][u32 max_tensor_size]
+//   params_size * [u32 total_size][u32 offset][ParamDesc]
+//   params_size * [u16 name_size][name][u64 position][u32 total_size]
+//   [u64 index_position]
+//
+// The index of the params follows the params if `kParamsIndexed` is set in the
+// flags. It's ignored by the readers not knowing it, which skip the meta
+// information and stop reading after the params.
+constexpr uint32_t kParamsIndexed = 1U;
+
+// The position and the size of a param record in the param section.
+struct ParamRecord {
+  std::string name;
+  uint64_t position{0};
+  uint32_t total_size{0};
+};
+
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 class ParamSerializer {
  public:
   explicit ParamSerializer(model_parser::ByteWriter* writer,
                            uint16_t version = 0)
-      : writer_(writer), version_{version}, buf_(new model_parser::Buffer) {
+      : writer_(writer), version_{version} {
     CHECK(writer_)
         << "A valid writer should be passed in the ctor of param serializer.";
     WriteHeader();
   }
+  // The params are serialized and written one by one, so only the largest
+  // param is held by the builder at a time.
   void ForwardWrite(const lite::Scope& scope,
                     const std::set<std::string>& param_names);
 
  private:
   void WriteHeader();
+  // Build the ParamDesc of the tensor in the builder, whose data is copied
+  // into the builder directly, then write the finished buffer.
+  void WriteParam(const std::string& name, const lite::Tensor& tensor);
+  void WriteIndex();
+  template <typename T>
+  void Write(T elem) {
+    Write(&elem, sizeof(T));
+  }
+  void Write(const void* src, size_t size) {
+    writer_->Write(src, size);
+    position_ += size;
+  }
   model_parser::ByteWriter* writer_{nullptr};
   uint16_t version_{0};
-  std::unique_ptr<model_parser::Buffer> buf_;
+  std::unique_ptr<flatbuffers::FlatBufferBuilder> fbb_;
+  // The number of bytes written, i.e. the position of the next record.
+  uint64_t position_{0};
+  std::vector<ParamRecord> records_;
 };
 #endif
 
 class ParamDeserializer {
  public:
   explicit ParamDeserializer(model_parser::ByteReader* reader)
-      : reader_(reader), buf_(new model_parser::Buffer) {
+      : reader_(reader),
+        base_(reader ? reader->current() : 0),
+        buf_(new model_parser::Buffer) {
     CHECK(reader_)
         << "A valid reader should be passed in the ctor of param deserializer.";
     ReadHeader();
   }
-  void ForwardRead(lite::Scope* scope);
+  // Read the params into the scope. If `threads` is greater than one, the
+  // records are located by the index or by walking through their headers,
+  // then decoded by the workers in parallel.
+  void ForwardRead(lite::Scope* scope, int threads = 1);
+  // Register the params in the scope without reading their data, which is
+  // read by the loader set to the scope when a param is used for the first
+  // time. The loader reads the section by `reader`, which should cover the
+  // same bytes as the reader of the deserializer. Only the indexed sections
+  // are supported, and false is returned for the others without reading
+  // anything, so that they can be read by ForwardRead.
+  bool LazyRead(lite::Scope* scope,
+                std::unique_ptr<model_parser::ByteReader> reader);
 
  private:
   void ReadBytesToBuffer(size_t size) {
@@ -70,10 +124,37 @@ class ParamDeserializer {
     reader_->Read(buf_->data(), size);
   }
   void ReadHeader();
+  std::vector<ParamRecord> ReadIndex() const;
+  std::vector<ParamRecord> ScanRecords(size_t params_size) const;
   model_parser::ByteReader* reader_{nullptr};
+  // The position of the section in the reader.
+  size_t base_{0};
+  uint32_t flags_{0};
   std::unique_ptr<model_parser::Buffer> buf_;
 };
 
+// Reads the params registered by ParamDeserializer::LazyRead.
+class LazyParamDeserializer : public lite::LazyParamLoader {
+ public:
+  LazyParamDeserializer(std::unique_ptr<model_parser::ByteReader> reader,
+                        size_t base)
+      : reader_(std::move(reader)), base_(base) {
+    CHECK(reader_);
+  }
+  void Add(const ParamRecord& record, lite::Tensor* tensor) {
+    pending_[record.name] = std::make_pair(record, tensor);
+  }
+  void Load(const std::string& name) override;
+  size_t pending_size() const { return pending_.size(); }
+
+ private:
+  std::unique_ptr<model_parser::ByteReader> reader_;
+  size_t base_{0};
+  model_parser::Buffer buf_;
+  std::map<std::string, std::pair<ParamRecord, lite::Tensor*>> pending_;
+  std::mutex mutex_;
+};
+
 namespace deprecated {
 void SetScopeWithCombinedParams(lite::Scope* scope,
                                 const CombinedParamsDescReadAPI& params);
@@ -15,6 +15,7 @@
 #include "lite/model_parser/flatbuffers/io.h"
 #include <gtest/gtest.h>
 #include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -129,6 +130,130 @@ TEST(CombinedParamsDesc, Scope) {
     check_params(scope_3);
   }
 }
+
+TEST(ParamSerializer, SameAsParamDesc) {
+  const std::string path{"io_test.param.fbs"};
+  Scope scope;
+  Tensor* tensor = scope.Var("var_0")->GetMutable<Tensor>();
+  set_tensor<float>(tensor, std::vector<int64_t>({3, 2}));
+  {
+    model_parser::BinaryFileWriter writer{path};
+    fbs::ParamSerializer serializer{&writer};
+    serializer.ForwardWrite(scope, {"var_0"});
+  }
+
+  // The param built in place is the same as the packed ParamDesc.
+  fbs::ParamDesc param;
+  FillParam("var_0", *tensor, &param);
+  model_parser::Buffer expected;
+  param.CopyDataToBuffer(&expected);
+
+  model_parser::BinaryFileReader file_reader(path);
+  model_parser::ByteReader& reader = file_reader;
+  // version, meta size, flags, header size, params size, max tensor size
+  reader.ReadToString(sizeof(uint16_t) * 4 + sizeof(uint32_t) * 2);
+  const uint64_t position = reader.current();
+  uint32_t total_size = reader.Read<uint32_t>();
+  uint32_t offset = reader.Read<uint32_t>();
+  ASSERT_EQ(total_size - offset, expected.size());
+  std::string actual = reader.ReadToString(total_size - offset);
+  EXPECT_EQ(0, std::memcmp(actual.data(), expected.data(), expected.size()));
+
+  // The index of the param follows.
+  const uint64_t index_position = reader.current();
+  ASSERT_EQ(reader.Read<uint16_t>(), 5U);
+  EXPECT_EQ(reader.ReadToString(5), "var_0");
+  EXPECT_EQ(reader.Read<uint64_t>(), position);
+  EXPECT_EQ(reader.Read<uint32_t>(), total_size);
+  EXPECT_EQ(reader.Read<uint64_t>(), index_position);
+  EXPECT_TRUE(reader.ReachEnd());
+}
+
+TEST(ParamDeserializer, ParallelAndLazyRead) {
+  const std::string path{"io_test.parallel.fbs"};
+  Scope scope;
+  std::set<std::string> param_names;
+  for (int i = 0; i < 16; ++i) {
+    std::string name = "var_" + std::to_string(i);
+    set_tensor<float>(scope.Var(name)->GetMutable<Tensor>(),
+                      std::vector<int64_t>({i + 1, 3}));
+    param_names.insert(name);
+  }
+  {
+    model_parser::BinaryFileWriter writer{path};
+    fbs::ParamSerializer serializer{&writer};
+    serializer.ForwardWrite(scope, param_names);
+  }
+  auto check_params = [&](const lite::Scope& loaded) {
+    for (auto& name : param_names) {
+      auto* var = loaded.FindVar(name);
+      ASSERT_TRUE(var);
+      EXPECT_TRUE(TensorCompareWith(scope.FindVar(name)->Get<Tensor>(),
+                                    var->Get<Tensor>()));
+    }
+  };
+
+  {
+    Scope scope_0;
+    model_parser::BinaryFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_0, 4);
+    check_params(scope_0);
+  }
+
+  model_parser::BinaryFileReader file_reader(path);
+  std::string str = file_reader.ReadToString(file_reader.length());
+  {
+    Scope scope_1;
+    model_parser::StringBufferReader reader(str);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_1, 4);
+    check_params(scope_1);
+  }
+
+  // The records are located by their headers if the section is not indexed.
+  std::string unindexed = str;
+  std::memset(&unindexed[sizeof(uint16_t) * 2], 0, sizeof(uint32_t));
+  {
+    Scope scope_2;
+    model_parser::StringBufferReader reader(unindexed);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_2, 3);
+    check_params(scope_2);
+  }
+  {
+    Scope scope_3;
+    model_parser::StringBufferReader reader(unindexed);
+    fbs::ParamDeserializer deserializer(&reader);
+    EXPECT_FALSE(deserializer.LazyRead(
+        &scope_3,
+        std::unique_ptr<model_parser::ByteReader>(
+            new model_parser::StringBufferReader(unindexed))));
+  }
+
+  {
+    Scope scope_4;
+    model_parser::BinaryFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    ASSERT_TRUE(deserializer.LazyRead(
+        &scope_4,
+        std::unique_ptr<model_parser::ByteReader>(
+            new model_parser::BinaryFileReader(path))));
+    // The params are registered without their data.
+    auto& tensor = scope_4.FindVar("var_3")->Get<Tensor>();
+    EXPECT_TRUE(tensor.persistable());
+    EXPECT_EQ(tensor.memory_size(), 0U);
+    Scope& kid = scope_4.NewScope();
+    kid.MaterializeParam("var_3");
+    EXPECT_TRUE(
+        TensorCompareWith(scope.FindVar("var_3")->Get<Tensor>(), tensor));
+    kid.MaterializeParam("not_a_param");
+    for (auto& name : param_names) {
+      kid.MaterializeParam(name);
+    }
+    check_params(scope_4);
+  }
+}
 #endif  // LITE_WITH_FLATBUFFERS_DESC
 
 }  // namespace fbs
@@ -436,26 +436,35 @@ void SaveParamNaive(const std::string &path,
 void SaveCombinedParamsNaive(const std::string &path,
                              const lite::Scope &exec_scope,
                              const cpp::ProgramDesc &cpp_prog) {
-  naive_buffer::BinaryTable table;
-  naive_buffer::proto::CombinedParamsDesc pt_desc(&table);
-  naive_buffer::CombinedParamsDesc desc(&pt_desc);
-
   auto &prog = cpp_prog;
   auto &main_block_desc = *prog.GetBlock<cpp::BlockDesc>(0);
   // set unique_var_names to avoid saving shared params repeatedly
   std::set<std::string> unique_var_names;
+  std::vector<std::string> var_names;
   for (size_t i = 0; i < main_block_desc.VarsSize(); ++i) {
     auto &var = *main_block_desc.GetVar<cpp::VarDesc>(i);
     if (var.Name() == "feed" || var.Name() == "fetch" || !var.Persistable() ||
         unique_var_names.count(var.Name()) > 0)
       continue;
-    naive_buffer::ParamDesc param_desc(desc.AddParam());
-    SetParamInfoNaive(&param_desc, exec_scope, var.Name());
     unique_var_names.emplace(var.Name());
+    var_names.push_back(var.Name());
   }
 
-  pt_desc.Save();
-  table.AppendToFile(path);
+  // The params are streamed in the layout of
+  // naive_buffer::proto::CombinedParamsDesc, i.e. the number of the params
+  // followed by the params, so only one param is serialized in memory at a
+  // time.
+  model_parser::BinaryFileWriter writer{path, true};
+  uint64_t num_params = var_names.size();
+  writer.Write(&num_params, sizeof(num_params));
+  for (auto &var_name : var_names) {
+    naive_buffer::BinaryTable table;
+    naive_buffer::proto::ParamDesc pt_desc(&table);
+    naive_buffer::ParamDesc desc(&pt_desc);
+    SetParamInfoNaive(&desc, exec_scope, var_name);
+    pt_desc.Save();
+    writer.Write(table.data(), table.size());
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -767,7 +776,9 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
 
 void LoadModelNaiveFromFile(const std::string &filename,
                             Scope *scope,
-                            cpp::ProgramDesc *cpp_prog) {
+                            cpp::ProgramDesc *cpp_prog,
+                            int param_load_threads,
+                            bool lazy_param_loading) {
   CHECK(cpp_prog);
   CHECK(scope);
   // ModelFile
@@ -794,7 +805,12 @@ void LoadModelNaiveFromFile(const std::string &filename,
       LoadModelFbsFromFile(&reader, scope, cpp_prog, 1);
       break;
     case 2:
-      LoadModelFbsFromFile(&reader, scope, cpp_prog, 2);
+      LoadModelFbsFromFile(&reader,
+                           scope,
+                           cpp_prog,
+                           2,
+                           param_load_threads,
+                           lazy_param_loading);
       break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
@@ -861,7 +877,9 @@ void LoadModelNaiveV0FromFile(const std::string &filename,
 void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
                           Scope *scope,
                           cpp::ProgramDesc *cpp_prog,
-                          uint16_t meta_version) {
+                          uint16_t meta_version,
+                          int param_load_threads,
+                          bool lazy_param_loading) {
   CHECK(cpp_prog);
   CHECK(scope);
   CHECK_EQ(cpp_prog->BlocksSize(), 0);
@@ -914,7 +932,16 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
     case 2: {
       /* load scope from param.fbs with meta_version=2 */
       fbs::ParamDeserializer deserializer(reader);
-      deserializer.ForwardRead(scope);
+      // The lazy params are read by another reader of the same file, which is
+      // held by the scope.
+      if (!lazy_param_loading ||
+          !deserializer.LazyRead(
+              scope,
+              std::unique_ptr<model_parser::ByteReader>(
+                  new model_parser::BinaryFileReader(reader->path(),
+                                                     reader->offset())))) {
+        deserializer.ForwardRead(scope, param_load_threads);
+      }
       break;
     }
     default:
@@ -925,7 +952,8 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
 
 void LoadModelNaiveFromMemory(const std::string &model_buffer,
                               Scope *scope,
-                              cpp::ProgramDesc *cpp_prog) {
+                              cpp::ProgramDesc *cpp_prog,
+                              int param_load_threads) {
   CHECK(cpp_prog);
   CHECK(scope);
   cpp_prog->ClearBlocks();
@@ -950,7 +978,8 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
       LoadModelFbsFromMemory(&reader, scope, cpp_prog, 1);
       break;
     case 2:
-      LoadModelFbsFromMemory(&reader, scope, cpp_prog, 2);
+      LoadModelFbsFromMemory(
+          &reader, scope, cpp_prog, 2, param_load_threads);
       break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
@@ -1001,7 +1030,8 @@ void LoadModelNaiveV0FromMemory(const std::string &model_buffer,
 void LoadModelFbsFromMemory(model_parser::StringBufferReader *reader,
                             Scope *scope,
                             cpp::ProgramDesc *cpp_prog,
-                            uint16_t meta_version) {
+                            uint16_t meta_version,
+                            int param_load_threads) {
   // (1)get opt version
   char opt_version[16];
   const uint64_t paddle_version_length = 16 * sizeof(char);
@@ -1036,7 +1066,7 @@ void LoadModelFbsFromMemory(model_parser::StringBufferReader *reader,
     }
     case 2: {
       fbs::ParamDeserializer deserializer(reader);
-      deserializer.ForwardRead(scope);
+      deserializer.ForwardRead(scope, param_load_threads);
       break;
     }
     default:
@@ -142,18 +142,28 @@ void LoadNonCombinedParamsPb(const std::string& model_dir,
 void LoadModelFbsFromFile(model_parser::BinaryFileReader* reader,
                           Scope* scope,
                           cpp::ProgramDesc* cpp_prog,
-                          uint16_t meta_version);
-
+                          uint16_t meta_version,
+                          int param_load_threads = 1,
+                          bool lazy_param_loading = false);
+
+// The params of the model are decoded by `param_load_threads` threads. If
+// `lazy_param_loading` is true, the data of a param is read from the file when
+// it's used by an op for the first time, which takes effect only for the
+// models of which the param section is indexed.
 void LoadModelNaiveFromFile(const std::string& filename,
                             lite::Scope* scope,
-                            cpp::ProgramDesc* prog);
+                            cpp::ProgramDesc* prog,
+                            int param_load_threads = 1,
+                            bool lazy_param_loading = false);
 
 void LoadModelNaiveFromMemory(const std::string& model_buffer,
                               lite::Scope* scope,
-                              cpp::ProgramDesc* cpp_prog);
+                              cpp::ProgramDesc* cpp_prog,
+                              int param_load_threads = 1);
 void LoadModelFbsFromMemory(model_parser::StringBufferReader* reader,
                             Scope* scope,
                             cpp::ProgramDesc* cpp_prog,
-                            uint16_t meta_version);
+                            uint16_t meta_version,
+                            int param_load_threads = 1);
 }  // namespace lite
 }  // namespace paddle
@@ -15,6 +15,10 @@
 #include "lite/model_parser/model_parser.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
 #include "lite/core/scope.h"
 
 DEFINE_string(model_dir, "", "");
@@ -111,6 +115,45 @@ TEST(ModelParser, LoadParamNaive) {
   }
 }
 
+std::string ReadFileToString(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file.is_open()) << "Unable to open file: " << path;
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+TEST(ModelParser, SaveCombinedParamsNaive) {
+  Scope scope;
+  cpp::ProgramDesc prog;
+  auto* block = prog.AddBlock<cpp::BlockDesc>();
+  for (auto& name : {"var_0", "var_1"}) {
+    auto* var = block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetPersistable(true);
+    auto* tensor = scope.Var(name)->GetMutable<lite::Tensor>();
+    tensor->Resize({2, 3});
+    auto* data = tensor->mutable_data<float>();
+    for (int i = 0; i < 6; ++i) {
+      data[i] = i * 0.5f;
+    }
+  }
+  const std::string path = "./combined_params.nb";
+  std::remove(path.c_str());
+  SaveCombinedParamsNaive(path, scope, prog);
+
+  // The streamed params are laid out as the CombinedParamsDesc, i.e. the
+  // number of the params followed by the params saved one by one.
+  uint64_t num_params = 2;
+  std::string expected(reinterpret_cast<const char*>(&num_params),
+                       sizeof(num_params));
+  for (auto& name : {"var_0", "var_1"}) {
+    const std::string param_path = std::string("./") + name + ".nb";
+    SaveParamNaive(param_path, scope, name);
+    expected += ReadFileToString(param_path);
+  }
+  EXPECT_EQ(ReadFileToString(path), expected);
+}
+
 TEST(ModelParser, SaveModelNaive) {
   CHECK(!FLAGS_model_dir.empty());
   cpp::ProgramDesc prog;
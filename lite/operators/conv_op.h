@@ -158,6 +158,15 @@ class ConvOpLite : public OpLite {
     if (op_desc.HasAttr("padding_algorithm")) {
       padding_algorithm_ = op_desc.GetAttr<std::string>("padding_algorithm");
     }
+    // For the filter quantized by post_quant_dynamic_pass
+    if (op_desc.HasAttr(Filter + "_quant_scale")) {
+      param_.weight_quant_scale =
+          op_desc.GetAttr<std::vector<float>>(Filter + "_quant_scale");
+      if (op_desc.HasAttr("quantization_type")) {
+        param_.weight_quant_type =
+            op_desc.GetAttr<std::string>("quantization_type");
+      }
+    }
     // For Int8
     const OpInfo* op_info = dynamic_cast<const OpInfo*>(&op_desc);
     if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
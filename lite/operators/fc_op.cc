@@ -131,6 +131,16 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
       param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
   }
 
+  // For the weight quantized by post_quant_dynamic_pass
+  if (op_desc.HasAttr(W + "_quant_scale")) {
+    param_.weight_quant_scale =
+        op_desc.GetAttr<std::vector<float>>(W + "_quant_scale");
+    if (op_desc.HasAttr("quantization_type")) {
+      param_.weight_quant_type =
+          op_desc.GetAttr<std::string>("quantization_type");
+    }
+  }
+
 #ifdef LITE_WITH_FPGA
   if (op_info != nullptr && op_info->HasAttr("fpga_static_quant")) {
     param_.enable_int8 = op_info->GetAttr<bool>("fpga_static_quant");
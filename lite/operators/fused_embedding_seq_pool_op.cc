@@ -0,0 +1,88 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_embedding_seq_pool_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedEmbeddingSeqPoolOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.W)
+  CHECK_OR_FALSE(param_.Ids)
+  CHECK_OR_FALSE(param_.Out)
+  CHECK_EQ_OR_FALSE(param_.W->dims().size(), 2)
+  CHECK_EQ_OR_FALSE(param_.Ids->lod().size(), 1)
+  const auto &ids_dims = param_.Ids->dims();
+  CHECK_GE_OR_FALSE(ids_dims[0],
+                    static_cast<int64_t>(param_.Ids->lod()[0].size()) - 1)
+  if (param_.lookup_type == "lookup_table") {
+    // lookup_table replaces the last dim of Ids, which must be 1.
+    CHECK_EQ_OR_FALSE(ids_dims[ids_dims.size() - 1], 1)
+  }
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::InferShapeImpl() const {
+  const auto &table_dims = param_.W->dims();
+  const auto &ids_dims = param_.Ids->dims();
+  // Each sequence position may have several ids, their rows are concatenated.
+  int64_t ids_per_pos = ids_dims.production() / ids_dims[0];
+  int64_t seq_num = param_.Ids->lod()[0].size() - 1;
+  if (param_.lookup_type.empty()) {
+    param_.Out->Resize({seq_num, ids_per_pos * table_dims[1]});
+    return true;
+  }
+  // Fused from lookup_table(_v2) + sequence_pool, keep the rank of the
+  // pooled embeddings, the data layout is the same.
+  std::vector<int64_t> out_dims = ids_dims.Vectorize();
+  if (param_.lookup_type == "lookup_table_v2") {
+    out_dims.push_back(table_dims[1]);
+  } else {
+    out_dims.back() = table_dims[1];
+  }
+  out_dims[0] = seq_num;
+  param_.Out->Resize(out_dims);
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                         lite::Scope *scope) {
+  param_.W = scope->FindTensor(op_desc.Input("W").front());
+  param_.Ids = scope->FindTensor(op_desc.Input("Ids").front());
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+
+  if (op_desc.HasAttr("padding_idx")) {
+    param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  }
+  if (op_desc.HasAttr("pooltype")) {
+    param_.pool_type = op_desc.GetAttr<std::string>("pooltype");
+  } else if (op_desc.HasAttr("combiner")) {
+    // The fused_embedding_seq_pool op of Paddle only supports "sum".
+    CHECK_EQ(op_desc.GetAttr<std::string>("combiner"), "sum");
+    param_.pool_type = "SUM";
+  }
+  if (op_desc.HasAttr("lookup_type")) {
+    param_.lookup_type = op_desc.GetAttr<std::string>("lookup_type");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_embedding_seq_pool,
+                 paddle::lite::operators::FusedEmbeddingSeqPoolOp);
@@ -69,6 +69,15 @@ bool LookupTableOpLite::AttachImpl(const cpp::OpDesc& op_desc,
   if (op_desc.HasAttr("entry")) {
     param_.entry = op_desc.GetAttr<std::string>("entry");
   }
+  // For the table quantized by post_quant_dynamic_pass
+  if (op_desc.HasAttr(input + "_quant_scale")) {
+    param_.weight_quant_scale =
+        op_desc.GetAttr<std::vector<float>>(input + "_quant_scale");
+    if (op_desc.HasAttr("quantization_type")) {
+      param_.weight_quant_type =
+          op_desc.GetAttr<std::string>("quantization_type");
+    }
+  }
 
   return true;
 }
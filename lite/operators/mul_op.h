@@ -58,6 +58,16 @@ class MulOpLite : public OpLite {
     param_.output = var->GetMutable<Tensor>();
     param_.x_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
     param_.y_num_col_dims = op_desc.GetAttr<int>("y_num_col_dims");
+
+    // For the weight quantized by post_quant_dynamic_pass
+    if (op_desc.HasAttr(W + "_quant_scale")) {
+      param_.weight_quant_scale =
+          op_desc.GetAttr<std::vector<float>>(W + "_quant_scale");
+      if (op_desc.HasAttr("quantization_type")) {
+        param_.weight_quant_type =
+            op_desc.GetAttr<std::string>("quantization_type");
+      }
+    }
     return true;
   }
 
@@ -54,6 +54,23 @@ using param_t = Any;
   float output_scale{1.0f};          \
   int bit_length{8};
 
+/// The per-channel scales of the weight kept in int8/int16/fp16/bf16 by
+/// post_quant_dynamic_pass, it's empty if the weight is fp32, and the
+/// quantization_type of it.
+#define WITH_WEIGHT_ONLY_QUANT_CONFIG       \
+  std::vector<float> weight_quant_scale{}; \
+  std::string weight_quant_type{};
+
+/// The weight converted to the block sparse format by
+/// sparse_weight_convert_pass, `sparse_shape` is the rows and cols of it and
+/// `block_shape` is those of the blocks.
+#define WITH_BLOCK_SPARSE_WEIGHT            \
+  lite::Tensor* sparse_values{nullptr};     \
+  lite::Tensor* sparse_col_index{nullptr};  \
+  lite::Tensor* sparse_row_offset{nullptr}; \
+  std::vector<int> sparse_shape{};          \
+  std::vector<int> block_shape{};
+
 /// ----------------------- Functional operators ------------------------------
 struct FeedParam : ParamBase {
   std::vector<lite::Tensor>* feed_list{};
@@ -131,6 +148,7 @@ struct FcParam : ParamBase {
       "channel"};  // prelu param, can be "all", "channel" or "element"
   // for int8
   WITH_INT8_CONFIG
+  WITH_WEIGHT_ONLY_QUANT_CONFIG
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
@@ -148,6 +166,29 @@ struct FcParam : ParamBase {
   }
 };
 
+// The fc or mul whose weight is transposed and converted to the block sparse
+// format.
+struct SparseFcParam : ParamBase {
+  lite::Tensor* input{nullptr};
+  lite::Tensor* bias{nullptr};
+  lite::Tensor* output{nullptr};
+  int in_num_col_dims{1};
+  // "", "relu" or "relu6".
+  std::string activation_type{""};
+  WITH_BLOCK_SPARSE_WEIGHT
+};
+
+// The 1x1 conv2d with the stride 1, the padding 0 and the group 1, whose
+// filter is converted to the block sparse format.
+struct SparseConvParam : ParamBase {
+  lite::Tensor* input{nullptr};
+  lite::Tensor* bias{nullptr};
+  lite::Tensor* output{nullptr};
+  // "", "relu" or "relu6".
+  std::string activation_type{""};
+  WITH_BLOCK_SPARSE_WEIGHT
+};
+
 struct SearchSeqFcParam : ParamBase {
   lite::Tensor* x{nullptr};
   lite::Tensor* w{nullptr};
@@ -184,6 +225,7 @@ struct MulParam : ParamBase {
   int y_num_col_dims{1};
   // for int8
   WITH_INT8_CONFIG
+  WITH_WEIGHT_ONLY_QUANT_CONFIG
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
@@ -497,6 +539,7 @@ struct ConvParam : ParamBase {
 
   // for int8
   WITH_INT8_CONFIG
+  WITH_WEIGHT_ONLY_QUANT_CONFIG
   // for Conv2d+Scale fusion
   std::string scale_activation_type{""};
   ///////////////////////////////////////////////////////////////////////////////////
@@ -1102,6 +1145,18 @@ struct LookupTableParam : ParamBase {
   bool is_test{true};
   std::string entry_config{""};  // used in distributed training
   std::string entry{"none"};
+  WITH_WEIGHT_ONLY_QUANT_CONFIG
+};
+
+// lookup_table followed by sequence_pool.
+struct FusedEmbeddingSeqPoolParam : ParamBase {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  lite::Tensor* Out{nullptr};
+  int64_t padding_idx{-1};
+  std::string pool_type{"SUM"};
+  // The lookup op merged by the fuse pass, the output keeps its pooled rank.
+  std::string lookup_type;
 };
 
 struct LookupTableDequantParam : ParamBase {
@@ -0,0 +1,104 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/sparse_fc_op.h"
+#include <algorithm>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool SparseFcOpLite::CheckShape() const {
+  CHECK_OR_FALSE(param_.input);
+  CHECK_OR_FALSE(param_.output);
+  CHECK_OR_FALSE(param_.sparse_values);
+  CHECK_OR_FALSE(param_.sparse_col_index);
+  CHECK_OR_FALSE(param_.sparse_row_offset);
+  CHECK_EQ_OR_FALSE(param_.sparse_shape.size(), 2UL);
+  CHECK_EQ_OR_FALSE(param_.block_shape.size(), 2UL);
+  // bias is optional.
+  if (param_.bias) {
+    CHECK_EQ_OR_FALSE(param_.bias->numel(), param_.sparse_shape[0]);
+  }
+  CHECK_EQ_OR_FALSE(param_.sparse_row_offset->numel(),
+                    param_.sparse_shape[0] / param_.block_shape[0] + 1);
+
+  const auto& input_dims = param_.input->dims();
+  CHECK_GT_OR_FALSE(input_dims.size(),
+                    static_cast<size_t>(param_.in_num_col_dims));
+  CHECK_EQ_OR_FALSE(input_dims.Flatten2D(param_.in_num_col_dims)[1],
+                    param_.sparse_shape[1]);
+  return true;
+}
+
+bool SparseFcOpLite::InferShapeImpl() const {
+  const auto& input_dims = param_.input->dims();
+  int in_num_col_dims = param_.in_num_col_dims;
+  std::vector<DDim::value_type> output_dims(in_num_col_dims + 1);
+  for (int i = 0; i < in_num_col_dims; ++i) {
+    output_dims[i] = input_dims[i];
+  }
+  output_dims[in_num_col_dims] = param_.sparse_shape[0];
+  param_.output->Resize(output_dims);
+
+  // share LoD
+  param_.output->set_lod(param_.input->lod());
+  return true;
+}
+
+bool SparseFcOpLite::AttachImpl(const cpp::OpDesc& op_desc,
+                                lite::Scope* scope) {
+  AttachParam(&param_);
+  auto input = op_desc.Input("Input").front();
+  auto values = op_desc.Input("Values").front();
+  auto col_index = op_desc.Input("ColIndex").front();
+  auto row_offset = op_desc.Input("RowOffset").front();
+  auto out = op_desc.Output("Out").front();
+  param_.input = scope->FindVar(input)->GetMutable<lite::Tensor>();
+  param_.sparse_values = scope->FindVar(values)->GetMutable<lite::Tensor>();
+  param_.sparse_col_index =
+      scope->FindVar(col_index)->GetMutable<lite::Tensor>();
+  param_.sparse_row_offset =
+      scope->FindVar(row_offset)->GetMutable<lite::Tensor>();
+  CHECK(scope->FindVar(out));
+  param_.output = scope->FindVar(out)->GetMutable<lite::Tensor>();
+
+  std::vector<std::string> input_arg_names = op_desc.InputArgumentNames();
+  if (std::find(input_arg_names.begin(), input_arg_names.end(), "Bias") !=
+      input_arg_names.end()) {
+    auto bias_arguments = op_desc.Input("Bias");
+    if (bias_arguments.size() > 0) {
+      auto bias_var = scope->FindVar(bias_arguments.front());
+      if (bias_var != nullptr) {
+        param_.bias = bias_var->GetMutable<lite::Tensor>();
+      }
+    }
+  }
+
+  param_.in_num_col_dims = op_desc.GetAttr<int>("in_num_col_dims");
+  param_.sparse_shape = op_desc.GetAttr<std::vector<int>>("sparse_shape");
+  param_.block_shape = op_desc.GetAttr<std::vector<int>>("block_shape");
+  if (op_desc.HasAttr("activation_type")) {
+    param_.activation_type = op_desc.GetAttr<std::string>("activation_type");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(sparse_fc, paddle::lite::operators::SparseFcOpLite);
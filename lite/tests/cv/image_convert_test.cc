@@ -1433,3 +1433,85 @@ TEST(TestImageConvertCustom, test_func_image_preprocess_custom) {
 }
 #endif
 #endif
+
+TEST(TestImagePipeline, test_func_image_pipeline) {
+  typedef paddle::lite::utils::cv::ImagePipeline ImagePipeline;
+  float means[3] = {103.94f, 116.78f, 123.68f};
+  float scales[3] = {0.017f, 0.017f, 0.017f};
+  for (auto size : std::vector<std::vector<int>>{
+           {64, 48, 32, 24}, {100, 38, 224, 224}, {30, 20, 30, 20}}) {
+    int srcw = size[0];
+    int srch = size[1];
+    int dstw = size[2];
+    int dsth = size[3];
+    for (auto srcFormat : {0, 1, 2, 3, 4, 11, 12}) {
+      // NV12(NV21) are converted to BGR by image_convert.
+      for (auto dstFormat : {1, 3, 4}) {
+        for (auto layout : {LayoutType::kNCHW, LayoutType::kNHWC}) {
+          bool nv = srcFormat == ImageFormat::NV12 ||
+                    srcFormat == ImageFormat::NV21;
+          if (nv && dstFormat == ImageFormat::GRAY) continue;
+          std::vector<uint8_t> src(srcw * srch * 4);
+          fill_tensor_host_rand(src.data(), src.size());
+          TransParam tparam;
+          tparam.iw = srcw;
+          tparam.ih = srch;
+          tparam.ow = dstw;
+          tparam.oh = dsth;
+          // resize, convert and image2tensor step by step
+          ImagePreprocess preprocess(
+              (ImageFormat)srcFormat, (ImageFormat)dstFormat, tparam);
+          std::vector<uint8_t> resized(dstw * dsth * 4);
+          std::vector<uint8_t> converted(dstw * dsth * 4);
+          preprocess.image_resize(src.data(),
+                                  resized.data(),
+                                  (ImageFormat)srcFormat,
+                                  srcw,
+                                  srch,
+                                  dstw,
+                                  dsth);
+          preprocess.image_convert(resized.data(),
+                                   converted.data(),
+                                   (ImageFormat)srcFormat,
+                                   (ImageFormat)dstFormat,
+                                   dstw,
+                                   dsth);
+          int channels = dstFormat == ImageFormat::GRAY ? 1 : 3;
+          std::vector<int64_t> shape =
+              layout == LayoutType::kNCHW
+                  ? std::vector<int64_t>{1, channels, dsth, dstw}
+                  : std::vector<int64_t>{1, dsth, dstw, channels};
+          Tensor ref;
+          Tensor_api ref_tensor(&ref);
+          ref_tensor.Resize(shape);
+          preprocess.image_to_tensor(converted.data(),
+                                     &ref_tensor,
+                                     (ImageFormat)dstFormat,
+                                     dstw,
+                                     dsth,
+                                     layout,
+                                     means,
+                                     scales);
+          // fused
+          Tensor out;
+          Tensor_api out_tensor(&out);
+          ImagePipeline pipeline((ImageFormat)srcFormat,
+                                 (ImageFormat)dstFormat,
+                                 tparam,
+                                 layout,
+                                 means,
+                                 scales);
+          pipeline.run(src.data(), &out_tensor);
+          ASSERT_EQ(out_tensor.shape(), shape);
+          const float* ref_data = ref.data<float>();
+          const float* out_data = out.data<float>();
+          for (int i = 0; i < out.numel(); i++) {
+            ASSERT_EQ(ref_data[i], out_data[i])
+                << "srcFormat: " << srcFormat << ", dstFormat: " << dstFormat
+                << ", index: " << i;
+          }
+        }
+      }
+    }
+  }
+}
@@ -383,6 +383,27 @@ TEST(elementwise_x86, precison) {
   TestEltX86<int>(place, abs_error, "mod", "int32");
   TestEltX86<int64_t>(place, abs_error, "mod", "int64");
 }
+
+TEST(elementwise_x86, broadcast) {
+  Place place(TARGET(kX86));
+  float abs_error = 1e-5;
+
+  // same-shape, scalar, per-channel, row and the generic broadcasts
+  TestEltDims(place, abs_error);
+  for (auto op : std::vector<std::string>{"add", "mul", "div", "max"}) {
+    TestEltX86<float>(place, abs_error, op, "def", {2, 3, 4, 5}, {1}, -1);
+    TestEltX86<float>(place, abs_error, op, "def", {2, 16, 9, 11}, {16}, 1);
+    TestEltX86<float>(place, abs_error, op, "def", {2, 3, 4, 37}, {4, 37}, -1);
+    TestEltX86<float>(
+        place, abs_error, op, "def", {2, 3, 4, 5}, {2, 1, 4, 5}, 0);
+    TestEltX86<int>(place, abs_error, op, "int32", {2, 16, 9, 11}, {16}, 1);
+  }
+  for (auto op : std::vector<std::string>{"add", "sub", "mul"}) {
+    TestElt(place, abs_error, op, {2, 3, 4, 5}, {2, 3, 4, 5}, 0, "relu");
+    TestElt(place, abs_error, op, {2, 16, 9, 11}, {16}, 1, "relu");
+    TestElt(place, abs_error, op, {2, 3, 4, 37}, {37}, -1, "relu");
+  }
+}
 #endif
 
 }  // namespace lite
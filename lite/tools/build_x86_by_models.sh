@@ -0,0 +1,68 @@
+#!/bin/bash
+set -e
+set -x
+
+## Global variables
+workspace=$PWD/$(dirname $0)
+readonly workspace=${workspace%%lite/tools*}
+WITH_LOG=OFF
+WITH_EXCEPTION=ON
+WITH_AVX=ON
+WITH_LTO=ON
+
+## step 1: compile opt tool
+cd $workspace
+if [ ! -f build.opt/lite/api/opt ]; then
+./lite/tools/build.sh build_optimize_tool
+fi
+cd build.opt/lite/api
+rm -rf models &&  cp -rf $1 ./models
+
+###  models names
+models_names=$(ls models)
+## step 2. convert models
+rm -rf models_opt && mkdir models_opt
+for name in $models_names
+do
+  ./opt --model_dir=./models/$name --valid_targets=x86 --optimize_out=./models_opt/$name --record_tailoring_info=true
+done
+
+
+# step 3. record model infos, the kernels attrs list records the specialized
+# paths of the kernels used by the models, e.g. CONV_DW3X3S1 and CONV_1X1.
+rm -rf model_info && mkdir model_info
+rm -rf optimized_model && mkdir optimized_model
+content=$(ls ./models_opt | grep -v .nb)
+
+for dir_name in $content
+do
+cat ./models_opt/$dir_name/.tailored_kernels_list >> ./model_info/tailored_kernels_list
+cat ./models_opt/$dir_name/.tailored_kernels_source_list >> ./model_info/tailored_kernels_source_list
+cat ./models_opt/$dir_name/.tailored_kernels_attrs_list >> ./model_info/tailored_kernels_attrs_list
+cat ./models_opt/$dir_name/.tailored_ops_list >> ./model_info/tailored_ops_list
+cat ./models_opt/$dir_name/.tailored_ops_source_list >> ./model_info/tailored_ops_source_list
+cp -f ./models_opt/$dir_name.nb optimized_model
+done
+
+sort -n ./model_info/tailored_kernels_list | uniq > ./model_info/.tailored_kernels_list
+sort -n ./model_info/tailored_kernels_source_list | uniq > ./model_info/.tailored_kernels_source_list
+sort -n ./model_info/tailored_kernels_attrs_list | uniq > ./model_info/.tailored_kernels_attrs_list
+sort -n ./model_info/tailored_ops_list | uniq > ./model_info/.tailored_ops_list
+sort -n ./model_info/tailored_ops_source_list | uniq > ./model_info/.tailored_ops_source_list
+
+rm -rf $(ls ./models_opt | grep -v .nb)
+
+# step 4. compiling x86 lib, the unused kernels and kernel paths are compiled
+# out, and the lib is linked with LTO.
+cd $workspace
+./lite/tools/build.sh --build_tailor=ON --opt_model_dir=$workspace/build.opt/lite/api/model_info --with_log=$WITH_LOG --with_exception=$WITH_EXCEPTION --with_avx=$WITH_AVX --with_lto=$WITH_LTO x86
+
+# step 5. pack compiling results and optimized models
+result_name=x86_lib
+rm -rf $result_name && mkdir $result_name
+cp -rf build.lite.x86/inference_lite_lib $result_name/x86
+cp build.opt/lite/api/opt $result_name/
+mv build.opt/lite/api/optimized_model $result_name
+
+# step6. compress the result into tar file
+tar zcf $result_name.tar.gz $result_name
@@ -0,0 +1,53 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdint.h>
+#include <cstring>
+
+namespace paddle {
+namespace lite {
+
+// bfloat16 keeps the high 16 bits of fp32, i.e. the sign, the 8-bit exponent
+// and the top 7 bits of the mantissa, so it has the range of fp32 with less
+// precision. It's only a storage type, the arithmetic is done in fp32.
+struct bfloat16 {
+  uint16_t x;
+
+  bfloat16() = default;
+
+  // Round to the nearest even, and keep NaN quiet.
+  inline explicit bfloat16(float val) {
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+      x = static_cast<uint16_t>((bits >> 16) | 0x40);
+      return;
+    }
+    bits += 0x7fff + ((bits >> 16) & 1);
+    x = static_cast<uint16_t>(bits >> 16);
+  }
+
+  inline explicit operator float() const {
+    uint32_t bits = static_cast<uint32_t>(x) << 16;
+    float val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+  }
+};
+
+static_assert(sizeof(bfloat16) == 2, "bfloat16 should be of 2 bytes.");
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,121 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image2tensor.h"
+#include "lite/utils/cv/image_avx2.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+// (src - mean) * scale into the planes of NCHW, the channel k uses means[k]
+// and scales[k], and the alpha channel is dropped.
+template <int kChannels>
+void to_tensor_chw(const uint8_t* src,
+                   float* output,
+                   int width,
+                   int height,
+                   float* means,
+                   float* scales) {
+  const int planes = kChannels == 1 ? 1 : 3;
+  const int size = width * height;
+  const bool avx2 = HasAvx2();
+#pragma omp parallel for
+  for (int i = 0; i < height; i++) {
+    const uint8_t* in = src + i * width * kChannels;
+    float* out[3];
+    for (int k = 0; k < planes; k++) {
+      out[k] = output + k * size + i * width;
+    }
+    int j = avx2 ? avx2::normalize_chw_row(
+                       in, width, kChannels, means, scales, out[0], out[1],
+                       out[2])
+                 : 0;
+    for (; j < width; j++) {
+      for (int k = 0; k < planes; k++) {
+        out[k][j] = (in[j * kChannels + k] - means[k]) * scales[k];
+      }
+    }
+  }
+}
+
+// (src - mean) * scale into NHWC.
+template <int kChannels>
+void to_tensor_hwc(const uint8_t* src,
+                   float* output,
+                   int width,
+                   int height,
+                   float* means,
+                   float* scales) {
+  const int planes = kChannels == 1 ? 1 : 3;
+  const bool avx2 = HasAvx2();
+#pragma omp parallel for
+  for (int i = 0; i < height; i++) {
+    const uint8_t* in = src + i * width * kChannels;
+    float* out = output + i * width * planes;
+    int j = avx2 ? avx2::normalize_hwc_row(
+                       in, width, kChannels, means, scales, out)
+                 : 0;
+    for (; j < width; j++) {
+      for (int k = 0; k < planes; k++) {
+        out[j * planes + k] = (in[j * kChannels + k] - means[k]) * scales[k];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+/*
+ * change image data to tensor data on x86, see image2tensor.cc for the
+ * formats and the layouts supported.
+ */
+void Image2Tensor::choose(const uint8_t* src,
+                          Tensor* dst,
+                          ImageFormat srcFormat,
+                          LayoutType layout,
+                          int srcw,
+                          int srch,
+                          float* means,
+                          float* scales) {
+  float* output = dst->mutable_data<float>();
+  if (layout == LayoutType::kNCHW && (srcFormat == BGR || srcFormat == RGB)) {
+    impl_ = to_tensor_chw<3>;
+  } else if (layout == LayoutType::kNHWC &&
+             (srcFormat == BGR || srcFormat == RGB)) {
+    impl_ = to_tensor_hwc<3>;
+  } else if (layout == LayoutType::kNCHW &&
+             (srcFormat == BGRA || srcFormat == RGBA)) {
+    impl_ = to_tensor_chw<4>;
+  } else if (layout == LayoutType::kNHWC &&
+             (srcFormat == BGRA || srcFormat == RGBA)) {
+    impl_ = to_tensor_hwc<4>;
+  } else if ((layout == LayoutType::kNHWC || layout == LayoutType::kNCHW) &&
+             (srcFormat == GRAY)) {
+    impl_ = to_tensor_chw<1>;
+  } else {
+    printf("this layout: %d or image format: %d not support \n",
+           static_cast<int>(layout),
+           srcFormat);
+    return;
+  }
+  impl_(src, output, srcw, srch, means, scales);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,423 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image_avx2.h"
+#include <immintrin.h>
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+namespace avx2 {
+
+namespace {
+
+// A byte permutation over a few 16-byte blocks done by pshufb, `source` maps
+// an output byte to the input byte, or -1 for zero.
+template <int kIn, int kOut>
+struct BlockShuffle {
+  template <typename F>
+  explicit BlockShuffle(F source) {
+    for (int k = 0; k < kOut; k++) {
+      for (int b = 0; b < kIn; b++) {
+        alignas(16) int8_t mask[16];
+        for (int i = 0; i < 16; i++) {
+          int s = source(k * 16 + i);
+          mask[i] = s >= 0 && s / 16 == b ? s % 16 : -128;
+        }
+        masks[k][b] = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+      }
+    }
+  }
+
+  void Apply(const __m128i* in, __m128i* out) const {
+    for (int k = 0; k < kOut; k++) {
+      __m128i acc = _mm_shuffle_epi8(in[0], masks[k][0]);
+      for (int b = 1; b < kIn; b++) {
+        acc = _mm_or_si128(acc, _mm_shuffle_epi8(in[b], masks[k][b]));
+      }
+      out[k] = acc;
+    }
+  }
+
+  __m128i masks[kOut][kIn];
+};
+
+inline __m128i Load16(const uint8_t* ptr) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+
+inline __m128i Load8(const uint8_t* ptr) {
+  return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr));
+}
+
+inline void Store16(uint8_t* ptr, __m128i x) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), x);
+}
+
+inline void Store8(void* ptr, __m128i x) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), x);
+}
+
+// Saturate 16 int16 to uint8.
+inline __m128i PackU8(__m256i x) {
+  return _mm_packus_epi16(_mm256_castsi256_si128(x),
+                          _mm256_extracti128_si256(x, 1));
+}
+
+// (x - mean) * scale of 8 uint8.
+inline __m256 Normalize(__m128i x, __m256 mean, __m256 scale) {
+  __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(x));
+  return _mm256_mul_ps(_mm256_sub_ps(f, mean), scale);
+}
+
+}  // namespace
+
+int nv_to_bgr_row(const uint8_t* y,
+                  const uint8_t* vu,
+                  uint8_t* dst,
+                  int width,
+                  bool nv12,
+                  bool alpha) {
+  // The fixed-point coefficients of the ARM implementation:
+  // R = Y + (179 * (V - 128) >> 7)
+  // G = Y - ((44 * (U - 128) + 91 * (V - 128)) >> 7)
+  // B = Y + (227 * (U - 128) >> 7)
+  const __m256i bias = _mm256_set1_epi16(128);
+  const __m256i kr = _mm256_set1_epi16(179);
+  const __m256i kgu = _mm256_set1_epi16(44);
+  const __m256i kgv = _mm256_set1_epi16(91);
+  const __m256i kb = _mm256_set1_epi16(227);
+  // Duplicate the u and v of a pair of pixels to both of them.
+  const __m128i dup_even =
+      _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14);
+  const __m128i dup_odd =
+      _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15);
+  const __m128i dup_u = nv12 ? dup_even : dup_odd;
+  const __m128i dup_v = nv12 ? dup_odd : dup_even;
+  const __m128i opaque = _mm_set1_epi8(static_cast<char>(255));
+  static const BlockShuffle<3, 3> interleave3(
+      [](int o) { return (o % 3) * 16 + o / 3; });
+
+  int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    __m128i uv = Load16(vu + j);
+    __m256i u = _mm256_sub_epi16(
+        _mm256_cvtepu8_epi16(_mm_shuffle_epi8(uv, dup_u)), bias);
+    __m256i v = _mm256_sub_epi16(
+        _mm256_cvtepu8_epi16(_mm_shuffle_epi8(uv, dup_v)), bias);
+    __m256i r_off = _mm256_srai_epi16(_mm256_mullo_epi16(v, kr), 7);
+    __m256i g_off = _mm256_srai_epi16(
+        _mm256_add_epi16(_mm256_mullo_epi16(u, kgu),
+                         _mm256_mullo_epi16(v, kgv)),
+        7);
+    __m256i b_off = _mm256_srai_epi16(_mm256_mullo_epi16(u, kb), 7);
+    __m256i luma = _mm256_cvtepu8_epi16(Load16(y + j));
+    __m128i bgr[3] = {PackU8(_mm256_add_epi16(luma, b_off)),
+                      PackU8(_mm256_sub_epi16(luma, g_off)),
+                      PackU8(_mm256_add_epi16(luma, r_off))};
+    if (alpha) {
+      uint8_t* out = dst + j * 4;
+      __m128i bg_lo = _mm_unpacklo_epi8(bgr[0], bgr[1]);
+      __m128i bg_hi = _mm_unpackhi_epi8(bgr[0], bgr[1]);
+      __m128i ra_lo = _mm_unpacklo_epi8(bgr[2], opaque);
+      __m128i ra_hi = _mm_unpackhi_epi8(bgr[2], opaque);
+      Store16(out, _mm_unpacklo_epi16(bg_lo, ra_lo));
+      Store16(out + 16, _mm_unpackhi_epi16(bg_lo, ra_lo));
+      Store16(out + 32, _mm_unpacklo_epi16(bg_hi, ra_hi));
+      Store16(out + 48, _mm_unpackhi_epi16(bg_hi, ra_hi));
+    } else {
+      __m128i out[3];
+      interleave3.Apply(bgr, out);
+      Store16(dst + j * 3, out[0]);
+      Store16(dst + j * 3 + 16, out[1]);
+      Store16(dst + j * 3 + 32, out[2]);
+    }
+  }
+  return j;
+}
+
+int resize_hrow(const uint8_t* src,
+                int src_bytes,
+                const int* xofs,
+                const int16_t* ialpha,
+                int16_t* rows,
+                int w_out,
+                int channels) {
+  int dx = 0;
+  if (channels == 1) {
+    // Gather the pairs of the neighbouring pixels, zero-extended to int16.
+    const __m256i pairs = _mm256_setr_epi8(0, -1, 1, -1, 4, -1, 5, -1,
+                                           8, -1, 9, -1, 12, -1, 13, -1,
+                                           0, -1, 1, -1, 4, -1, 5, -1,
+                                           8, -1, 9, -1, 12, -1, 13, -1);
+    for (; dx + 8 <= w_out && xofs[dx + 7] + 4 <= src_bytes; dx += 8) {
+      __m256i idx =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xofs + dx));
+      __m256i px = _mm256_shuffle_epi8(
+          _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), idx, 1),
+          pairs);
+      __m256i alpha =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ialpha + dx * 2));
+      __m256i sum = _mm256_srai_epi32(_mm256_madd_epi16(px, alpha), 4);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(rows + dx),
+                       _mm_packs_epi32(_mm256_castsi256_si128(sum),
+                                       _mm256_extracti128_si256(sum, 1)));
+    }
+    return dx;
+  }
+  // The channels of a pixel and its right neighbour, paired as int16.
+  alignas(16) int8_t mask[16];
+  for (int k = 0; k < 4; k++) {
+    bool valid = k < channels;
+    mask[k * 4] = valid ? k : -128;
+    mask[k * 4 + 1] = -128;
+    mask[k * 4 + 2] = valid ? channels + k : -128;
+    mask[k * 4 + 3] = -128;
+  }
+  const __m128i pairs =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+  // Each pixel stores 4 int16, so `rows` should have 4 - channels more.
+  for (; dx < w_out && xofs[dx] + 8 <= src_bytes; dx++) {
+    __m128i px = _mm_shuffle_epi8(Load8(src + xofs[dx]), pairs);
+    __m128i alpha = _mm_set1_epi32(
+        static_cast<int>(static_cast<uint16_t>(ialpha[dx * 2])) |
+        (static_cast<int>(ialpha[dx * 2 + 1]) << 16));
+    __m128i sum = _mm_srai_epi32(_mm_madd_epi16(px, alpha), 4);
+    Store8(rows + dx * channels, _mm_packs_epi32(sum, sum));
+  }
+  return dx;
+}
+
+int resize_vrow(const int16_t* rows0,
+                const int16_t* rows1,
+                int16_t b0,
+                int16_t b1,
+                uint8_t* dst,
+                int size) {
+  const __m256i vb0 = _mm256_set1_epi16(b0);
+  const __m256i vb1 = _mm256_set1_epi16(b1);
+  const __m256i two = _mm256_set1_epi16(2);
+  int i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m256i r0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows0 + i));
+    __m256i r1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows1 + i));
+    // ((r0 * b0 >> 16) + (r1 * b1 >> 16) + 2) >> 2
+    __m256i acc = _mm256_add_epi16(_mm256_mulhi_epi16(r0, vb0),
+                                   _mm256_mulhi_epi16(r1, vb1));
+    acc = _mm256_srai_epi16(_mm256_add_epi16(acc, two), 2);
+    Store16(dst + i, PackU8(acc));
+  }
+  return i;
+}
+
+namespace {
+template <int kChannels>
+int FlipRow(const uint8_t* src, uint8_t* dst, int width) {
+  // 16 pixels in kChannels blocks are reversed at a time.
+  static const BlockShuffle<kChannels, kChannels> reverse([](int o) {
+    return (15 - o / kChannels) * kChannels + o % kChannels;
+  });
+  int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    __m128i in[kChannels];
+    __m128i out[kChannels];
+    for (int k = 0; k < kChannels; k++) {
+      in[k] = Load16(src + j * kChannels + k * 16);
+    }
+    reverse.Apply(in, out);
+    uint8_t* dst_ptr = dst + (width - j - 16) * kChannels;
+    for (int k = 0; k < kChannels; k++) {
+      Store16(dst_ptr + k * 16, out[k]);
+    }
+  }
+  return j;
+}
+}  // namespace
+
+int flip_row(const uint8_t* src, uint8_t* dst, int width, int channels) {
+  switch (channels) {
+    case 1:
+      return FlipRow<1>(src, dst, width);
+    case 2:
+      return FlipRow<2>(src, dst, width);
+    case 3:
+      return FlipRow<3>(src, dst, width);
+    case 4:
+      return FlipRow<4>(src, dst, width);
+    default:
+      return 0;
+  }
+}
+
+bool transpose_tile(const uint8_t* src,
+                    ptrdiff_t src_stride,
+                    uint8_t* dst,
+                    ptrdiff_t dst_stride,
+                    int channels) {
+  if (channels == 1) {
+    __m128i r[8];
+    for (int i = 0; i < 8; i++) {
+      r[i] = Load8(src + i * src_stride);
+    }
+    __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+    __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+    __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+    __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+    __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+    __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+    __m128i c[4] = {_mm_unpacklo_epi32(b0, b2),
+                    _mm_unpackhi_epi32(b0, b2),
+                    _mm_unpacklo_epi32(b1, b3),
+                    _mm_unpackhi_epi32(b1, b3)};
+    for (int i = 0; i < 4; i++) {
+      Store8(dst + (2 * i) * dst_stride, c[i]);
+      Store8(dst + (2 * i + 1) * dst_stride, _mm_unpackhi_epi64(c[i], c[i]));
+    }
+    return true;
+  }
+  if (channels == 4) {
+    __m256i r[8];
+    for (int i = 0; i < 8; i++) {
+      r[i] = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(src + i * src_stride));
+    }
+    __m256i t[8];
+    for (int i = 0; i < 8; i += 2) {
+      t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    __m256i u[8];
+    for (int i = 0; i < 8; i += 4) {
+      u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+      u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+      u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+      u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; i++) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * dst_stride),
+                          _mm256_permute2x128_si256(u[i], u[i + 4], 0x20));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(dst + (i + 4) * dst_stride),
+          _mm256_permute2x128_si256(u[i], u[i + 4], 0x31));
+    }
+    return true;
+  }
+  return false;
+}
+
+int normalize_chw_row(const uint8_t* src,
+                      int width,
+                      int channels,
+                      const float* means,
+                      const float* scales,
+                      float* dst_b,
+                      float* dst_g,
+                      float* dst_r) {
+  int j = 0;
+  if (channels == 1) {
+    const __m256 mean = _mm256_set1_ps(means[0]);
+    const __m256 scale = _mm256_set1_ps(scales[0]);
+    for (; j + 8 <= width; j += 8) {
+      _mm256_storeu_ps(dst_b + j, Normalize(Load8(src + j), mean, scale));
+    }
+    return j;
+  }
+  if (channels != 3 && channels != 4) return 0;
+  // Gather the b, g and r of 8 pixels into the bytes 0-7, 8-15 and 16-23.
+  static const BlockShuffle<2, 2> planar3(
+      [](int o) { return o < 24 ? (o % 8) * 3 + o / 8 : -1; });
+  static const BlockShuffle<2, 2> planar4(
+      [](int o) { return o < 24 ? (o % 8) * 4 + o / 8 : -1; });
+  const auto& planar = channels == 3 ? planar3 : planar4;
+  const __m256 mean_b = _mm256_set1_ps(means[0]);
+  const __m256 mean_g = _mm256_set1_ps(means[1]);
+  const __m256 mean_r = _mm256_set1_ps(means[2]);
+  const __m256 scale_b = _mm256_set1_ps(scales[0]);
+  const __m256 scale_g = _mm256_set1_ps(scales[1]);
+  const __m256 scale_r = _mm256_set1_ps(scales[2]);
+  for (; j + 8 <= width; j += 8) {
+    const uint8_t* ptr = src + j * channels;
+    __m128i in[2] = {Load16(ptr),
+                     channels == 3 ? Load8(ptr + 16) : Load16(ptr + 16)};
+    __m128i out[2];
+    planar.Apply(in, out);
+    _mm256_storeu_ps(dst_b + j, Normalize(out[0], mean_b, scale_b));
+    _mm256_storeu_ps(dst_g + j,
+                     Normalize(_mm_unpackhi_epi64(out[0], out[0]),
+                               mean_g,
+                               scale_g));
+    _mm256_storeu_ps(dst_r + j, Normalize(out[1], mean_r, scale_r));
+  }
+  return j;
+}
+
+int normalize_hwc_row(const uint8_t* src,
+                      int width,
+                      int channels,
+                      const float* means,
+                      const float* scales,
+                      float* dst) {
+  if (channels == 1) {
+    return normalize_chw_row(
+        src, width, 1, means, scales, dst, nullptr, nullptr);
+  }
+  if (channels != 3 && channels != 4) return 0;
+  // Drop the alpha of 8 pixels into 24 bytes.
+  static const BlockShuffle<2, 2> compact4(
+      [](int o) { return o < 24 ? (o / 3) * 4 + o % 3 : -1; });
+  // The 24 outputs of 8 pixels are of the channels 0 1 2 0 1 2 ...
+  __m256 mean[3];
+  __m256 scale[3];
+  for (int k = 0; k < 3; k++) {
+    alignas(32) float m[8];
+    alignas(32) float s[8];
+    for (int e = 0; e < 8; e++) {
+      m[e] = means[(k * 8 + e) % 3];
+      s[e] = scales[(k * 8 + e) % 3];
+    }
+    mean[k] = _mm256_load_ps(m);
+    scale[k] = _mm256_load_ps(s);
+  }
+  int j = 0;
+  for (; j + 8 <= width; j += 8) {
+    const uint8_t* ptr = src + j * channels;
+    __m128i bytes[2];
+    if (channels == 3) {
+      bytes[0] = Load16(ptr);
+      bytes[1] = Load8(ptr + 16);
+    } else {
+      __m128i in[2] = {Load16(ptr), Load16(ptr + 16)};
+      compact4.Apply(in, bytes);
+    }
+    float* out = dst + j * 3;
+    _mm256_storeu_ps(out, Normalize(bytes[0], mean[0], scale[0]));
+    _mm256_storeu_ps(out + 8,
+                     Normalize(_mm_unpackhi_epi64(bytes[0], bytes[0]),
+                               mean[1],
+                               scale[1]));
+    _mm256_storeu_ps(out + 16, Normalize(bytes[1], mean[2], scale[2]));
+  }
+  return j;
+}
+
+}  // namespace avx2
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,102 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// The AVX2 kernels are built into the x86 version of the library, the code
+// shared with ARM calls them under this macro.
+#if defined(LITE_WITH_X86) && !defined(LITE_WITH_ARM)
+#define LITE_CV_WITH_AVX2
+#endif
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+// Whether the AVX2 kernels below can run on the current CPU. They are
+// compiled with the AVX2 flags into their own file and selected at runtime, so
+// the library still runs on the CPUs without AVX2.
+bool HasAvx2();
+
+namespace avx2 {
+
+// The kernels process the leading part of a row and return the number of the
+// pixels processed, the rest is left to the scalar code.
+
+// Convert a row of NV12 or NV21 to BGR, or BGRA if `alpha`.
+int nv_to_bgr_row(const uint8_t* y,
+                  const uint8_t* vu,
+                  uint8_t* dst,
+                  int width,
+                  bool nv12,
+                  bool alpha);
+
+// The horizontal pass of the bilinear resize:
+// rows[dx * c + k] = (src[xofs[dx] + k] * a0 + src[xofs[dx] + c + k] * a1) >> 4
+// where the source row is of `src_bytes` bytes, and c is 1, 2, 3 or 4.
+int resize_hrow(const uint8_t* src,
+                int src_bytes,
+                const int* xofs,
+                const int16_t* ialpha,
+                int16_t* rows,
+                int w_out,
+                int channels);
+
+// The vertical pass of the bilinear resize over `size` values.
+int resize_vrow(const int16_t* rows0,
+                const int16_t* rows1,
+                int16_t b0,
+                int16_t b1,
+                uint8_t* dst,
+                int size);
+
+// Write the pixels of a row in the reversed order, c is 1, 2, 3 or 4.
+int flip_row(const uint8_t* src, uint8_t* dst, int width, int channels);
+
+// Transpose a tile of 8 x 8 pixels, the strides are in bytes and may be
+// negative. Return false if the channels, e.g. 3, are not supported.
+bool transpose_tile(const uint8_t* src,
+                    ptrdiff_t src_stride,
+                    uint8_t* dst,
+                    ptrdiff_t dst_stride,
+                    int channels);
+
+// (src - mean) * scale of a row of GRAY, BGR or BGRA into the planes of NCHW.
+// The alpha channel is dropped.
+int normalize_chw_row(const uint8_t* src,
+                      int width,
+                      int channels,
+                      const float* means,
+                      const float* scales,
+                      float* dst_b,
+                      float* dst_g,
+                      float* dst_r);
+
+// (src - mean) * scale of a row of GRAY, BGR or BGRA into NHWC, the alpha
+// channel is dropped.
+int normalize_hwc_row(const uint8_t* src,
+                      int width,
+                      int channels,
+                      const float* means,
+                      const float* scales,
+                      float* dst);
+
+}  // namespace avx2
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
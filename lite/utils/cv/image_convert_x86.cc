@@ -0,0 +1,201 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+#include <string.h>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/utils/cv/image_avx2.h"
+#include "lite/utils/cv/image_convert.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+bool HasAvx2() {
+  static const bool has_avx2 = lite::x86::MayIUse(lite::x86::avx2);
+  return has_avx2;
+}
+
+namespace {
+
+inline uint8_t clamp_u8(int x) {
+  return static_cast<uint8_t>(x < 0 ? 0 : (x > 255 ? 255 : x));
+}
+
+// The x86 version of the NV12/NV21 to BGR(A) of image_convert.cc, with the
+// same fixed-point coefficients, so the results are identical.
+void nv_to_bgr_common(const uint8_t* src,
+                      uint8_t* dst,
+                      int srcw,
+                      int srch,
+                      bool nv12,
+                      bool alpha) {
+  const uint8_t* y_plane = src;
+  const uint8_t* vu_plane = src + srcw * srch;
+  int channels = alpha ? 4 : 3;
+  int u_num = nv12 ? 0 : 1;
+  int v_num = 1 - u_num;
+  bool avx2 = HasAvx2();
+#pragma omp parallel for
+  for (int i = 0; i < srch; i++) {
+    const uint8_t* y = y_plane + i * srcw;
+    const uint8_t* vu = vu_plane + (i / 2) * srcw;
+    uint8_t* out = dst + i * srcw * channels;
+    int j = avx2 ? avx2::nv_to_bgr_row(y, vu, out, srcw, nv12, alpha) : 0;
+    for (; j < srcw; j++) {
+      const uint8_t* uv = vu + (j & ~1);
+      int u = uv[u_num] - 128;
+      int v = uv[v_num] - 128;
+      int ra = (179 * v) >> 7;
+      int ga = (44 * u + 91 * v) >> 7;
+      int ba = (227 * u) >> 7;
+      uint8_t* pixel = out + j * channels;
+      pixel[0] = clamp_u8(y[j] + ba);
+      pixel[1] = clamp_u8(y[j] - ga);
+      pixel[2] = clamp_u8(y[j] + ra);
+      if (alpha) pixel[3] = 255;
+    }
+  }
+}
+
+void nv12_to_bgr(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  nv_to_bgr_common(src, dst, srcw, srch, true, false);
+}
+
+void nv21_to_bgr(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  nv_to_bgr_common(src, dst, srcw, srch, false, false);
+}
+
+void nv12_to_bgra(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  nv_to_bgr_common(src, dst, srcw, srch, true, true);
+}
+
+void nv21_to_bgra(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+  nv_to_bgr_common(src, dst, srcw, srch, false, true);
+}
+
+// Gray = (15 * B + 75 * G + 38 * R) / 128
+template <int kInC>
+void to_gray(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+#pragma omp parallel for
+  for (int i = 0; i < srch; i++) {
+    const uint8_t* in = src + i * srcw * kInC;
+    uint8_t* out = dst + i * srcw;
+    for (int j = 0; j < srcw; j++) {
+      const uint8_t* pixel = in + j * kInC;
+      out[j] = (pixel[0] * 15 + pixel[1] * 75 + pixel[2] * 38) >> 7;
+    }
+  }
+}
+
+// Copy the first 3 channels, swapped if kSwap, and fill the alpha with 255.
+template <int kInC, int kOutC, bool kSwap>
+void convert_hwc(const uint8_t* src, uint8_t* dst, int srcw, int srch) {
+#pragma omp parallel for
+  for (int i = 0; i < srch; i++) {
+    const uint8_t* in = src + i * srcw * kInC;
+    uint8_t* out = dst + i * srcw * kOutC;
+    for (int j = 0; j < srcw; j++) {
+      const uint8_t* p = in + j * kInC;
+      uint8_t* q = out + j * kOutC;
+      if (kInC == 1) {
+        q[0] = q[1] = q[2] = p[0];
+      } else {
+        q[0] = p[kSwap ? 2 : 0];
+        q[1] = p[1];
+        q[2] = p[kSwap ? 0 : 2];
+      }
+      if (kOutC == 4) q[3] = kInC == 4 ? p[3] : 255;
+    }
+  }
+}
+
+}  // namespace
+
+/*
+ * image color convert on x86, see image_convert.cc for the formats supported.
+ * The rows are converted in parallel and NV12/NV21 use the AVX2 kernels if the
+ * CPU supports them.
+ */
+void ImageConvert::choose(const uint8_t* src,
+                          uint8_t* dst,
+                          ImageFormat srcFormat,
+                          ImageFormat dstFormat,
+                          int srcw,
+                          int srch) {
+  if (srcFormat == dstFormat) {
+    // copy
+    int size = srcw * srch;
+    if (srcFormat == NV12 || srcFormat == NV21) {
+      size = srcw * (ceil(1.5 * srch));
+    } else if (srcFormat == BGR || srcFormat == RGB) {
+      size = 3 * srcw * srch;
+    } else if (srcFormat == BGRA || srcFormat == RGBA) {
+      size = 4 * srcw * srch;
+    }
+    memcpy(dst, src, sizeof(uint8_t) * size);
+    return;
+  } else {
+    if (srcFormat == NV12 && (dstFormat == BGR || dstFormat == RGB)) {
+      impl_ = nv12_to_bgr;
+    } else if (srcFormat == NV21 && (dstFormat == BGR || dstFormat == RGB)) {
+      impl_ = nv21_to_bgr;
+    } else if (srcFormat == NV12 && (dstFormat == BGRA || dstFormat == RGBA)) {
+      impl_ = nv12_to_bgra;
+    } else if (srcFormat == NV21 && (dstFormat == BGRA || dstFormat == RGBA)) {
+      impl_ = nv21_to_bgra;
+    } else if ((srcFormat == RGBA && dstFormat == RGB) ||
+               (srcFormat == BGRA && dstFormat == BGR)) {
+      impl_ = convert_hwc<4, 3, false>;
+    } else if ((srcFormat == RGB && dstFormat == RGBA) ||
+               (srcFormat == BGR && dstFormat == BGRA)) {
+      impl_ = convert_hwc<3, 4, false>;
+    } else if ((srcFormat == RGB && dstFormat == BGR) ||
+               (srcFormat == BGR && dstFormat == RGB)) {
+      impl_ = convert_hwc<3, 3, true>;
+    } else if ((srcFormat == RGBA && dstFormat == BGRA) ||
+               (srcFormat == BGRA && dstFormat == RGBA)) {
+      impl_ = convert_hwc<4, 4, true>;
+    } else if ((srcFormat == RGB && dstFormat == GRAY) ||
+               (srcFormat == BGR && dstFormat == GRAY)) {
+      impl_ = to_gray<3>;
+    } else if ((srcFormat == GRAY && dstFormat == RGB) ||
+               (srcFormat == GRAY && dstFormat == BGR)) {
+      impl_ = convert_hwc<1, 3, false>;
+    } else if ((srcFormat == RGBA && dstFormat == BGR) ||
+               (srcFormat == BGRA && dstFormat == RGB)) {
+      impl_ = convert_hwc<4, 3, true>;
+    } else if ((srcFormat == RGB && dstFormat == BGRA) ||
+               (srcFormat == BGR && dstFormat == RGBA)) {
+      impl_ = convert_hwc<3, 4, true>;
+    } else if ((srcFormat == GRAY && dstFormat == RGBA) ||
+               (srcFormat == GRAY && dstFormat == BGRA)) {
+      impl_ = convert_hwc<1, 4, false>;
+    } else if ((srcFormat == RGBA && dstFormat == GRAY) ||
+               (srcFormat == BGRA && dstFormat == GRAY)) {
+      impl_ = to_gray<4>;
+    } else {
+      printf("srcFormat: %d, dstFormat: %d does not support! \n",
+             srcFormat,
+             dstFormat);
+      return;
+    }
+  }
+  impl_(src, dst, srcw, srch);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,100 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "lite/utils/cv/image_avx2.h"
+#include "lite/utils/cv/image_flip.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+void ImageFlip::choose(const uint8_t* src,
+                       uint8_t* dst,
+                       ImageFormat srcFormat,
+                       int srcw,
+                       int srch,
+                       FlipParam flip_param) {
+  if (srcFormat == GRAY) {
+    flip_hwc1(src, dst, srcw, srch, flip_param);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    flip_hwc3(src, dst, srcw, srch, flip_param);
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    flip_hwc4(src, dst, srcw, srch, flip_param);
+  } else {
+    printf("this srcFormat: %d does not support! \n", srcFormat);
+    return;
+  }
+}
+
+namespace {
+
+// X flips the rows upside down, Y mirrors the columns, XY does both.
+void flip_hwc(const uint8_t* src,
+              uint8_t* dst,
+              int srcw,
+              int srch,
+              int channels,
+              FlipParam flip_param) {
+  if (flip_param != X && flip_param != Y && flip_param != XY) return;
+  const int stride = srcw * channels;
+  const bool avx2 = HasAvx2();
+#pragma omp parallel for
+  for (int i = 0; i < srch; i++) {
+    const uint8_t* in = src + i * stride;
+    uint8_t* out = dst + (flip_param == Y ? i : srch - 1 - i) * stride;
+    if (flip_param == X) {
+      memcpy(out, in, stride);
+      continue;
+    }
+    int j = avx2 ? avx2::flip_row(in, out, srcw, channels) : 0;
+    for (; j < srcw; j++) {
+      const uint8_t* p = in + j * channels;
+      uint8_t* q = out + (srcw - 1 - j) * channels;
+      for (int k = 0; k < channels; k++) {
+        q[k] = p[k];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void flip_hwc1(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  flip_hwc(src, dst, srcw, srch, 1, flip_param);
+}
+
+void flip_hwc3(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  flip_hwc(src, dst, srcw, srch, 3, flip_param);
+}
+
+void flip_hwc4(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  flip_hwc(src, dst, srcw, srch, 4, flip_param);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,275 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "lite/utils/cv/image_avx2.h"
+#include "lite/utils/cv/image_resize_rows.h"
+#include "lite/utils/cv/paddle_image_preprocess.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+namespace {
+
+// The channels of the pixels, 1 for the Y plane of NV12(NV21).
+int channels_of(ImageFormat format) {
+  if (format == BGR || format == RGB) return 3;
+  if (format == BGRA || format == RGBA) return 4;
+  return 1;
+}
+
+bool is_nv(ImageFormat format) { return format == NV12 || format == NV21; }
+
+bool is_rgb_order(ImageFormat format) {
+  return format == RGB || format == RGBA;
+}
+
+bool is_supported(ImageFormat srcFormat, ImageFormat dstFormat) {
+  bool src_ok = srcFormat == GRAY || is_nv(srcFormat) ||
+                channels_of(srcFormat) > 1;
+  bool dst_ok = dstFormat == GRAY || channels_of(dstFormat) > 1;
+  return src_ok && dst_ok && !(is_nv(srcFormat) && dstFormat == GRAY);
+}
+
+inline uint8_t clamp_u8(int x) {
+  return static_cast<uint8_t>(x < 0 ? 0 : (x > 255 ? 255 : x));
+}
+
+// NV12(NV21) to BGR of a row, the same as image_convert.
+void nv_to_bgr_row(const uint8_t* y,
+                   const uint8_t* vu,
+                   uint8_t* dst,
+                   int width,
+                   bool nv12) {
+  int j = 0;
+#ifdef LITE_CV_WITH_AVX2
+  if (HasAvx2()) j = avx2::nv_to_bgr_row(y, vu, dst, width, nv12, false);
+#endif
+  int u_num = nv12 ? 0 : 1;
+  int v_num = 1 - u_num;
+  for (; j < width; j++) {
+    const uint8_t* uv = vu + (j & ~1);
+    int u = uv[u_num] - 128;
+    int v = uv[v_num] - 128;
+    int ra = (179 * v) >> 7;
+    int ga = (44 * u + 91 * v) >> 7;
+    int ba = (227 * u) >> 7;
+    dst[j * 3] = clamp_u8(y[j] + ba);
+    dst[j * 3 + 1] = clamp_u8(y[j] - ga);
+    dst[j * 3 + 2] = clamp_u8(y[j] + ra);
+  }
+}
+
+// Gray = (15 * B + 75 * G + 38 * R) / 128, the same as image_convert.
+void gray_row(const uint8_t* src, int channels, uint8_t* dst, int width) {
+  for (int j = 0; j < width; j++) {
+    const uint8_t* p = src + j * channels;
+    dst[j] = (p[0] * 15 + p[1] * 75 + p[2] * 38) >> 7;
+  }
+}
+
+// Write (src[order[k]] - means[k]) * scales[k] of the channels k of a row,
+// into the planes of plane_size floats if NCHW, or interleaved if NHWC.
+void normalize_row(const uint8_t* src,
+                   int width,
+                   int src_channels,
+                   const int* order,
+                   int dst_channels,
+                   const float* means,
+                   const float* scales,
+                   bool nchw,
+                   int plane_size,
+                   float* dst) {
+  int j = 0;
+#ifdef LITE_CV_WITH_AVX2
+  if (HasAvx2() && (src_channels > 1) == (dst_channels > 1)) {
+    if (dst_channels == 1) {
+      j = avx2::normalize_chw_row(
+          src, width, 1, means, scales, dst, nullptr, nullptr);
+    } else if (nchw) {
+      // The source channel order[k] goes to the plane k.
+      float* planes[3];
+      float m[3];
+      float s[3];
+      for (int k = 0; k < 3; k++) {
+        planes[order[k]] = dst + k * plane_size;
+        m[order[k]] = means[k];
+        s[order[k]] = scales[k];
+      }
+      j = avx2::normalize_chw_row(
+          src, width, src_channels, m, s, planes[0], planes[1], planes[2]);
+    } else if (order[0] == 0 && order[2] == 2) {
+      j = avx2::normalize_hwc_row(src, width, src_channels, means, scales, dst);
+    }
+  }
+#endif
+  for (; j < width; j++) {
+    const uint8_t* p = src + j * src_channels;
+    for (int k = 0; k < dst_channels; k++) {
+      float value = (p[order[k]] - means[k]) * scales[k];
+      if (nchw) {
+        dst[k * plane_size + j] = value;
+      } else {
+        dst[j * dst_channels + k] = value;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+__attribute__((visibility("default")))
+ImagePipeline::ImagePipeline(ImageFormat srcFormat,
+                             ImageFormat dstFormat,
+                             TransParam param,
+                             LayoutType layout,
+                             const float* means,
+                             const float* scales)
+    : srcFormat_(srcFormat),
+      dstFormat_(dstFormat),
+      transParam_(param),
+      layout_(layout) {
+  int dst_channels = dstFormat == GRAY ? 1 : 3;
+  for (int k = 0; k < 3; k++) {
+    means_[k] = k < dst_channels ? means[k] : 0.f;
+    scales_[k] = k < dst_channels ? scales[k] : 1.f;
+  }
+  int iw = param.iw;
+  int ih = param.ih;
+  int ow = param.ow;
+  int oh = param.oh;
+  if (!is_supported(srcFormat, dstFormat) || (iw == ow && ih == oh)) return;
+  int channels = channels_of(srcFormat);
+  coef_ = new ResizeCoef;
+  compute_resize_coef(
+      iw * channels, iw, ih, ow * channels, ow, oh, channels, coef_);
+  if (is_nv(srcFormat)) {
+    uv_coef_ = new ResizeCoef;
+    // A single pixel wide output still needs a pair of uv.
+    int uv_ow = std::max(ow / 2, 1);
+    compute_resize_coef(
+        iw, iw / 2, ih / 2, uv_ow * 2, uv_ow, oh / 2, 2, uv_coef_);
+  }
+}
+
+__attribute__((visibility("default"))) ImagePipeline::~ImagePipeline() {
+  delete coef_;
+  delete uv_coef_;
+}
+
+__attribute__((visibility("default"))) void ImagePipeline::run(
+    const uint8_t* src, Tensor* dstTensor) {
+  if (!is_supported(srcFormat_, dstFormat_)) {
+    printf("srcFormat: %d, dstFormat: %d does not support! \n",
+           srcFormat_,
+           dstFormat_);
+    return;
+  }
+  if (layout_ != LayoutType::kNCHW && layout_ != LayoutType::kNHWC) {
+    printf("this layout: %d not support \n", static_cast<int>(layout_));
+    return;
+  }
+  const int iw = transParam_.iw;
+  const int ih = transParam_.ih;
+  const int ow = transParam_.ow;
+  const int oh = transParam_.oh;
+  const bool nchw = layout_ == LayoutType::kNCHW;
+  const bool nv = is_nv(srcFormat_);
+  const int src_channels = channels_of(srcFormat_);
+  const int dst_channels = dstFormat_ == GRAY ? 1 : 3;
+  if (nchw) {
+    dstTensor->Resize({1, dst_channels, oh, ow});
+  } else {
+    dstTensor->Resize({1, oh, ow, dst_channels});
+  }
+  float* output = dstTensor->mutable_data<float>();
+
+  // The pixels converted to dstFormat are of these channels, dst channel k is
+  // the channel order[k] of a pixel.
+  const bool to_gray = dstFormat_ == GRAY && srcFormat_ != GRAY;
+  const int pixel_channels = nv ? 3 : (to_gray ? 1 : src_channels);
+  int order[3] = {0, 1, 2};
+  if (pixel_channels == 1) {
+    order[1] = order[2] = 0;
+  } else if (is_rgb_order(srcFormat_) != is_rgb_order(dstFormat_)) {
+    order[0] = 2;
+    order[2] = 0;
+  }
+  const uint8_t* uv_src = src + iw * ih;
+  const int uv_rows = uv_coef_ ? uv_coef_->h_out : ih / 2;
+
+#pragma omp parallel
+  {
+    std::unique_ptr<ResizeRows> rows(coef_ ? new ResizeRows(coef_) : nullptr);
+    std::unique_ptr<ResizeRows> uv_rows_resize(
+        uv_coef_ ? new ResizeRows(uv_coef_) : nullptr);
+    std::vector<uint8_t> resized(coef_ ? ow * src_channels : 0);
+    std::vector<uint8_t> uv_resized(uv_coef_ ? ow + 1 : 0);
+    std::vector<uint8_t> converted(nv || to_gray ? ow * pixel_channels : 0);
+    int uv_row = -1;
+#pragma omp for schedule(static)
+    for (int dy = 0; dy < oh; dy++) {
+      // resize
+      const uint8_t* row = src + dy * iw * src_channels;
+      if (rows) {
+        rows->run(src, dy, resized.data());
+        row = resized.data();
+      }
+      // convert
+      const uint8_t* pixels = row;
+      if (nv) {
+        int uv_dy = std::min(dy / 2, uv_rows - 1);
+        const uint8_t* vu = uv_src + uv_dy * iw;
+        if (uv_rows_resize) {
+          if (uv_dy != uv_row) {
+            uv_rows_resize->run(uv_src, uv_dy, uv_resized.data());
+            if ((ow & 1) && ow >= 3) {
+              // The last pixel of an odd width shares the last pair.
+              uv_resized[ow - 1] = uv_resized[ow - 3];
+              uv_resized[ow] = uv_resized[ow - 2];
+            }
+            uv_row = uv_dy;
+          }
+          vu = uv_resized.data();
+        }
+        nv_to_bgr_row(row, vu, converted.data(), ow, srcFormat_ == NV12);
+        pixels = converted.data();
+      } else if (to_gray) {
+        gray_row(row, src_channels, converted.data(), ow);
+        pixels = converted.data();
+      }
+      // normalize
+      normalize_row(pixels,
+                    ow,
+                    pixel_channels,
+                    order,
+                    dst_channels,
+                    means_,
+                    scales_,
+                    nchw,
+                    ow * oh,
+                    nchw ? output + dy * ow : output + dy * ow * dst_channels);
+    }
+  }
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,174 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// ncnn license
+// Tencent is pleased to support the open source community by making ncnn
+// available.
+//
+// Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this
+// file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "lite/utils/cv/image_resize_rows.h"
+#include <limits.h>
+#include <math.h>
+#include <algorithm>
+#include "lite/utils/cv/image_avx2.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+void compute_resize_coef(int src_stride,
+                         int w_in,
+                         int h_in,
+                         int dst_stride,
+                         int w_out,
+                         int h_out,
+                         int channels,
+                         ResizeCoef* coef) {
+  const int resize_coef_bits = 11;
+  const int resize_coef_scale = 1 << resize_coef_bits;
+  double scale_x = static_cast<double>(src_stride) / dst_stride;
+  double scale_y = static_cast<double>(h_in) / h_out;
+  coef->src_stride = src_stride;
+  coef->w_out = w_out;
+  coef->h_out = h_out;
+  coef->channels = channels;
+  coef->xofs.resize(w_out);
+  coef->yofs.resize(h_out);
+  coef->ialpha.resize(w_out * 2);
+  coef->ibeta.resize(h_out * 2);
+#define SATURATE_CAST_SHORT(X)                                               \
+  (int16_t)::std::min(                                                       \
+      ::std::max(static_cast<int>(X + (X >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), \
+      SHRT_MAX);
+  for (int dx = 0; dx < w_out; dx++) {
+    float fx = static_cast<float>((dx + 0.5) * scale_x - 0.5);
+    int sx = floor(fx);
+    fx -= sx;
+    if (sx < 0) {
+      sx = 0;
+      fx = 0.f;
+    }
+    if (sx >= w_in - 1) {
+      sx = w_in - 2;
+      fx = 1.f;
+    }
+    coef->xofs[dx] = sx * channels;
+    float a0 = (1.f - fx) * resize_coef_scale;
+    float a1 = fx * resize_coef_scale;
+    coef->ialpha[dx * 2] = SATURATE_CAST_SHORT(a0);
+    coef->ialpha[dx * 2 + 1] = SATURATE_CAST_SHORT(a1);
+  }
+  for (int dy = 0; dy < h_out; dy++) {
+    float fy = static_cast<float>((dy + 0.5) * scale_y - 0.5);
+    int sy = floor(fy);
+    fy -= sy;
+    if (sy < 0) {
+      sy = 0;
+      fy = 0.f;
+    }
+    if (sy >= h_in - 1) {
+      sy = h_in - 2;
+      fy = 1.f;
+    }
+    coef->yofs[dy] = sy;
+    float b0 = (1.f - fy) * resize_coef_scale;
+    float b1 = fy * resize_coef_scale;
+    coef->ibeta[dy * 2] = SATURATE_CAST_SHORT(b0);
+    coef->ibeta[dy * 2 + 1] = SATURATE_CAST_SHORT(b1);
+  }
+#undef SATURATE_CAST_SHORT
+}
+
+ResizeRows::ResizeRows(const ResizeCoef* coef) : coef_(coef) {
+  // The AVX2 kernel stores 4 values per pixel, 4 more for the last one.
+  int row_size = coef->w_out * coef->channels + 4;
+  buf_.resize(row_size * 2);
+  rows0_ = buf_.data();
+  rows1_ = rows0_ + row_size;
+#ifdef LITE_CV_WITH_AVX2
+  avx2_ = HasAvx2();
+#endif
+}
+
+void ResizeRows::hresize(const uint8_t* src, int16_t* rows) {
+  const int channels = coef_->channels;
+  const int w_out = coef_->w_out;
+  const int* xofs = coef_->xofs.data();
+  const int16_t* ialpha = coef_->ialpha.data();
+  int dx = 0;
+#ifdef LITE_CV_WITH_AVX2
+  if (avx2_) {
+    dx = avx2::resize_hrow(
+        src, coef_->src_stride, xofs, ialpha, rows, w_out, channels);
+  }
+#endif
+  for (; dx < w_out; dx++) {
+    const uint8_t* S = src + xofs[dx];
+    int16_t a0 = ialpha[dx * 2];
+    int16_t a1 = ialpha[dx * 2 + 1];
+    for (int k = 0; k < channels; k++) {
+      rows[dx * channels + k] = (S[k] * a0 + S[channels + k] * a1) >> 4;
+    }
+  }
+}
+
+void ResizeRows::run(const uint8_t* src, int dy, uint8_t* dst) {
+  const int src_stride = coef_->src_stride;
+  int sy = coef_->yofs[dy];
+  if (sy == prev_sy_ + 1) {
+    // hresize one row
+    std::swap(rows0_, rows1_);
+    hresize(src + src_stride * (sy + 1), rows1_);
+  } else if (sy != prev_sy_) {
+    // hresize two rows
+    hresize(src + src_stride * sy, rows0_);
+    hresize(src + src_stride * (sy + 1), rows1_);
+  }
+  prev_sy_ = sy;
+  // vresize
+  int16_t b0 = coef_->ibeta[dy * 2];
+  int16_t b1 = coef_->ibeta[dy * 2 + 1];
+  int size = coef_->w_out * coef_->channels;
+  int i = 0;
+#ifdef LITE_CV_WITH_AVX2
+  if (avx2_) {
+    i = avx2::resize_vrow(rows0_, rows1_, b0, b1, dst, size);
+  }
+#endif
+  for (; i < size; i++) {
+    // D[x] = (rows0[x]*b0 + rows1[x]*b1) >> INTER_RESIZE_COEF_BITS;
+    dst[i] = (uint8_t)(((int16_t)((b0 * rows0_[i]) >> 16) +
+                        (int16_t)((b1 * rows1_[i]) >> 16) + 2) >>
+                       2);
+  }
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,74 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+// The coefficients of the bilinear resize of a plane, the offsets and the
+// fixed-point weights are the same as compute_xy of image_resize.cc.
+struct ResizeCoef {
+  int src_stride{0};
+  int w_out{0};
+  int h_out{0};
+  int channels{1};
+  // The byte offsets of the left pixels in a source row.
+  std::vector<int> xofs;
+  std::vector<int> yofs;
+  std::vector<int16_t> ialpha;
+  std::vector<int16_t> ibeta;
+};
+
+// Compute the coefficients to resize w_in x h_in pixels of `channels`
+// interleaved channels to w_out x h_out, the rows are of src_stride and
+// dst_stride bytes.
+void compute_resize_coef(int src_stride,
+                         int w_in,
+                         int h_in,
+                         int dst_stride,
+                         int w_out,
+                         int h_out,
+                         int channels,
+                         ResizeCoef* coef);
+
+// Resize a plane row by row, so that the resize can be fused with the passes
+// over the output rows. The horizontally resized source rows are cached, the
+// output rows of a plane are expected in the ascending order.
+class ResizeRows {
+ public:
+  explicit ResizeRows(const ResizeCoef* coef);
+
+  // Write the output row dy of the plane src into dst.
+  void run(const uint8_t* src, int dy, uint8_t* dst);
+
+ private:
+  void hresize(const uint8_t* src, int16_t* rows);
+
+  const ResizeCoef* coef_;
+  std::vector<int16_t> buf_;
+  int16_t* rows0_{nullptr};
+  int16_t* rows1_{nullptr};
+  int prev_sy_{-2};
+  bool avx2_{false};
+};
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
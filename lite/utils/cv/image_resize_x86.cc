@@ -0,0 +1,129 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// ncnn license
+// Tencent is pleased to support the open source community by making ncnn
+// available.
+//
+// Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this
+// file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#include <string.h>
+#include "lite/utils/cv/image_resize.h"
+#include "lite/utils/cv/image_resize_rows.h"
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+void ImageResize::choose(const uint8_t* src,
+                         uint8_t* dst,
+                         ImageFormat srcFormat,
+                         int srcw,
+                         int srch,
+                         int dstw,
+                         int dsth) {
+  resize(src, dst, srcFormat, srcw, srch, dstw, dsth);
+}
+
+namespace {
+
+// Resize a plane of w_in x h_in pixels of `channels` interleaved channels,
+// the rows are of src_stride and dst_stride bytes.
+void resize_plane(const uint8_t* src,
+                  int src_stride,
+                  int w_in,
+                  int h_in,
+                  uint8_t* dst,
+                  int dst_stride,
+                  int w_out,
+                  int h_out,
+                  int channels) {
+  ResizeCoef coef;
+  compute_resize_coef(
+      src_stride, w_in, h_in, dst_stride, w_out, h_out, channels, &coef);
+#pragma omp parallel
+  {
+    ResizeRows rows(&coef);
+#pragma omp for schedule(static)
+    for (int dy = 0; dy < h_out; dy++) {
+      rows.run(src, dy, dst + dst_stride * dy);
+    }
+  }
+}
+
+}  // namespace
+
+/*
+ * bilinear resize on x86, the results are identical to the ARM version. The
+ * output rows are split among the threads, and the horizontal and the vertical
+ * passes use the AVX2 kernels if the CPU supports them.
+ */
+void resize(const uint8_t* src,
+            uint8_t* dst,
+            ImageFormat srcFormat,
+            int srcw,
+            int srch,
+            int dstw,
+            int dsth) {
+  int size = srcw * srch;
+  if (srcw == dstw && srch == dsth) {
+    if (srcFormat == NV12 || srcFormat == NV21) {
+      size = srcw * (static_cast<int>(1.5 * srch));
+    } else if (srcFormat == BGR || srcFormat == RGB) {
+      size = 3 * srcw * srch;
+    } else if (srcFormat == BGRA || srcFormat == RGBA) {
+      size = 4 * srcw * srch;
+    }
+    memcpy(dst, src, sizeof(uint8_t) * size);
+    return;
+  }
+  if (srcFormat == GRAY) {
+    resize_plane(src, srcw, srcw, srch, dst, dstw, dstw, dsth, 1);
+  } else if (srcFormat == NV12 || srcFormat == NV21) {
+    // y
+    resize_plane(src, srcw, srcw, srch, dst, dstw, dstw, dsth, 1);
+    // uv
+    resize_plane(src + srcw * srch,
+                 srcw,
+                 srcw / 2,
+                 srch / 2,
+                 dst + dstw * dsth,
+                 dstw,
+                 dstw / 2,
+                 dsth / 2,
+                 2);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    resize_plane(src, srcw * 3, srcw, srch, dst, dstw * 3, dstw, dsth, 3);
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    resize_plane(src, srcw * 4, srcw, srch, dst, dstw * 4, dstw, dsth, 4);
+  }
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
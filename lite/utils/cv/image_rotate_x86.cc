@@ -0,0 +1,146 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include "lite/utils/cv/bgr_rotate.h"
+#include "lite/utils/cv/image_avx2.h"
+#include "lite/utils/cv/image_flip.h"
+#include "lite/utils/cv/image_rotate.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+void ImageRotate::choose(const uint8_t* src,
+                         uint8_t* dst,
+                         ImageFormat srcFormat,
+                         int srcw,
+                         int srch,
+                         float degree) {
+  if (degree != 90 && degree != 180 && degree != 270) {
+    printf("this degree: %f not support \n", degree);
+  }
+  if (srcFormat == GRAY) {
+    rotate_hwc1(src, dst, srcw, srch, degree);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    bgr_rotate_hwc(src, dst, srcw, srch, static_cast<int>(degree));
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    rotate_hwc4(src, dst, srcw, srch, degree);
+  } else {
+    printf("this srcFormat: %d does not support! \n", srcFormat);
+    return;
+  }
+}
+
+namespace {
+
+const int kTile = 8;
+
+// Rotate clockwise by 90 or 270 degrees, the image is transposed by the tiles
+// of 8 x 8 pixels. The tiles are read from the bottom up for 90 and written
+// from the bottom up for 270, so that the transposition does the rotation.
+void rotate_transpose(const uint8_t* src,
+                      uint8_t* dst,
+                      int w_in,
+                      int h_in,
+                      int channels,
+                      int angle) {
+  const ptrdiff_t src_stride = w_in * channels;
+  const ptrdiff_t dst_stride = h_in * channels;
+  const bool avx2 = HasAvx2();
+#pragma omp parallel for
+  for (int r0 = 0; r0 < h_in; r0 += kTile) {
+    for (int c0 = 0; c0 < w_in; c0 += kTile) {
+      int rows = std::min(kTile, h_in - r0);
+      int cols = std::min(kTile, w_in - c0);
+      if (avx2 && rows == kTile && cols == kTile) {
+        bool done = false;
+        if (angle == 90) {
+          done = avx2::transpose_tile(
+              src + (r0 + kTile - 1) * src_stride + c0 * channels,
+              -src_stride,
+              dst + c0 * dst_stride + (h_in - kTile - r0) * channels,
+              dst_stride,
+              channels);
+        } else {
+          done = avx2::transpose_tile(
+              src + r0 * src_stride + c0 * channels,
+              src_stride,
+              dst + (w_in - 1 - c0) * dst_stride + r0 * channels,
+              -dst_stride,
+              channels);
+        }
+        if (done) continue;
+      }
+      for (int i = r0; i < r0 + rows; i++) {
+        const uint8_t* in = src + i * src_stride;
+        for (int j = c0; j < c0 + cols; j++) {
+          uint8_t* out = angle == 90
+                             ? dst + j * dst_stride + (h_in - 1 - i) * channels
+                             : dst + (w_in - 1 - j) * dst_stride + i * channels;
+          for (int k = 0; k < channels; k++) {
+            out[k] = in[j * channels + k];
+          }
+        }
+      }
+    }
+  }
+}
+
+void rotate_hwc(const uint8_t* src,
+                uint8_t* dst,
+                int srcw,
+                int srch,
+                int channels,
+                int angle) {
+  if (angle == 90 || angle == 270) {
+    rotate_transpose(src, dst, srcw, srch, channels, angle);
+  } else if (angle == 180) {
+    if (channels == 1) {
+      flip_hwc1(src, dst, srcw, srch, XY);
+    } else if (channels == 3) {
+      flip_hwc3(src, dst, srcw, srch, XY);
+    } else {
+      flip_hwc4(src, dst, srcw, srch, XY);
+    }
+  }
+}
+
+}  // namespace
+
+void rotate_hwc1(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  rotate_hwc(src, dst, srcw, srch, 1, static_cast<int>(degree));
+}
+
+void rotate_hwc3(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  rotate_hwc(src, dst, srcw, srch, 3, static_cast<int>(degree));
+}
+
+void rotate_hwc4(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  rotate_hwc(src, dst, srcw, srch, 4, static_cast<int>(degree));
+}
+
+void bgr_rotate_hwc(
+    const uint8_t* src, uint8_t* dst, int w_in, int h_in, int angle) {
+  rotate_hwc(src, dst, w_in, h_in, 3, angle);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
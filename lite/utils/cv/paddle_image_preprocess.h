@@ -268,6 +268,62 @@ class ImagePreprocess {
   ImageFormat dstFormat_;
   TransParam transParam_;
 };
+
+struct ResizeCoef;
+
+/*
+ * ImagePipeline fuses image_resize, image_convert and image_to_tensor into one
+ * pass over the rows of the tensor. Each thread resizes, converts and
+ * normalizes a band of rows through the row buffers, so that none of the
+ * intermediate images is stored, and the tensor is written in place, egs: the
+ * input tensor of the predictor. The interpolation coefficients are computed
+ * once by the constructor and reused by the runs.
+ */
+class ImagePipeline {
+ public:
+  /*
+  * init
+  * param srcFormat: input image format, support GRAY, NV12(NV21), BGR(RGB) and
+  * BGRA(RGBA)
+  * param dstFormat: color of the tensor, support GRAY, BGR(RGB) and
+  * BGRA(RGBA), the alpha channel is dropped
+  * param param: input and output image size, iw, ih, ow and oh
+  * param layout: output tensor layout，support NHWC and NCHW
+  * param means: means of the channels of dstFormat
+  * param scales: scales of the channels of dstFormat
+  */
+  ImagePipeline(ImageFormat srcFormat,
+                ImageFormat dstFormat,
+                TransParam param,
+                LayoutType layout,
+                const float* means,
+                const float* scales);
+  ~ImagePipeline();
+
+  /*
+  * resize the input image to ow x oh, convert it to dstFormat, and write
+  * (x - mean) * scale into dstTensor, which is resized to {1, C, oh, ow} or
+  * {1, oh, ow, C}
+  * param src: input image data
+  * param dstTensor: output tensor
+  */
+  void run(const uint8_t* src, Tensor* dstTensor);
+
+ private:
+  ImageFormat srcFormat_;
+  ImageFormat dstFormat_;
+  TransParam transParam_;
+  LayoutType layout_;
+  float means_[3];
+  float scales_[3];
+  // The coefficients of the image, or the Y and the UV planes of NV12(NV21),
+  // null if the size is unchanged.
+  ResizeCoef* coef_{nullptr};
+  ResizeCoef* uv_coef_{nullptr};
+
+  ImagePipeline(const ImagePipeline&) = delete;
+  ImagePipeline& operator=(const ImagePipeline&) = delete;
+};
 }  // namespace cv
 }  // namespace utils
 }  // namespace lite
@@ -13,12 +13,15 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 
 namespace paddle {
 namespace lite {
 
-std::string MD5(std::string message) {
+inline std::string MD5(std::string message) {
   const uint32_t shiftAmounts[] = {
       7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
       5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20,